@@ -88,6 +88,8 @@ public class AIRuntime : ModuleRules
             System.Console.WriteLine(">> QAIRT_APL.xml path: " + BuildPath);
             AdditionalPropertiesForReceipt.Add("AndroidPlugin", BuildPath);
         }
+        // SNPEChaining sources are shared with the host CMake build (SNPEChaining/host)
+        PublicDefinitions.Add("SNPE_CHAINING_HOST=0");
         bEnableExceptions = true;
     }
 }
@@ -5,6 +5,7 @@
 // Output: output_0 (1x56x1344) - detections with bbox + keypoints
 
 #include "AIInferenceActor.h"
+#include "AIInferenceWorker.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "HAL/PlatformFilemanager.h"
@@ -23,10 +24,14 @@
 #include "inc/hpp/ModelSession.hpp"
 #include "inc/hpp/GraphRunner.hpp"
 #include "inc/hpp/TensorWorkspace.hpp"
-#include "inc/hpp/MMapAsset.hpp"
+#include "inc/hpp/DlcCache.hpp"
 #include "inc/hpp/ParseConfig.hpp"
-#include "inc/hpp/MMapFile.h"
 #include "inc/hpp/newInferenceHelper.hpp"
+#include "inc/hpp/Preprocess.hpp"
+#include "inc/hpp/OutputDecoder.hpp"
+#include "inc/hpp/TensorView.hpp"
+#include "inc/hpp/LatencyHistogram.hpp"
+#include "inc/hpp/Trace.hpp"
 
 #define LOG_TAG_AI "AI_INFERENCE"
 #define LOGE_AI(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG_AI, __VA_ARGS__)
@@ -39,6 +44,41 @@
 #define LOGW_AI(...) 
 #endif
 
+#if PLATFORM_ANDROID
+// Per-stage latency of RunPipeline/DeliverResult. Recorded from the inference
+// thread and the game thread; the histograms are lock-free.
+struct FAIStageLatency
+{
+    LatencyHistogram Preprocess;
+    LatencyHistogram Run;         // whole graph, see GraphRunner::nodeLatency() for nodes
+    LatencyHistogram Postprocess;
+    LatencyHistogram Publish;     // Blueprint events and result hand-off
+    LatencyHistogram Frame;       // preprocess through postprocess
+
+    void Reset()
+    {
+        Preprocess.reset();
+        Run.reset();
+        Postprocess.reset();
+        Publish.reset();
+        Frame.reset();
+    }
+};
+
+static FAIStageLatencyStats ToBlueprintStats(const FString& Stage, const LatencyStats& S)
+{
+    FAIStageLatencyStats Out;
+    Out.Stage = Stage;
+    Out.Count = static_cast<int32>(FMath::Min<uint64>(S.count, MAX_int32));
+    Out.MeanMs = static_cast<float>(S.meanNs * 1e-6);
+    Out.P50Ms = static_cast<float>(S.p50Ns * 1e-6);
+    Out.P90Ms = static_cast<float>(S.p90Ns * 1e-6);
+    Out.P99Ms = static_cast<float>(S.p99Ns * 1e-6);
+    Out.MaxMs = static_cast<float>(S.maxNs * 1e-6);
+    return Out;
+}
+#endif
+
 AAIInferenceActor::AAIInferenceActor()
 {
     PrimaryActorTick.bCanEverTick = true;
@@ -48,6 +88,12 @@ AAIInferenceActor::AAIInferenceActor()
     DefaultModelName = TEXT("yolo11n-pose.dlc");
     bEnableLogging = true;
     bUseGPUAcceleration = false;
+    bPlanWorkspaceMemory = false;
+    WorkspaceArenaMB = 0;
+    WorkspaceAlignment = 64;
+    MaxParallelNodes = 1;
+    bPrefaultWorkspaceArena = false;
+    bPrefaultModelMappings = true;
     SaveFrames = false;
 
     // Internal state
@@ -58,7 +104,26 @@ AAIInferenceActor::AAIInferenceActor()
 #if PLATFORM_ANDROID
     WorkspacePtr = nullptr;
     GraphRunnerPtr = nullptr;
+    PreprocessorPtr = nullptr;
+    OutputDecoderPtr = nullptr;
+    OutputInfoPtr = nullptr;
+    InputInfoPtr = nullptr;
+    OutputScratchPtr = nullptr;
+    StageLatencyPtr = nullptr;
 #endif
+    InputTensorId = MAX_uint32;
+    OutputTensorId = MAX_uint32;
+
+    bAsyncInference = false;
+    InferenceWorker = nullptr;
+
+    bDetectMultiplePeople = false;
+    MaxPeople = 6;
+    DetectionThreshold = 0.5f;
+    NmsIouThreshold = 0.45f;
+
+    bLetterboxInput = true;
+    DisplayAspectRatio = 2246.0f / 1081.0f;
 }
 
 void AAIInferenceActor::BeginPlay()
@@ -72,16 +137,41 @@ void AAIInferenceActor::BeginPlay()
     }
 }
 
+void AAIInferenceActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    ShutdownInference();
+    Super::EndPlay(EndPlayReason);
+}
+
 void AAIInferenceActor::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
 
+    // Async mode: pick up the newest finished frame (never waits on the worker)
+    FAIInferenceFrameOutput Out;
+    if (InferenceWorker && InferenceWorker->ConsumeResult(Out))
+    {
+        if (Out.Error.IsEmpty())
+        {
+            LatestResult = Out.Result;
+        }
+        DeliverResult(Out);
+    }
+
     // Optional: Add periodic status logging
     if (bEnableLogging && InferenceCounter > 0 && InferenceCounter % 100 == 0)
     {
         float AvgTime = TotalInferenceTime / InferenceCounter;
         UE_LOG(LogTemp, Log, TEXT("AI Inference Stats: %d inferences, avg %.2f ms"),
             InferenceCounter, AvgTime);
+#if PLATFORM_ANDROID
+        if (StageLatencyPtr)
+        {
+            const LatencyStats Frame = static_cast<FAIStageLatency*>(StageLatencyPtr)->Frame.stats();
+            LOGI_AI("Frame latency: p50 %.2f ms, p99 %.2f ms, max %.2f ms",
+                Frame.p50Ns * 1e-6, Frame.p99Ns * 1e-6, Frame.maxNs * 1e-6);
+        }
+#endif
     }
 }
 
@@ -109,6 +199,8 @@ bool AAIInferenceActor::InitializeInference(const FString& ModelName)
 
 #if PLATFORM_ANDROID
     LOGI_AI("Initializing QAIRT/SNPE runtime...");
+    traceSetThreadName("GameThread");
+    SNPE_TRACE_SCOPE("actor", "InitializeInference");
 
     // Set ModelDirectory to where the model is installed
     ModelDirectory = ModelsDir;
@@ -127,12 +219,36 @@ bool AAIInferenceActor::InitializeInference(const FString& ModelName)
     AAssetManager* AMgr = AAssetManager_fromJava(Env, AssetMgr);
 
     // Initialize workspace and graph runner
+    if (!StageLatencyPtr)
+    {
+        StageLatencyPtr = new FAIStageLatency();
+    }
     WorkspacePtr = new TensorWorkspace();
+    ImagePreprocessor::Params PreParams;
+    PreParams.fit = bLetterboxInput ? ImagePreprocessor::Fit::LETTERBOX : ImagePreprocessor::Fit::STRETCH;
+    PreprocessorPtr = new ImagePreprocessor(PreParams);
+    DisplayMapping = FAIDisplayMapping(); // transform changes with the fit mode
     GraphRunnerPtr = new GraphRunner(*static_cast<TensorWorkspace*>(WorkspacePtr));
 
     TensorWorkspace* WS = static_cast<TensorWorkspace*>(WorkspacePtr);
     GraphRunner* GR = static_cast<GraphRunner*>(GraphRunnerPtr);
 
+    // Workspace memory layout: alignment for every tensor, optional single arena
+    TensorWorkspace::ArenaOptions ArenaOpt;
+    ArenaOpt.capacity = static_cast<size_t>(FMath::Max(WorkspaceArenaMB, 0)) << 20;
+    ArenaOpt.alignment = static_cast<size_t>(FMath::Max(WorkspaceAlignment, 1));
+    ArenaOpt.advice = bPrefaultWorkspaceArena ? TensorWorkspace::ArenaAdvice::WILLNEED
+                                              : TensorWorkspace::ArenaAdvice::NONE;
+    std::string ArenaError;
+    if (!WS->reserveArena(ArenaOpt, &ArenaError))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Workspace arena not reserved: %s"), UTF8_TO_TCHAR(ArenaError.c_str()));
+        LOGW_AI("Workspace arena not reserved: %s", ArenaError.c_str());
+    }
+
+    // Models are mapped through the process-wide DlcCache (shared by every actor)
+    DlcCache::instance().setWillNeed(bPrefaultModelMappings);
+
     // Build inference chain
     std::string ConfigFilename = "model-config.json";
     char RuntimePref = bUseGPUAcceleration ? 'G' : 'C'; // 'C' = CPU, 'G' = GPU, 'D' = DSP
@@ -141,16 +257,14 @@ bool AAIInferenceActor::InitializeInference(const FString& ModelName)
     // Convert FString to std::string for ModelDirectory
     std::string ModelDirStdString = TCHAR_TO_UTF8(*ModelDirectory);
 
-    // YOLO11n-pose expects 256x256 input
+    // YOLO11n-pose expects 256x256 input. The chain build allocates it at the size
+    // of the model's encoding (float32, fp16 or 8/16-bit quantized, see "io_types")
     const char* wsName = "images";
-    const int32 ModelInputSize = 256;
-    const int32 bytes_needed = ModelInputSize * ModelInputSize * 3 * sizeof(float);
-    WS->allocate(wsName, bytes_needed);
-
-    UE_LOG(LogTemp, Log, TEXT("Allocated %d bytes for %dx%d input tensor"), bytes_needed, ModelInputSize, ModelInputSize);
-    LOGI_AI("Allocated %d bytes for %dx%d input tensor", bytes_needed, ModelInputSize, ModelInputSize);
 
-    std::string BuildLog = buildArbitraryChain(AMgr, ModelDirStdString, ConfigFilename, *WS, *GR, RuntimePref, ResetSessions);
+    PipelineCfg ChainCfg;
+    std::string BuildLog = buildArbitraryChain(AMgr, ModelDirStdString, ConfigFilename, *WS, *GR, RuntimePref, ResetSessions,
+                                               bPlanWorkspaceMemory, &ChainCfg);
+    GR->setParallelism(static_cast<size_t>(FMath::Max(MaxParallelNodes, 1)));
 
     UE_LOG(LogTemp, Log, TEXT("QAIRT Build Log: %s"), UTF8_TO_TCHAR(BuildLog.c_str()));
     LOGI_AI("QAIRT Build Result: %s", BuildLog.c_str());
@@ -164,6 +278,7 @@ bool AAIInferenceActor::InitializeInference(const FString& ModelName)
         // Cleanup
         Env->DeleteLocalRef(AssetMgr);
         Env->DeleteLocalRef(ActivityClass);
+        ReleaseInferenceResources();
 
         OnInferenceFailed(TEXT("QAIRT initialization failed"));
         return false;
@@ -172,7 +287,47 @@ bool AAIInferenceActor::InitializeInference(const FString& ModelName)
     Env->DeleteLocalRef(AssetMgr);
     Env->DeleteLocalRef(ActivityClass);
 
+    // Resolve tensor names once; RunInference only touches ids
+    InputTensorId = WS->find(wsName);
+    // Output decoder chosen per model in model-config.json ("decoder"); it also names
+    // the decoded tensor, whose shape comes from ModelSession::outputs()
+    TensorInfo OutInfo;
+    std::string DecoderError;
+    std::unique_ptr<IOutputDecoder> Decoder = createChainDecoder(ChainCfg, *GR, *WS, &OutputTensorId, &OutInfo, &DecoderError);
+    if (!Decoder)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Output decoder setup failed: %s"), UTF8_TO_TCHAR(DecoderError.c_str()));
+        LOGE_AI("Output decoder setup failed: %s", DecoderError.c_str());
+        ReleaseInferenceResources();
+        OnInferenceFailed(TEXT("Output decoder setup failed"));
+        return false;
+    }
+    const TensorInfo* InInfo = GR->tensorInfo(InputTensorId);
+    if (!InInfo)
+    {
+        UE_LOG(LogTemp, Error, TEXT("No model reads the input tensor '%s'"), UTF8_TO_TCHAR(wsName));
+        LOGE_AI("No model reads the input tensor '%s'", wsName);
+        ReleaseInferenceResources();
+        OnInferenceFailed(TEXT("Input tensor not bound"));
+        return false;
+    }
+    OutputDecoderPtr = Decoder.release();
+    OutputInfoPtr = new TensorInfo(OutInfo);
+    InputInfoPtr = new TensorInfo(*InInfo);
+    // Decoders read float32: other output encodings are converted once per frame
+    OutputScratchPtr = OutInfo.dataType == TensorDataType::FLOAT32 ? nullptr : new std::vector<float>();
+    LOGI_AI("Input '%s' is %s, output is %s", wsName, dataTypeName(InInfo->dataType), dataTypeName(OutInfo.dataType));
+    std::string OutDims;
+    for (size_t d : OutInfo.dims) OutDims += (OutDims.empty() ? "" : "x") + std::to_string(d);
+    LOGI_AI("Output tensor '%s' (%s) -> workspace '%s', decoder '%s'",
+        OutInfo.name.c_str(), OutDims.c_str(), WS->nameOf(OutputTensorId).c_str(),
+        static_cast<IOutputDecoder*>(OutputDecoderPtr)->type());
+
     bIsInitialized = true;
+    if (bAsyncInference)
+    {
+        StartInferenceWorker();
+    }
     UE_LOG(LogTemp, Log, TEXT("AI Inference initialized successfully!"));
     LOGI_AI("AI Inference initialized successfully!");
     return true;
@@ -205,80 +360,178 @@ FAIInferenceResult AAIInferenceActor::ProcessCameraFrame(const TArray<uint8>& RG
         return Result;
     }
 
-    double StartTime = FPlatformTime::Seconds();
-
     if (bEnableLogging)
     {
         UE_LOG(LogTemp, Log, TEXT("Processing frame: %dx%d (%d bytes)"), Width, Height, RGBData.Num());
     }
 
+    // Async: hand the frame over and return right away; Tick delivers the result
+    if (bAsyncInference)
+    {
+        if (!InferenceWorker)
+        {
+            StartInferenceWorker();
+        }
+        InferenceWorker->PostFrame(RGBData, Width, Height, MakeFrameParams());
+        return LatestResult;
+    }
+    if (InferenceWorker)
+    {
+        // Switched back to sync: the worker must not touch the graph any more
+        StopInferenceWorker();
+    }
+
+    FAIInferenceFrameOutput Out;
+    RunPipeline(RGBData, Width, Height, MakeFrameParams(), Out);
+    DeliverResult(Out);
+    return Out.Result;
+}
+
+FAIFrameParams AAIInferenceActor::MakeFrameParams() const
+{
+    FAIFrameParams Params;
+    Params.DetectionThreshold = DetectionThreshold;
+    Params.NmsIouThreshold = NmsIouThreshold;
+    Params.MaxPeople = MaxPeople;
+    Params.bDetectMultiplePeople = bDetectMultiplePeople;
+    Params.DisplayAspectRatio = DisplayAspectRatio;
+    Params.bEnableLogging = bEnableLogging;
+    Params.bSaveFrames = SaveFrames;
+    return Params;
+}
+
+void AAIInferenceActor::RunPipeline(const TArray<uint8>& RGBData, int32 Width, int32 Height, const FAIFrameParams& Params, FAIInferenceFrameOutput& Out)
+{
 #if PLATFORM_ANDROID
+    double StartTime = FPlatformTime::Seconds();
     LOGI_AI("Processing camera frame: %dx%d", Width, Height);
+    FAIStageLatency* Latency = static_cast<FAIStageLatency*>(StageLatencyPtr);
+    const auto FrameStart = LatencyHistogram::Clock::now();
+    SNPE_TRACE_SCOPE("actor", "frame");
 
-    // Step 1: Preprocess image data
-    TArray<float> InputData = PreprocessImageData(RGBData, Width, Height);
-    if (InputData.Num() == 0)
+    // Step 1: Preprocess image data straight into the workspace input tensor
+    auto StageStart = FrameStart;
+    if (!PreprocessImageData(RGBData, Width, Height))
     {
-        UE_LOG(LogTemp, Error, TEXT("Preprocessing failed"));
-        OnInferenceFailed(TEXT("Preprocessing failed"));
-        return Result;
+        Out.Error = TEXT("Preprocessing failed");
+        return;
     }
+    if (Latency) Latency->Preprocess.recordSince(StageStart);
 
     // Step 2: Run inference
-    TArray<float> OutputData;
-    if (!RunInference(InputData, OutputData))
+    TensorView<float> Output;
+    StageStart = LatencyHistogram::Clock::now();
+    if (!RunInference(Output, Params.bEnableLogging))
     {
-        UE_LOG(LogTemp, Error, TEXT("Inference execution failed"));
-        OnInferenceFailed(TEXT("Inference execution failed"));
-        return Result;
+        Out.Error = TEXT("Inference execution failed");
+        return;
     }
+    if (Latency) Latency->Run.recordSince(StageStart);
 
     // Step 3: Postprocess output - find best detection
-    Result = PostprocessOutput(OutputData, Width, Height);
+    StageStart = LatencyHistogram::Clock::now();
+    Out.Result = PostprocessOutput(Output, Width, Height, Params, Out.People);
+    Out.Display = DisplayMapping;
+    if (Latency)
+    {
+        Latency->Postprocess.recordSince(StageStart);
+        Latency->Frame.recordSince(FrameStart);
+    }
 
     // Debug: Save synchronized preprocess and keypoints images every N frames
     // Save RAW keypoints (before aspect ratio corrections) for debugging
     static int32 DebugFrameCounter = 0;
     const int32 SaveEveryNFrames = 100;  // Save every 100 frames
-    if (SaveFrames && DebugFrameCounter % SaveEveryNFrames == 0)
+    if (Params.bSaveFrames && DebugFrameCounter % SaveEveryNFrames == 0)
     {
         int32 SaveIndex = DebugFrameCounter / SaveEveryNFrames;
+        const TensorWorkspace* WS = static_cast<const TensorWorkspace*>(WorkspacePtr);
+        TArray<float> InputData;
+        InputData.SetNumUninitialized(3 * 256 * 256);
+        tensorToFloat(WS->data(InputTensorId), *static_cast<const TensorInfo*>(InputInfoPtr), InputData.GetData(), InputData.Num());
         SaveDebugImage(InputData, 256, 256,
             FString::Printf(TEXT("preprocess_%d.ppm"), SaveIndex));
 
         // Create a raw result without aspect ratio corrections for debug visualization
-        FAIInferenceResult RawResult = PostprocessOutputRaw(OutputData, Width, Height);
+        FAIInferenceResult RawResult = PostprocessOutputRaw(Output, Width, Height);
         SaveKeypointsDebugImage(RawResult, 256, 256,
             FString::Printf(TEXT("keypoints_%d.ppm"), SaveIndex));
     }
     DebugFrameCounter++;
 
-    // Update performance metrics
-    double ProcessingTime = (FPlatformTime::Seconds() - StartTime) * 1000.0; // Convert to ms
-    Result.ProcessingTimeMS = static_cast<int32>(ProcessingTime);
+    Out.ProcessingMs = (FPlatformTime::Seconds() - StartTime) * 1000.0; // Convert to ms
+    Out.Result.ProcessingTimeMS = static_cast<int32>(Out.ProcessingMs);
+    Out.People.ProcessingTimeMS = Out.Result.ProcessingTimeMS;
+#else
+    Out.Error = TEXT("Platform not supported");
+#endif
+}
+
+void AAIInferenceActor::DeliverResult(const FAIInferenceFrameOutput& Out)
+{
+    if (!Out.Error.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s"), *Out.Error);
+        OnInferenceFailed(Out.Error);
+        return;
+    }
+
+#if PLATFORM_ANDROID
+    ScopedLatency PublishLatency(StageLatencyPtr ? &static_cast<FAIStageLatency*>(StageLatencyPtr)->Publish : nullptr);
+    SNPE_TRACE_SCOPE("actor", "publish");
+#endif
 
+    // Update performance metrics
     InferenceCounter++;
-    TotalInferenceTime += ProcessingTime;
+    TotalInferenceTime += Out.ProcessingMs;
 
-    if (bEnableLogging && Result.bSuccess)
+    if (bEnableLogging && Out.Result.bSuccess)
     {
         UE_LOG(LogTemp, Log, TEXT("Inference completed: %.2f ms, Confidence: %.2f"),
-            ProcessingTime, Result.Confidence);
+            Out.ProcessingMs, Out.Result.Confidence);
         LOGI_AI("Inference completed: %.2f ms, Confidence: %.2f, %d keypoints",
-            ProcessingTime, Result.Confidence, Result.JointPositions.Num());
+            Out.ProcessingMs, Out.Result.Confidence, Out.Result.JointPositions.Num());
     }
 
     // Notify Blueprint
-    if (Result.bSuccess)
+    if (Out.Result.bSuccess)
+    {
+        OnInferenceCompleted(Out.Result);
+    }
+    if (bDetectMultiplePeople)
     {
-        OnInferenceCompleted(Result);
+        LatestPeople = Out.People;
+        if (Out.People.bSuccess)
+        {
+            OnMultiPoseCompleted(Out.People);
+        }
     }
+}
 
-#else
-    OnInferenceFailed(TEXT("Platform not supported"));
-#endif
+void AAIInferenceActor::StartInferenceWorker()
+{
+    if (InferenceWorker)
+    {
+        return;
+    }
+    InferenceWorker = new FAIInferenceWorker(
+        [this](const TArray<uint8>& RGBData, int32 Width, int32 Height, const FAIFrameParams& Params, FAIInferenceFrameOutput& Out)
+        {
+            RunPipeline(RGBData, Width, Height, Params, Out);
+        });
+    UE_LOG(LogTemp, Log, TEXT("AI inference worker started"));
+}
 
-    return Result;
+void AAIInferenceActor::StopInferenceWorker()
+{
+    if (!InferenceWorker)
+    {
+        return;
+    }
+    const int64 Dropped = InferenceWorker->GetDroppedFrames();
+    delete InferenceWorker; // joins the thread
+    InferenceWorker = nullptr;
+    UE_LOG(LogTemp, Log, TEXT("AI inference worker stopped (%lld frames replaced before inference)"), Dropped);
 }
 
 bool AAIInferenceActor::EnsureModelInstalled(const FString& ModelName)
@@ -311,35 +564,62 @@ bool AAIInferenceActor::EnsureModelInstalled(const FString& ModelName)
     jobject AssetMgrObj = Env->CallObjectMethod(Activity, GetAssets);
 
     AAssetManager* AMgr = AAssetManager_fromJava(Env, AssetMgrObj);
-    AAsset* Asset = AAssetManager_open(AMgr, TCHAR_TO_UTF8(*ModelName), AASSET_MODE_STREAMING);
-
-    if (!Asset)
+    const std::string AssetName = TCHAR_TO_UTF8(*ModelName);
+
+    // Written under a temporary name and renamed, so an interrupted copy is never
+    // taken for an installed model
+    const FString TmpPath = DlcPath + TEXT(".tmp");
+    bool bFound = true;
+    bool bSaved = false;
+    int64 Length = 0;
+    if (IFileHandle* Out = PlatformFile.OpenWrite(*TmpPath))
     {
-        UE_LOG(LogTemp, Error, TEXT("Model not found in APK assets: %s"), *ModelName);
-        LOGE_AI("Model not found in APK assets: %s", TCHAR_TO_UTF8(*ModelName));
-
-        Env->DeleteLocalRef(AssetMgrObj);
-        Env->DeleteLocalRef(ActivityClass);
-        return false;
+        // An uncompressed asset is written straight from its (shared) mapping; a
+        // compressed one is streamed in chunks, never held whole in memory
+        std::string MapError;
+        if (std::shared_ptr<DlcCache::Mapping> Dlc = DlcCache::instance().mapAsset(AMgr, AssetName, &MapError))
+        {
+            Length = static_cast<int64>(Dlc->size);
+            bSaved = Out->Write(Dlc->data, Length);
+        }
+        else if (AAsset* Asset = AAssetManager_open(AMgr, AssetName.c_str(), AASSET_MODE_STREAMING))
+        {
+            TArray<uint8> Chunk;
+            Chunk.SetNumUninitialized(1 << 20);
+            int Read = 0;
+            bSaved = true;
+            while (bSaved && (Read = AAsset_read(Asset, Chunk.GetData(), Chunk.Num())) > 0)
+            {
+                bSaved = Out->Write(Chunk.GetData(), Read);
+                Length += Read;
+            }
+            bSaved = bSaved && Read == 0;
+            AAsset_close(Asset);
+        }
+        else
+        {
+            bFound = false;
+        }
+        delete Out;
+    }
+    bSaved = bSaved && PlatformFile.MoveFile(*DlcPath, *TmpPath);
+    if (!bSaved)
+    {
+        PlatformFile.DeleteFile(*TmpPath);
     }
-
-    // Read asset into memory
-    const off_t Length = AAsset_getLength(Asset);
-    TArray<uint8> Bytes;
-    Bytes.SetNumUninitialized(Length);
-    AAsset_read(Asset, Bytes.GetData(), Length);
-    AAsset_close(Asset);
-
-    // Save to disk
-    bool bSaved = FFileHelper::SaveArrayToFile(Bytes, *DlcPath);
 
     Env->DeleteLocalRef(AssetMgrObj);
     Env->DeleteLocalRef(ActivityClass);
 
-    if (bSaved)
+    if (!bFound)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Model not found in APK assets: %s"), *ModelName);
+        LOGE_AI("Model not found in APK assets: %s", AssetName.c_str());
+    }
+    else if (bSaved)
     {
-        UE_LOG(LogTemp, Log, TEXT("Model installed successfully: %s (%ld bytes)"), *DlcPath, (long)Length);
-        LOGI_AI("Model installed successfully: %ld bytes", (long)Length);
+        UE_LOG(LogTemp, Log, TEXT("Model installed successfully: %s (%lld bytes)"), *DlcPath, (long long)Length);
+        LOGI_AI("Model installed successfully: %lld bytes", (long long)Length);
     }
     else
     {
@@ -354,63 +634,124 @@ bool AAIInferenceActor::EnsureModelInstalled(const FString& ModelName)
 #endif
 }
 
-bool AAIInferenceActor::RunInference(const TArray<float>& InputData, TArray<float>& OutputData)
+TArray<FAIStageLatencyStats> AAIInferenceActor::GetLatencyStats() const
 {
+    TArray<FAIStageLatencyStats> Stats;
 #if PLATFORM_ANDROID
-    if (!WorkspacePtr || !GraphRunnerPtr)
+    if (const FAIStageLatency* Latency = static_cast<const FAIStageLatency*>(StageLatencyPtr))
     {
-        LOGE_AI("Workspace or GraphRunner is null");
-        return false;
+        Stats.Add(ToBlueprintStats(TEXT("preprocess"), Latency->Preprocess.stats()));
+        Stats.Add(ToBlueprintStats(TEXT("run"), Latency->Run.stats()));
+        Stats.Add(ToBlueprintStats(TEXT("postprocess"), Latency->Postprocess.stats()));
+        Stats.Add(ToBlueprintStats(TEXT("publish"), Latency->Publish.stats()));
+        Stats.Add(ToBlueprintStats(TEXT("frame"), Latency->Frame.stats()));
     }
+    if (const GraphRunner* GR = static_cast<const GraphRunner*>(GraphRunnerPtr))
+    {
+        for (const GraphRunner::NodeLatency& Node : GR->nodeLatency())
+        {
+            const FString Name = UTF8_TO_TCHAR(Node.name.c_str());
+            Stats.Add(ToBlueprintStats(TEXT("bind/") + Name, Node.bind));
+            Stats.Add(ToBlueprintStats(TEXT("execute/") + Name, Node.execute));
+        }
+    }
+#endif
+    return Stats;
+}
 
-    TensorWorkspace* WS = static_cast<TensorWorkspace*>(WorkspacePtr);
-    GraphRunner* GR = static_cast<GraphRunner*>(GraphRunnerPtr);
+void AAIInferenceActor::SetTraceEnabled(bool bEnabled)
+{
+#if PLATFORM_ANDROID
+    if (bEnabled)
+    {
+        traceStart();
+    }
+    else
+    {
+        traceStop();
+    }
+#endif
+}
 
-    // Copy input data to workspace
-    const char* InputTensorName = "images";
-    size_t BytesNeeded = InputData.Num() * sizeof(float);
+bool AAIInferenceActor::WriteTrace(const FString& FileName)
+{
+#if PLATFORM_ANDROID
+    FString FilePath = FPaths::ProjectSavedDir() / TEXT("Debug") / FileName;
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
 
-    if (WS->data(InputTensorName) == nullptr)
+    const std::string Json = traceChromeJson();
+    const bool bSaved = FFileHelper::SaveArrayToFile(
+        TArrayView<const uint8>(reinterpret_cast<const uint8*>(Json.data()), static_cast<int32>(Json.size())), *FilePath);
+    if (bSaved)
     {
-        LOGE_AI("Input tensor '%s' not found in workspace", InputTensorName);
+        UE_LOG(LogTemp, Log, TEXT("Trace written to %s (%d bytes)"), *FilePath, static_cast<int32>(Json.size()));
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to write trace to %s"), *FilePath);
+    }
+    return bSaved;
+#else
+    return false;
+#endif
+}
+
+void AAIInferenceActor::ResetLatencyStats()
+{
+#if PLATFORM_ANDROID
+    if (StageLatencyPtr)
+    {
+        static_cast<FAIStageLatency*>(StageLatencyPtr)->Reset();
+    }
+    if (GraphRunnerPtr)
+    {
+        static_cast<GraphRunner*>(GraphRunnerPtr)->resetLatency();
+    }
+#endif
+}
+
+bool AAIInferenceActor::RunInference(TensorView<float>& Output, bool bLogSummary)
+{
+#if PLATFORM_ANDROID
+    SNPE_TRACE_SCOPE("actor", "run");
+    if (!WorkspacePtr || !GraphRunnerPtr || !OutputInfoPtr || !OutputDecoderPtr)
+    {
+        LOGE_AI("Workspace, GraphRunner or output info is null");
         return false;
     }
 
-    std::memcpy(WS->data(InputTensorName), InputData.GetData(), BytesNeeded);
-    LOGI_AI("Copied %zu bytes to input tensor", BytesNeeded);
+    TensorWorkspace* WS = static_cast<TensorWorkspace*>(WorkspacePtr);
+    GraphRunner* GR = static_cast<GraphRunner*>(GraphRunnerPtr);
 
+    // Input tensor was filled in place by PreprocessImageData
     // Execute inference
-    std::string ExecutionSummary = runGraph(*GR);
+    const std::vector<GraphRunner::ExecInfo>& Infos = runGraph(*GR);
 
-    if (bEnableLogging)
+    if (bLogSummary)
     {
+        const std::string ExecutionSummary = formatExecSummary(Infos);
         UE_LOG(LogTemp, Log, TEXT("Execution Summary: %s"), UTF8_TO_TCHAR(ExecutionSummary.c_str()));
         LOGI_AI("Execution Summary: %s", ExecutionSummary.c_str());
     }
 
-    // Extract output
+    // Read-only view of the output block: no copy, shape from ModelSession::outputs()
     // YOLO11n-pose output: (1, 56, 1344)
     // 56 = 4 (bbox) + 1 (confidence) + 51 (17 keypoints × 3)
     // 1344 = number of detection anchors
+    const TensorInfo& OutInfo = *static_cast<const TensorInfo*>(OutputInfoPtr);
+    Output = OutputScratchPtr
+        ? floatViewOf(*WS, OutputTensorId, OutInfo, *static_cast<std::vector<float>*>(OutputScratchPtr))
+        : viewOf<float>(*WS, OutputTensorId, OutInfo);
 
-    const char* OutputName = "output_0";
-
-    if (WS->data(OutputName) == nullptr)
+    if (!Output.valid())
     {
-        LOGE_AI("Output tensor '%s' not found in workspace", OutputName);
+        LOGE_AI("Output tensor '%s' missing or smaller than its shape", WS->nameOf(OutputTensorId).c_str());
         return false;
     }
 
-    // Total output size: 56 * 1344 = 75264 floats
-    const size_t NumChannels = 56;
-    const size_t NumAnchors = 1344;
-    const size_t TotalOutputSize = NumChannels * NumAnchors;
-
-    OutputData.SetNumUninitialized(TotalOutputSize);
-    std::memcpy(OutputData.GetData(), WS->data(OutputName), TotalOutputSize * sizeof(float));
-
-    LOGI_AI("Retrieved %zu output values (%zu channels x %zu anchors)",
-        TotalOutputSize, NumChannels, NumAnchors);
+    LOGI_AI("Output view: %zu values (%zu channels x %zu anchors)",
+        Output.size(), Output.rows(), Output.cols());
 
     return true;
 
@@ -419,63 +760,56 @@ bool AAIInferenceActor::RunInference(const TArray<float>& InputData, TArray<floa
 #endif
 }
 
-TArray<float> AAIInferenceActor::PreprocessImageData(const TArray<uint8>& RGBData, int32 Width, int32 Height)
+bool AAIInferenceActor::PreprocessImageData(const TArray<uint8>& RGBData, int32 Width, int32 Height)
 {
-    TArray<float> ProcessedData;
-
+#if PLATFORM_ANDROID
+    SNPE_TRACE_SCOPE("actor", "preprocess");
     // YOLO11n-pose expects 256x256 input in CHW format (channels first)
     // and normalized to [0, 1]
     const int32 ModelInputSize = 256;
-    const int32 ExpectedSize = 3 * ModelInputSize * ModelInputSize;  // CHW: 3 x 256 x 256
-
-    ProcessedData.SetNumUninitialized(ExpectedSize);
+    const int32 PlaneSize = ModelInputSize * ModelInputSize;
 
-    // Simple resize - scale to fit model input size
-    float ScaleX = static_cast<float>(Width) / ModelInputSize;
-    float ScaleY = static_cast<float>(Height) / ModelInputSize;
+    if (Width <= 0 || Height <= 0 || RGBData.Num() < Width * Height * 3)
+    {
+        LOGE_AI("RGB buffer too small for %dx%d (%d bytes)", Width, Height, RGBData.Num());
+        return false;
+    }
 
-    // Output in CHW format (Channel, Height, Width)
-    // Channel 0 (R): indices 0 to 65535
-    // Channel 1 (G): indices 65536 to 131071
-    // Channel 2 (B): indices 131072 to 196607
+    TensorWorkspace* WS = static_cast<TensorWorkspace*>(WorkspacePtr);
+    const TensorInfo* InInfo = static_cast<const TensorInfo*>(InputInfoPtr);
+    void* Dest = WS && InInfo ? WS->data(InputTensorId) : nullptr;
+    if (Dest == nullptr || WS->sizeOf(InputTensorId) < InInfo->bytes() || InInfo->elements() != size_t(3 * PlaneSize))
+    {
+        LOGE_AI("Input tensor 'images' not found in workspace");
+        return false;
+    }
 
-    for (int32 Y = 0; Y < ModelInputSize; ++Y)
+    // Fused resize + normalize + HWC->CHW (NEON), written straight into the workspace
+    // in the model's input encoding (quantized inputs get their final bytes here).
+    // Source tables are rebuilt only when the camera resolution changes.
+    ImagePreprocessor* Pre = static_cast<ImagePreprocessor*>(PreprocessorPtr);
+    if (!Pre->run(RGBData.GetData(), Width, Height, 0, Dest, *InInfo))
     {
-        for (int32 X = 0; X < ModelInputSize; ++X)
-        {
-            int32 SrcX = FMath::Clamp(static_cast<int32>(X * ScaleX), 0, Width - 1);
-            int32 SrcY = FMath::Clamp(static_cast<int32>(Y * ScaleY), 0, Height - 1);
-            int32 SrcIndex = (SrcY * Width + SrcX) * 3;
-
-            // CHW format: separate planes for each channel
-            int32 PixelIndex = Y * ModelInputSize + X;
-            int32 PlaneSize = ModelInputSize * ModelInputSize;
-
-            // Normalize to [0, 1]
-            ProcessedData[0 * PlaneSize + PixelIndex] = RGBData[SrcIndex + 0] / 255.0f; // R plane
-            ProcessedData[1 * PlaneSize + PixelIndex] = RGBData[SrcIndex + 1] / 255.0f; // G plane
-            ProcessedData[2 * PlaneSize + PixelIndex] = RGBData[SrcIndex + 2] / 255.0f; // B plane
-        }
+        return false;
     }
 
-    if (bEnableLogging)
+    if (bEnableLogging && InInfo->dataType == TensorDataType::FLOAT32)
     {
+        const float* Values = static_cast<const float*>(Dest);
         UE_LOG(LogTemp, Log, TEXT("Preprocessed %dx%d to %dx%d (CHW format, [0-1] range)"), Width, Height, ModelInputSize, ModelInputSize);
 
         // Debug: Log sample values from different channels
-        if (ProcessedData.Num() >= 196608)
-        {
-            int32 PlaneSize = ModelInputSize * ModelInputSize;
-            LOGI_AI("Sample R values: %.3f %.3f %.3f",
-                ProcessedData[0], ProcessedData[1], ProcessedData[2]);
-            LOGI_AI("Sample G values: %.3f %.3f %.3f",
-                ProcessedData[PlaneSize], ProcessedData[PlaneSize + 1], ProcessedData[PlaneSize + 2]);
-            LOGI_AI("Sample B values: %.3f %.3f %.3f",
-                ProcessedData[2 * PlaneSize], ProcessedData[2 * PlaneSize + 1], ProcessedData[2 * PlaneSize + 2]);
-        }
+        LOGI_AI("Sample R values: %.3f %.3f %.3f",
+            Values[0], Values[1], Values[2]);
+        LOGI_AI("Sample G values: %.3f %.3f %.3f",
+            Values[PlaneSize], Values[PlaneSize + 1], Values[PlaneSize + 2]);
+        LOGI_AI("Sample B values: %.3f %.3f %.3f",
+            Values[2 * PlaneSize], Values[2 * PlaneSize + 1], Values[2 * PlaneSize + 2]);
     }
-
-    return ProcessedData;
+    return true;
+#else
+    return false;
+#endif
 }
 
 void AAIInferenceActor::SaveDebugImage(const TArray<float>& ImageData, int32 Width, int32 Height, const FString& Filename)
@@ -609,61 +943,42 @@ void AAIInferenceActor::SaveKeypointsDebugImage(const FAIInferenceResult& Result
 #endif
 }
 
-FAIInferenceResult AAIInferenceActor::PostprocessOutputRaw(const TArray<float>& OutputData, int32 CameraWidth, int32 CameraHeight)
+FAIInferenceResult AAIInferenceActor::PostprocessOutputRaw(const TensorView<float>& Output, int32 CameraWidth, int32 CameraHeight)
 {
     // Raw version without aspect ratio corrections - for debug visualization only
     FAIInferenceResult Result;
     Result.bSuccess = false;
     Result.Confidence = 0.0f;
 
-    const int32 NumChannels = 56;
-    const int32 NumAnchors = 1344;
-    const int32 NumKeypoints = 17;
+#if PLATFORM_ANDROID
     const float ModelInputSize = 256.0f;
 
-    if (OutputData.Num() < NumChannels * NumAnchors)
-    {
-        return Result;
-    }
-
-    // Find best detection
-    float BestScore = 0.0f;
-    int32 BestIdx = -1;
-    const int32 ConfidenceChannel = 55;
-
-    for (int32 i = 0; i < NumAnchors; ++i)
-    {
-        float Score = OutputData[ConfidenceChannel * NumAnchors + i];
-        if (Score > BestScore)
-        {
-            BestScore = Score;
-            BestIdx = i;
-        }
-    }
-
-    if (BestIdx < 0 || BestScore < 0.5f)
+    // Best detection of the decode PostprocessOutput already ran on this frame's
+    // output (no second pass over the anchors)
+    const std::vector<PoseDetection>& Detections = static_cast<IOutputDecoder*>(OutputDecoderPtr)->detections();
+    if (Detections.empty())
     {
         return Result;
     }
+    const PoseDetection& Best = Detections[0];
 
     // Extract raw box (no corrections)
-    float BoxCenterX = OutputData[0 * NumAnchors + BestIdx] / ModelInputSize;
-    float BoxCenterY = OutputData[1 * NumAnchors + BestIdx] / ModelInputSize;
-    float BoxW = OutputData[2 * NumAnchors + BestIdx] / ModelInputSize;
-    float BoxH = OutputData[3 * NumAnchors + BestIdx] / ModelInputSize;
+    float BoxCenterX = Best.cx / ModelInputSize;
+    float BoxCenterY = Best.cy / ModelInputSize;
+    float BoxW = Best.w / ModelInputSize;
+    float BoxH = Best.h / ModelInputSize;
 
     Result.bSuccess = true;
-    Result.Confidence = BestScore;
+    Result.Confidence = Best.score;
     Result.JointPositions.Add(FVector(BoxCenterX, BoxCenterY, 0.0f));
     Result.JointPositions.Add(FVector(BoxW, BoxH, 0.0f));
 
     // Extract raw keypoints (no corrections)
-    for (int32 kp = 0; kp < NumKeypoints; ++kp)
+    for (int32 kp = 0; kp < Best.numKeypoints; ++kp)
     {
-        int32 BaseChannel = 4 + (kp * 3);
-        float KpVis = OutputData[BaseChannel * NumAnchors + BestIdx];
-        float KpX = OutputData[(BaseChannel + 1) * NumAnchors + BestIdx] / ModelInputSize;
-        float KpY = OutputData[(BaseChannel + 2) * NumAnchors + BestIdx] / ModelInputSize;
+        float KpVis = Best.kpVis[kp];
+        float KpX = Best.kpX[kp] / ModelInputSize;
+        float KpY = Best.kpY[kp] / ModelInputSize;
 
         KpX = FMath::Clamp(KpX, 0.0f, 1.0f);
         KpY = FMath::Clamp(KpY, 0.0f, 1.0f);
@@ -671,187 +986,217 @@ FAIInferenceResult AAIInferenceActor::PostprocessOutputRaw(const TArray<float>&
 
         Result.JointPositions.Add(FVector(KpX, KpY, KpVis));
     }
+#endif
 
     return Result;
 }
 
-FAIInferenceResult AAIInferenceActor::PostprocessOutput(const TArray<float>& OutputData, int32 CameraWidth, int32 CameraHeight)
+void AAIInferenceActor::UpdateDisplayMapping(int32 CameraWidth, int32 CameraHeight, float DisplayAspect)
 {
-    FAIInferenceResult Result;
-    Result.bSuccess = false;
-    Result.Confidence = 0.0f;
+    FAIDisplayMapping& M = DisplayMapping;
+    if (CameraWidth == M.CameraWidth && CameraHeight == M.CameraHeight && DisplayAspect == M.DisplayAspect)
+    {
+        return;
+    }
 
-    // YOLO output format: (1, 56, 1344) stored as [channel][anchor]
-    // Layout:
-    //   Channel 0: box_center_x (all 1344 anchors)
-    //   Channel 1: box_center_y
-    //   Channel 2: box_width
-    //   Channel 3: box_height
-    //   Channels 4-54: 17 keypoints × 3 (x, y, visibility)
-    //   Channel 55: confidence (NOT 4!)
-
-    const int32 NumChannels = 56;
-    const int32 NumAnchors = 1344;
-    const int32 NumKeypoints = 17;
-    const float ModelInputSize = 256.0f;
+    // Model pixels -> camera pixels: inverse of the preprocessing transform
+    // (m = c * TScale + TPad). Default: plain 256x256 stretch.
+    FVector2D TScale(256.0f / FMath::Max(CameraWidth, 1), 256.0f / FMath::Max(CameraHeight, 1));
+    FVector2D TPad(0.0f, 0.0f);
+#if PLATFORM_ANDROID
+    if (PreprocessorPtr)
+    {
+        const LetterboxTransform& T = static_cast<ImagePreprocessor*>(PreprocessorPtr)->transform();
+        TScale = FVector2D(T.scaleX, T.scaleY);
+        TPad = FVector2D(T.padX, T.padY);
+    }
+#endif
+    // Camera pixels -> normalized camera [0,1]
+    FVector2D Scale(1.0f / (TScale.X * CameraWidth), 1.0f / (TScale.Y * CameraHeight));
+    FVector2D Offset(-TPad.X * Scale.X, -TPad.Y * Scale.Y);
 
-    if (OutputData.Num() < NumChannels * NumAnchors)
+    // Normalized camera -> normalized display. The camera image fills the display
+    // (aspect fill, centred), so the longer display axis crops the camera.
+    if (DisplayAspect > 0.0f && CameraHeight > 0)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Output data size mismatch. Expected %d, got %d"),
-            NumChannels * NumAnchors, OutputData.Num());
-        return Result;
+        const float CameraAspect = static_cast<float>(CameraWidth) / CameraHeight;
+        FVector2D Fill(1.0f, 1.0f);
+        if (DisplayAspect > CameraAspect)
+        {
+            Fill.Y = DisplayAspect / CameraAspect;
+        }
+        else
+        {
+            Fill.X = CameraAspect / DisplayAspect;
+        }
+        // d = 0.5 + (c - 0.5) * Fill
+        Offset = FVector2D(0.5f, 0.5f) + (Offset - FVector2D(0.5f, 0.5f)) * Fill;
+        Scale *= Fill;
     }
 
-    // Find best detection (highest confidence)
-    // Confidence is at channel 55
-    float BestScore = 0.0f;
-    int32 BestIdx = -1;
+    M.Scale = Scale;
+    M.Offset = Offset;
+    M.CameraWidth = CameraWidth;
+    M.CameraHeight = CameraHeight;
+    M.DisplayAspect = DisplayAspect;
 
-    const float MinConfidenceThreshold = 0.5f;
-    const int32 ConfidenceChannel = 55;
+    LOGI_AI("Display mapping for %dx%d: pad=(%.1f, %.1f) scale=(%.5f, %.5f) offset=(%.4f, %.4f)",
+        CameraWidth, CameraHeight, TPad.X, TPad.Y, Scale.X, Scale.Y, Offset.X, Offset.Y);
+}
 
-    for (int32 i = 0; i < NumAnchors; ++i)
-    {
-        // Index = channel * NumAnchors + anchor
-        float Score = OutputData[ConfidenceChannel * NumAnchors + i];
+#if PLATFORM_ANDROID
+// One decoded person -> display-space FAIInferenceResult (box center, box size, 17 keypoints)
+static FAIInferenceResult MakePersonResult(const PoseDetection& D, const FVector2D& Scale, const FVector2D& Offset)
+{
+    FAIInferenceResult Person;
+    Person.bSuccess = true;
+    Person.Confidence = D.score;
 
-        if (Score > BestScore)
-        {
-            BestScore = Score;
-            BestIdx = i;
-        }
+    // Clamp to valid range
+    const float BoxCenterX = FMath::Clamp(D.cx * Scale.X + Offset.X, 0.0f, 1.0f);
+    const float BoxCenterY = FMath::Clamp(D.cy * Scale.Y + Offset.Y, 0.0f, 1.0f);
+    const float BoxW = FMath::Clamp(D.w * Scale.X, 0.0f, 2.0f);
+    const float BoxH = FMath::Clamp(D.h * Scale.Y, 0.0f, 2.0f);
+
+    Person.JointPositions.Reserve(2 + D.numKeypoints);
+    Person.JointPositions.Add(FVector(BoxCenterX, BoxCenterY, 0.0f));  // Box center
+    Person.JointPositions.Add(FVector(BoxW, BoxH, 0.0f));               // Box size
+    for (int32 kp = 0; kp < D.numKeypoints; ++kp)
+    {
+        // Store keypoint with visibility in Z
+        Person.JointPositions.Add(FVector(
+            FMath::Clamp(D.kpX[kp] * Scale.X + Offset.X, 0.0f, 1.0f),
+            FMath::Clamp(D.kpY[kp] * Scale.Y + Offset.Y, 0.0f, 1.0f),
+            FMath::Clamp(D.kpVis[kp], 0.0f, 1.0f)));
     }
+    return Person;
+}
+#endif
 
-    if (bEnableLogging)
+FAIInferenceResult AAIInferenceActor::PostprocessOutput(const TensorView<float>& Output, int32 CameraWidth, int32 CameraHeight, const FAIFrameParams& Params, FAIMultiPoseResult& People)
+{
+    FAIInferenceResult Result;
+    Result.bSuccess = false;
+    Result.Confidence = 0.0f;
+    People.bSuccess = false;
+    People.People.Reset();
+
+#if PLATFORM_ANDROID
+    SNPE_TRACE_SCOPE("actor", "postprocess");
+    // Decoder from model-config.json (default yolo_pose: (1, 56, 1344) stored as
+    // [channel][anchor], boxes + 17 keypoints in model-input pixels). Shapes were
+    // checked once in prepare(); one person unless multi-person decoding is on.
+    IOutputDecoder* Decoder = static_cast<IOutputDecoder*>(OutputDecoderPtr);
+    DecodeLimits Limits;
+    Limits.scoreThreshold = Params.DetectionThreshold;
+    Limits.iouThreshold = Params.NmsIouThreshold;
+    Limits.maxDetections = Params.bDetectMultiplePeople ? FMath::Max(Params.MaxPeople, 1) : 1;
+    if (!Decoder->decode(Output, Limits))
     {
-        LOGI_AI("Best detection: anchor %d, confidence %.3f", BestIdx, BestScore);
+        UE_LOG(LogTemp, Warning, TEXT("Output decode failed (%s)"), UTF8_TO_TCHAR(Decoder->type()));
+        return Result;
     }
+    const std::vector<PoseDetection>& Detections = Decoder->detections();
 
-    if (BestIdx < 0 || BestScore < MinConfidenceThreshold)
+    if (Detections.empty())
     {
-        if (bEnableLogging)
+        if (Params.bEnableLogging)
         {
-            LOGW_AI("No valid detection found. Best score: %.3f (threshold: %.3f)", BestScore, MinConfidenceThreshold);
+            LOGW_AI("No valid detection found (threshold: %.3f)", Params.DetectionThreshold);
         }
         return Result;
     }
 
-    // Extract best detection
-    // Bbox: channels 0-3
-    float BoxCenterX = OutputData[0 * NumAnchors + BestIdx] / ModelInputSize;
-    float BoxCenterY = OutputData[1 * NumAnchors + BestIdx] / ModelInputSize;
-    float BoxW = OutputData[2 * NumAnchors + BestIdx] / ModelInputSize;
-    float BoxH = OutputData[3 * NumAnchors + BestIdx] / ModelInputSize;
-
-    // The model outputs in square (1:1) space, but the display is wide (~2:1)
-    // Camera was 640x480 (1.33:1), squashed to 256x256 (1:1)
-    // Widget is 2246x1081 (2.08:1)
-    // 
-    // The Y coordinates need to be scaled to account for:
-    // - Model square space to camera space: multiply by (640/480) = 1.33
-    // - Camera space to widget space: multiply by (1081/2246) / (480/640) = 0.36
-    // Combined: 1.33 * 0.36 = 0.48... but that would compress more
-    //
-    // Actually, let's think differently:
-    // In model space, Y=0.5 means middle of the 256x256 image
-    // That came from Y=240 in the 480-tall camera image = 240/480 = 0.5 (correct!)
-    // In widget, Y=0.5 should map to 540 pixels (middle of 1081)
-    // So the Y coordinates should map directly... but they're not working
-    //
-    // The only explanation: the camera feed on widget is NOT using the same
-    // coordinate mapping. Let's try the inverse - maybe widget Y needs expansion.
-
-    // Try: expand Y by widget aspect / camera aspect
-    // Widget: 2246/1081 = 2.08, Camera: 640/480 = 1.33
-    // Expansion = 2.08 / 1.33 = 1.56
-    float WidgetAspect = 2246.0f / 1081.0f;
-    float CameraAspect = 640.0f / 480.0f;
-    float YExpansion = WidgetAspect / CameraAspect;
-
-    // Additional correction for camera cropping/offset
-    const float YOffsetCorrection = 0.0f;  // Adjust this value: try -0.05 to +0.05
-    const float YScaleCorrection = 1.0f;   // Adjust this if needed: try 0.9 to 1.1
-
-    // Apply to box height and center - expand around screen center (0.5)
-    const float ScreenCenterY = 0.5f;
-    BoxH = BoxH * YExpansion * YScaleCorrection;
-    BoxCenterY = ScreenCenterY + (BoxCenterY - ScreenCenterY) * YExpansion * YScaleCorrection + YOffsetCorrection;
+    // Model-input pixels -> display space through the exact inverse of the
+    // preprocessing transform (cached per camera resolution)
+    UpdateDisplayMapping(CameraWidth, CameraHeight, Params.DisplayAspectRatio);
 
-    // Clamp to valid range
-    BoxCenterX = FMath::Clamp(BoxCenterX, 0.0f, 1.0f);
-    BoxCenterY = FMath::Clamp(BoxCenterY, 0.0f, 1.0f);
-    BoxW = FMath::Clamp(BoxW, 0.0f, 2.0f);
-    BoxH = FMath::Clamp(BoxH, 0.0f, 2.0f);
-
-    // Log the detection
-    if (bEnableLogging)
+    if (Params.bDetectMultiplePeople)
     {
-        LOGI_AI("=== BEST DETECTION (anchor %d, score %.3f) ===", BestIdx, BestScore);
-        LOGI_AI("Box: center=(%.3f, %.3f), size=(%.3f, %.3f)", BoxCenterX, BoxCenterY, BoxW, BoxH);
+        People.People.Reserve(Detections.size());
+        for (const PoseDetection& D : Detections)
+        {
+            People.People.Add(MakePersonResult(D, DisplayMapping.Scale, DisplayMapping.Offset));
+        }
+        People.bSuccess = true;
+        Result = People.People[0];
+    }
+    else
+    {
+        Result = MakePersonResult(Detections[0], DisplayMapping.Scale, DisplayMapping.Offset);
     }
 
-    // Populate result
-    Result.bSuccess = true;
-    Result.Confidence = BestScore;
-
-    // Store bounding box
-    Result.JointPositions.Add(FVector(BoxCenterX, BoxCenterY, 0.0f));  // Box center
-    Result.JointPositions.Add(FVector(BoxW, BoxH, 0.0f));               // Box size
-
-    // Extract 17 keypoints
-    // Keypoints start at channel 4
-    // YOLO pose format: each keypoint is (x, y, confidence) but stored as separate channels
-    // So channels 4,5,6 = kp0_x, kp0_y, kp0_conf
-    const TArray<FString> KeypointNames = {
-        TEXT("Nose"), TEXT("Left Eye"), TEXT("Right Eye"), TEXT("Left Ear"), TEXT("Right Ear"),
-        TEXT("Left Shoulder"), TEXT("Right Shoulder"), TEXT("Left Elbow"), TEXT("Right Elbow"),
-        TEXT("Left Wrist"), TEXT("Right Wrist"), TEXT("Left Hip"), TEXT("Right Hip"),
-        TEXT("Left Knee"), TEXT("Right Knee"), TEXT("Left Ankle"), TEXT("Right Ankle")
-    };
-
-    if (bEnableLogging)
+    if (Params.bEnableLogging)
     {
-        LOGI_AI("Keypoints (raw channel values for anchor %d):", BestIdx);
-        // Debug: print raw values for first keypoint channels
-        for (int32 ch = 4; ch < 13; ++ch)
+        static const char* KeypointNames[] = { "Nose", "Left Eye", "Right Eye", "Left Ear", "Right Ear" };
+        const FVector& Center = Result.JointPositions[0];
+        const FVector& Size = Result.JointPositions[1];
+        LOGI_AI("=== BEST DETECTION (anchor %d, class %d, score %.3f) of %d ===",
+            Detections[0].anchor, Detections[0].classId, Detections[0].score, (int32)Detections.size());
+        LOGI_AI("Box: center=(%.3f, %.3f), size=(%.3f, %.3f)", Center.X, Center.Y, Size.X, Size.Y);
+        for (int32 kp = 0; kp < 5 && 2 + kp < Result.JointPositions.Num(); ++kp)  // Log first 5 keypoints
         {
-            float val = OutputData[ch * NumAnchors + BestIdx];
-            LOGI_AI("  Channel %d: %.3f", ch, val);
+            const FVector& K = Result.JointPositions[2 + kp];
+            LOGI_AI("  %s: (%.3f, %.3f) vis=%.3f", KeypointNames[kp], K.X, K.Y, K.Z);
         }
     }
+#endif
+
+    return Result;
+}
 
-    for (int32 kp = 0; kp < NumKeypoints; ++kp)
+// Frees everything InitializeInference allocates; safe on a partial initialization
+void AAIInferenceActor::ReleaseInferenceResources()
+{
+#if PLATFORM_ANDROID
+    if (GraphRunnerPtr)
     {
-        int32 BaseChannel = 4 + (kp * 3);
+        delete static_cast<GraphRunner*>(GraphRunnerPtr);
+        GraphRunnerPtr = nullptr;
+    }
 
-        // Order is: visibility, X, Y (not X, Y, visibility!)
-        float KpVis = OutputData[BaseChannel * NumAnchors + BestIdx];
-        float KpX = OutputData[(BaseChannel + 1) * NumAnchors + BestIdx] / ModelInputSize;
-        float KpY = OutputData[(BaseChannel + 2) * NumAnchors + BestIdx] / ModelInputSize;
+    if (WorkspacePtr)
+    {
+        delete static_cast<TensorWorkspace*>(WorkspacePtr);
+        WorkspacePtr = nullptr;
+    }
 
-        KpY = ScreenCenterY + (KpY - ScreenCenterY) * YExpansion * YScaleCorrection + YOffsetCorrection;
+    if (PreprocessorPtr)
+    {
+        delete static_cast<ImagePreprocessor*>(PreprocessorPtr);
+        PreprocessorPtr = nullptr;
+    }
 
-        // Clamp coordinates
-        KpX = FMath::Clamp(KpX, 0.0f, 1.0f);
-        KpY = FMath::Clamp(KpY, 0.0f, 1.0f);
-        KpVis = FMath::Clamp(KpVis, 0.0f, 1.0f);
+    if (OutputDecoderPtr)
+    {
+        delete static_cast<IOutputDecoder*>(OutputDecoderPtr);
+        OutputDecoderPtr = nullptr;
+    }
 
-        // Store keypoint with visibility in Z
-        Result.JointPositions.Add(FVector(KpX, KpY, KpVis));
+    if (OutputInfoPtr)
+    {
+        delete static_cast<TensorInfo*>(OutputInfoPtr);
+        OutputInfoPtr = nullptr;
+    }
 
-        if (bEnableLogging && kp < 5)  // Log first 5 keypoints
-        {
-            LOGI_AI("  %s: (%.3f, %.3f) vis=%.3f",
-                TCHAR_TO_UTF8(*KeypointNames[kp]), KpX, KpY, KpVis);
-        }
+    if (InputInfoPtr)
+    {
+        delete static_cast<TensorInfo*>(InputInfoPtr);
+        InputInfoPtr = nullptr;
     }
 
-    if (bEnableLogging)
+    if (OutputScratchPtr)
     {
-        LOGI_AI("Total keypoints: %d", NumKeypoints);
+        delete static_cast<std::vector<float>*>(OutputScratchPtr);
+        OutputScratchPtr = nullptr;
     }
 
-    return Result;
+    if (StageLatencyPtr)
+    {
+        delete static_cast<FAIStageLatency*>(StageLatencyPtr);
+        StageLatencyPtr = nullptr;
+    }
+#endif
 }
 
 void AAIInferenceActor::ShutdownInference()
@@ -863,19 +1208,11 @@ void AAIInferenceActor::ShutdownInference()
 
     UE_LOG(LogTemp, Log, TEXT("Shutting down AI Inference..."));
 
-#if PLATFORM_ANDROID
-    if (GraphRunnerPtr)
-    {
-        delete static_cast<GraphRunner*>(GraphRunnerPtr);
-        GraphRunnerPtr = nullptr;
-    }
-
-    if (WorkspacePtr)
-    {
-        delete static_cast<TensorWorkspace*>(WorkspacePtr);
-        WorkspacePtr = nullptr;
-    }
+    // Stop the worker before the graph it runs goes away
+    StopInferenceWorker();
 
+#if PLATFORM_ANDROID
+    ReleaseInferenceResources();
     LOGI_AI("AI Inference shut down");
 #endif
 
@@ -0,0 +1,115 @@
+// AIInferenceWorker.cpp
+// Background inference thread for AAIInferenceActor (async mode)
+
+#include "AIInferenceWorker.h"
+#include "HAL/PlatformProcess.h"
+
+#if PLATFORM_ANDROID
+#include "inc/hpp/Trace.hpp"
+#endif
+
+FAIInferenceWorker::FAIInferenceWorker(FProcessFunction InProcess)
+    : Process(MoveTemp(InProcess))
+{
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Thread = FRunnableThread::Create(this, TEXT("AIInferenceWorker"), 0, TPri_AboveNormal);
+}
+
+FAIInferenceWorker::~FAIInferenceWorker()
+{
+    if (Thread)
+    {
+        Thread->Kill(true); // calls Stop() and waits for Run() to return
+        delete Thread;
+        Thread = nullptr;
+    }
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+}
+
+bool FAIInferenceWorker::PostFrame(const TArray<uint8>& RGBData, int32 Width, int32 Height, const FAIFrameParams& Params)
+{
+    bool bDropped = false;
+    {
+        FScopeLock Lock(&MailboxLock);
+        bDropped = bMailboxFull;
+        // Reset keeps the allocation, so steady state does not touch the allocator
+        Mailbox.RGB.Reset(RGBData.Num());
+        Mailbox.RGB.Append(RGBData);
+        Mailbox.Width = Width;
+        Mailbox.Height = Height;
+        Mailbox.Params = Params;
+        Mailbox.Id = NextFrameId++;
+        bMailboxFull = true;
+    }
+    if (bDropped)
+    {
+        DroppedFrames.Increment();
+    }
+    WakeEvent->Trigger();
+    return bDropped;
+}
+
+bool FAIInferenceWorker::ConsumeResult(FAIInferenceFrameOutput& Out)
+{
+    if (!Results.IsDirty())
+    {
+        return false;
+    }
+    Results.SwapReadBuffers();
+    Out = Results.Read();
+    return true;
+}
+
+uint32 FAIInferenceWorker::Run()
+{
+#if PLATFORM_ANDROID
+    traceSetThreadName("AIInferenceWorker");
+#endif
+    while (!bStopping)
+    {
+        bool bHaveFrame = false;
+        {
+            FScopeLock Lock(&MailboxLock);
+            if (bMailboxFull)
+            {
+                Swap(Working.RGB, Mailbox.RGB);
+                Working.Width = Mailbox.Width;
+                Working.Height = Mailbox.Height;
+                Working.Params = Mailbox.Params;
+                Working.Id = Mailbox.Id;
+                bMailboxFull = false;
+                bHaveFrame = true;
+            }
+        }
+
+        if (!bHaveFrame)
+        {
+            WakeEvent->Wait();
+            continue;
+        }
+
+        FAIInferenceFrameOutput& Out = Results.GetWriteBuffer();
+        Out.Error.Reset();
+        Out.Result = FAIInferenceResult();
+        Out.People.bSuccess = false;
+        Out.People.People.Reset();
+        Out.ProcessingMs = 0.0;
+        Process(Working.RGB, Working.Width, Working.Height, Working.Params, Out);
+        Out.FrameId = Working.Id;
+        Results.SwapWriteBuffers();
+    }
+    return 0;
+}
+
+void FAIInferenceWorker::Stop()
+{
+    bStopping = true;
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
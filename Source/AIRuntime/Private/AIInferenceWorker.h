@@ -0,0 +1,78 @@
+// AIInferenceWorker.h
+// Background inference thread for AAIInferenceActor (async mode)
+// Camera frames go in through a single-slot mailbox (latest frame wins),
+// results come out through a lock-free triple buffer read on the game thread.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "HAL/Event.h"
+#include "Containers/TripleBuffer.h"
+#include "Templates/Function.h"
+#include "AIInferenceActor.h"
+
+// Output of one frame through preprocess -> graph -> postprocess
+struct FAIInferenceFrameOutput
+{
+    FAIInferenceResult Result;
+    FAIMultiPoseResult People;  // filled when multi-person decoding is on
+    FAIDisplayMapping Display;  // mapping the results were placed with
+    FString Error;            // empty on success
+    double ProcessingMs = 0.0;
+    uint64 FrameId = 0;       // 0 = nothing published yet
+};
+
+class FAIInferenceWorker : public FRunnable
+{
+public:
+    // Runs on the worker thread for every frame taken from the mailbox
+    using FProcessFunction = TFunction<void(const TArray<uint8>& RGBData, int32 Width, int32 Height,
+                                            const FAIFrameParams& Params, FAIInferenceFrameOutput& Out)>;
+
+    explicit FAIInferenceWorker(FProcessFunction InProcess);
+    virtual ~FAIInferenceWorker();
+
+    // Game thread: hand a frame to the worker without waiting for it.
+    // A frame still waiting in the mailbox is replaced (returns true if one was dropped).
+    // Params travel with the frame: the worker never reads the actor's settings.
+    bool PostFrame(const TArray<uint8>& RGBData, int32 Width, int32 Height, const FAIFrameParams& Params);
+
+    // Game thread: newest result published since the last call, if any
+    bool ConsumeResult(FAIInferenceFrameOutput& Out);
+
+    int64 GetDroppedFrames() const { return DroppedFrames.GetValue(); }
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    struct FFrame
+    {
+        TArray<uint8> RGB;
+        int32 Width = 0;
+        int32 Height = 0;
+        FAIFrameParams Params;
+        uint64 Id = 0;
+    };
+
+    FProcessFunction Process;
+
+    // Single-slot mailbox; buffers are swapped, not copied, between Mailbox and Working
+    FCriticalSection MailboxLock;
+    FFrame Mailbox;
+    bool bMailboxFull = false;
+    uint64 NextFrameId = 1;
+    FFrame Working;           // worker thread only
+
+    TTripleBuffer<FAIInferenceFrameOutput> Results;
+
+    FEvent* WakeEvent = nullptr;
+    FRunnableThread* Thread = nullptr;
+    FThreadSafeBool bStopping;
+    FThreadSafeCounter64 DroppedFrames;
+};
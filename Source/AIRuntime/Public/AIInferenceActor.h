@@ -10,6 +10,34 @@
 #include "GameFramework/Actor.h"
 #include "AIInferenceActor.generated.h"
 
+class FAIInferenceWorker;
+struct FAIInferenceFrameOutput;
+template <typename T> class TensorView;
+
+// Blueprint settings one frame is processed with. Copied on the game thread when
+// the frame is submitted, so the inference thread never reads the UPROPERTYs.
+struct FAIFrameParams
+{
+    float DetectionThreshold = 0.5f;
+    float NmsIouThreshold = 0.45f;
+    int32 MaxPeople = 1;
+    bool bDetectMultiplePeople = false;
+    float DisplayAspectRatio = 0.0f;
+    bool bEnableLogging = false;
+    bool bSaveFrames = false;
+};
+
+// Model-input pixels -> normalized display: d = m * Scale + Offset, for one camera
+// resolution and display aspect ratio
+struct FAIDisplayMapping
+{
+    FVector2D Scale = FVector2D(1.0f, 1.0f);
+    FVector2D Offset = FVector2D(0.0f, 0.0f);
+    int32 CameraWidth = 0;
+    int32 CameraHeight = 0;
+    float DisplayAspect = -1.0f;
+};
+
 // Struct to hold inference results
 USTRUCT(BlueprintType)
 struct FAIInferenceResult
@@ -57,6 +85,68 @@ struct FAIInferenceResult
     }
 };
 
+// Every person found in one frame (array variant of FAIInferenceResult)
+USTRUCT(BlueprintType)
+struct FAIMultiPoseResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI Inference")
+    bool bSuccess;
+
+    // Best score first; each entry uses the FAIInferenceResult JointPositions layout
+    UPROPERTY(BlueprintReadOnly, Category = "AI Inference")
+    TArray<FAIInferenceResult> People;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI Inference")
+    int32 ProcessingTimeMS;
+
+    FAIMultiPoseResult()
+        : bSuccess(false)
+        , ProcessingTimeMS(0)
+    {
+    }
+};
+
+// Latency distribution of one pipeline stage since the last reset
+USTRUCT(BlueprintType)
+struct FAIStageLatencyStats
+{
+    GENERATED_BODY()
+
+    // "preprocess", "run", "postprocess", "publish", "frame", "bind/<node>", "execute/<node>"
+    UPROPERTY(BlueprintReadOnly, Category = "AI Inference")
+    FString Stage;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI Inference")
+    int32 Count;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI Inference")
+    float MeanMs;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI Inference")
+    float P50Ms;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI Inference")
+    float P90Ms;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI Inference")
+    float P99Ms;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI Inference")
+    float MaxMs;
+
+    FAIStageLatencyStats()
+        : Count(0)
+        , MeanMs(0.0f)
+        , P50Ms(0.0f)
+        , P90Ms(0.0f)
+        , P99Ms(0.0f)
+        , MaxMs(0.0f)
+    {
+    }
+};
+
 UCLASS()
 class AIRUNTIME_API AAIInferenceActor : public AActor
 {
@@ -67,6 +157,7 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     virtual void Tick(float DeltaTime) override;
@@ -75,10 +166,32 @@ public:
     UFUNCTION(BlueprintCallable, Category = "AI Inference")
     bool InitializeInference(const FString& ModelName);
 
-    // Process a camera frame and return pose estimation
+    // Process a camera frame and return pose estimation.
+    // In async mode the frame is handed to the inference thread and the most recent
+    // finished result is returned; OnInferenceCompleted fires from Tick when a new one lands.
     UFUNCTION(BlueprintCallable, Category = "AI Inference")
     FAIInferenceResult ProcessCameraFrame(const TArray<uint8>& RGBData, int32 Width, int32 Height);
 
+    // People found in the most recently delivered frame (bDetectMultiplePeople)
+    UFUNCTION(BlueprintCallable, Category = "AI Inference")
+    FAIMultiPoseResult GetLatestPeople() const { return LatestPeople; }
+
+    // p50/p90/p99/max per pipeline stage and per model node (bind, execute)
+    UFUNCTION(BlueprintCallable, Category = "AI Inference")
+    TArray<FAIStageLatencyStats> GetLatencyStats() const;
+
+    UFUNCTION(BlueprintCallable, Category = "AI Inference")
+    void ResetLatencyStats();
+
+    // Record scoped trace events (actor stages, graph, sessions, seeding) on every thread
+    UFUNCTION(BlueprintCallable, Category = "AI Inference")
+    void SetTraceEnabled(bool bEnabled);
+
+    // Write the recorded events as Chrome trace JSON to Saved/Debug/<FileName>
+    // (open in ui.perfetto.dev or chrome://tracing)
+    UFUNCTION(BlueprintCallable, Category = "AI Inference")
+    bool WriteTrace(const FString& FileName);
+
     // Shutdown the inference system
     UFUNCTION(BlueprintCallable, Category = "AI Inference")
     void ShutdownInference();
@@ -99,6 +212,58 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
     bool bUseGPUAcceleration;
 
+    // Decode every person above DetectionThreshold instead of only the best one
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    bool bDetectMultiplePeople;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    int32 MaxPeople;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    float DetectionThreshold;
+
+    // Boxes overlapping a better one by more than this IoU are dropped
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    float NmsIouThreshold;
+
+    // Keep the camera aspect ratio when resizing to the model input (pad instead of squash)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    bool bLetterboxInput;
+
+    // Width / height of the view showing the camera image (aspect fill). Results are
+    // mapped into this view's normalized space; 0 = normalized camera space.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    float DisplayAspectRatio;
+
+    // Run inference on a dedicated thread; a new camera frame replaces one still waiting
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    bool bAsyncInference;
+
+    // Pack workspace tensors that are never live at the same time into one shared arena
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    bool bPlanWorkspaceMemory;
+
+    // Reserve one workspace arena up front (MB, 0 = one heap block per tensor)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    int32 WorkspaceArenaMB;
+
+    // Alignment of every workspace tensor (64 = cache line/SIMD, 4096 = page for DMA)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    int32 WorkspaceAlignment;
+
+    // Worker threads for model nodes that do not depend on each other (1 = run in config order)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    int32 MaxParallelNodes;
+
+    // madvise(MADV_WILLNEED) the workspace arena so it is faulted in before the first frame
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    bool bPrefaultWorkspaceArena;
+
+    // madvise(MADV_WILLNEED) model files when they are first mapped, so they are read
+    // in ahead of the runtime parsing them. The setting is process-wide (DlcCache).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI Inference")
+    bool bPrefaultModelMappings;
+
     bool SaveFrames;
 
     // Blueprint events
@@ -106,6 +271,10 @@ public:
     UFUNCTION(BlueprintImplementableEvent, Category = "AI Inference")
     void OnInferenceCompleted(const FAIInferenceResult& Result);
 
+    /** Called with every person in the frame when bDetectMultiplePeople is set */
+    UFUNCTION(BlueprintImplementableEvent, Category = "AI Inference")
+    void OnMultiPoseCompleted(const FAIMultiPoseResult& Result);
+
     /** Called when inference fails */
     UFUNCTION(BlueprintImplementableEvent, Category = "AI Inference")
     void OnInferenceFailed(const FString& ErrorMessage);
@@ -120,13 +289,39 @@ private:
     // QAIRT/SNPE pointers (opaque to avoid header pollution)
     void* WorkspacePtr;
     void* GraphRunnerPtr;
+    void* PreprocessorPtr;
+    void* OutputDecoderPtr; // IOutputDecoder selected by model-config.json
+    void* OutputInfoPtr;    // TensorInfo of the chain output (ModelSession::outputs())
+    void* InputInfoPtr;     // TensorInfo of the chain input: preprocessing writes its encoding
+    void* OutputScratchPtr; // std::vector<float> for a non-float32 output, else null
+    void* StageLatencyPtr;  // FAIStageLatency: histograms of the actor-side stages
+
+    // Workspace ids (TensorWorkspace::TensorId) of the model input/output, resolved once
+    uint32 InputTensorId;
+    uint32 OutputTensorId;
+
+    // Cached per camera resolution. Only the thread running the pipeline touches it
+    // (the worker in async mode); the game thread sees it in the frame results.
+    FAIDisplayMapping DisplayMapping;
+
+    // Async mode
+    FAIInferenceWorker* InferenceWorker;
+    FAIInferenceResult LatestResult;
+    FAIMultiPoseResult LatestPeople;
 
     // Helper functions
+    FAIFrameParams MakeFrameParams() const;
+    void RunPipeline(const TArray<uint8>& RGBData, int32 Width, int32 Height, const FAIFrameParams& Params, FAIInferenceFrameOutput& Out);
+    void DeliverResult(const FAIInferenceFrameOutput& Out);
+    void StartInferenceWorker();
+    void StopInferenceWorker();
+    void ReleaseInferenceResources();
     bool EnsureModelInstalled(const FString& ModelName);
-    bool RunInference(const TArray<float>& InputData, TArray<float>& OutputData);
-    TArray<float> PreprocessImageData(const TArray<uint8>& RGBData, int32 Width, int32 Height);
-    FAIInferenceResult PostprocessOutput(const TArray<float>& OutputData, int32 CameraWidth, int32 CameraHeight);
-    FAIInferenceResult PostprocessOutputRaw(const TArray<float>& OutputData, int32 CameraWidth, int32 CameraHeight);
+    bool RunInference(TensorView<float>& Output, bool bLogSummary);
+    bool PreprocessImageData(const TArray<uint8>& RGBData, int32 Width, int32 Height);
+    void UpdateDisplayMapping(int32 CameraWidth, int32 CameraHeight, float DisplayAspect);
+    FAIInferenceResult PostprocessOutput(const TensorView<float>& Output, int32 CameraWidth, int32 CameraHeight, const FAIFrameParams& Params, FAIMultiPoseResult& People);
+    FAIInferenceResult PostprocessOutputRaw(const TensorView<float>& Output, int32 CameraWidth, int32 CameraHeight);
 
     // Debug functions
     void SaveDebugImage(const TArray<float>& ImageData, int32 Width, int32 Height, const FString& Filename);
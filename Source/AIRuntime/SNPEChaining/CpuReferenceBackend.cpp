@@ -0,0 +1,528 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/CpuReferenceBackend.hpp"
+#include "inc/hpp/Log.hpp"
+#include "inc/hpp/TensorConvert.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#define  LOG_TAG_CR  "SNPE_CPUREF"
+#define  LOGI_CR(...)  SNPE_LOG(SNPE_LOG_INFO,LOG_TAG_CR,__VA_ARGS__)
+#define  LOGE_CR(...)  SNPE_LOG(SNPE_LOG_ERROR,LOG_TAG_CR,__VA_ARGS__)
+
+// Fake container format and "library version" of the init cache entries
+static const char kContainerMagic[] = "cpuref-container 1";
+static const char kLibVersion[] = "cpuref-1";
+
+static std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+}
+
+static std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> out;
+    size_t pos = 0;
+    while (true) {
+        size_t next = s.find(sep, pos);
+        out.push_back(trim(s.substr(pos, next == std::string::npos ? std::string::npos : next - pos)));
+        if (next == std::string::npos) break;
+        pos = next + 1;
+    }
+    return out;
+}
+
+// "name:1x3x64x64[:type][,name:...]"
+static bool parseTensors(const std::string& text, std::vector<TensorInfo>& out, std::string* emsg) {
+    for (const auto& item : split(text, ',')) {
+        const auto parts = split(item, ':');
+        if (parts.size() < 2 || parts.size() > 3 || parts[0].empty()) {
+            if (emsg) *emsg = "expected name:dims[:type], got '" + item + "'";
+            return false;
+        }
+        TensorInfo t;
+        t.name = parts[0];
+        TensorDataType type = TensorDataType::FLOAT32;
+        if (parts.size() == 3 && !parseDataType(parts[2], type)) {
+            if (emsg) *emsg = "bad type '" + parts[2] + "' in '" + item + "'";
+            return false;
+        }
+        t.setDataType(type);
+        for (const auto& d : split(parts[1], 'x')) {
+            char* end = nullptr;
+            unsigned long v = std::strtoul(d.c_str(), &end, 10);
+            if (d.empty() || *end != '\0' || v == 0) {
+                if (emsg) *emsg = "bad dim '" + d + "' in '" + item + "'";
+                return false;
+            }
+            t.dims.push_back(v);
+        }
+        out.push_back(std::move(t));
+    }
+    return true;
+}
+
+bool CpuModelSpec::parse(const std::string& text, CpuModelSpec& out, std::string* emsg) {
+    CpuModelSpec spec;
+    for (const auto& kv : split(text, ';')) {
+        if (kv.empty()) continue;
+        size_t eq = kv.find('=');
+        if (eq == std::string::npos) {
+            if (emsg) *emsg = "expected key=value, got '" + kv + "'";
+            return false;
+        }
+        const std::string key = trim(kv.substr(0, eq));
+        const std::string val = trim(kv.substr(eq + 1));
+        if (key == "op") {
+            if (val == "copy") spec.op = Op::COPY;
+            else if (val == "add") spec.op = Op::ADD;
+            else if (val == "matmul") spec.op = Op::MATMUL;
+            else if (val == "conv3x3") spec.op = Op::CONV3X3;
+            else { if (emsg) *emsg = "unknown op '" + val + "'"; return false; }
+        } else if (key == "in") {
+            if (!parseTensors(val, spec.inputs, emsg)) return false;
+        } else if (key == "out") {
+            if (!parseTensors(val, spec.outputs, emsg)) return false;
+        } else if (key == "seed") {
+            spec.seed = static_cast<uint32_t>(std::strtoul(val.c_str(), nullptr, 10));
+        } else if (key == "delay_us") {
+            spec.delayUs = std::atoi(val.c_str());
+        } else if (key == "load_us") {
+            spec.loadUs = std::atoi(val.c_str());
+        } else if (key == "prepare_us") {
+            spec.prepareUs = std::atoi(val.c_str());
+        } else if (key == "spin") {
+            spec.spin = std::atoi(val.c_str()) != 0;
+        } else if (key == "layers") {
+            for (const auto& item : split(val, ',')) {
+                CpuModelSpec::Layer l;
+                std::string name = item;
+                const size_t colon = name.find(':');
+                if (colon != std::string::npos) {
+                    l.weight = std::atof(name.c_str() + colon + 1);
+                    name.resize(colon);
+                }
+                const size_t at = name.find('@');
+                l.runtime = at == std::string::npos ? "CPU_REF" : name.substr(at + 1);
+                l.name = name.substr(0, at);
+                if (l.name.empty() || l.runtime.empty() || !(l.weight > 0.0)) {
+                    if (emsg) *emsg = "bad layer '" + item + "', expected name[@runtime][:weight]";
+                    return false;
+                }
+                spec.layers.push_back(std::move(l));
+            }
+        } else if (key == "runtimes") {
+            for (const auto& item : split(val, ',')) {
+                const auto parts = split(item, ':');
+                CpuModelSpec::Runtime r;
+                if (parts.size() == 2) {
+                    r.name = trim(parts[0]);
+                    r.scale = std::atof(parts[1].c_str());
+                }
+                if (r.name.empty() || !(r.scale > 0.0)) {
+                    if (emsg) *emsg = "bad runtime '" + item + "', expected name:scale";
+                    return false;
+                }
+                spec.runtimes.push_back(std::move(r));
+            }
+        } else if (key == "quant") {
+            for (const auto& item : split(val, ',')) {
+                const auto parts = split(item, ':');
+                CpuModelSpec::Quant q;
+                char* end = nullptr;
+                if (parts.size() == 3) {
+                    q.tensor = parts[0];
+                    q.scale = std::strtof(parts[1].c_str(), &end);
+                    q.offset = static_cast<int32_t>(std::strtol(parts[2].c_str(), nullptr, 10));
+                }
+                if (q.tensor.empty() || !end || *end != '\0' || !(q.scale > 0.0f)) {
+                    if (emsg) *emsg = "bad quant '" + item + "', expected name:scale:offset";
+                    return false;
+                }
+                spec.quant.push_back(std::move(q));
+            }
+        } else {
+            if (emsg) *emsg = "unknown key '" + key + "'";
+            return false;
+        }
+    }
+    if (spec.inputs.empty() || spec.outputs.empty()) {
+        if (emsg) *emsg = "spec needs at least one 'in' and one 'out' tensor";
+        return false;
+    }
+    spec.resolveQuant();
+    spec.source = text;
+    out = std::move(spec);
+    return true;
+}
+
+void CpuModelSpec::resolveQuant() {
+    auto resolve = [this](TensorInfo& t) {
+        if (!isQuantized(t.dataType)) return;
+        for (const auto& q : quant) {
+            if (q.tensor != t.name) continue;
+            t.qScale = q.scale;
+            t.qOffset = q.offset;
+            return;
+        }
+        quantParamsForRange(0.0f, 1.0f, t.dataType, t.qScale, t.qOffset);
+    };
+    for (auto& t : inputs) resolve(t);
+    for (auto& t : outputs) resolve(t);
+}
+
+void CpuModelSpec::applyDataTypes(const DataTypeMap& types) {
+    if (types.empty()) return;
+    TensorDataType type;
+    for (auto& t : inputs) if (lookupDataType(types, t.name, type)) t.setDataType(type);
+    for (auto& t : outputs) if (lookupDataType(types, t.name, type)) t.setDataType(type);
+    resolveQuant();
+}
+
+static std::atomic<size_t> g_liveGraphs{0};
+static std::atomic<size_t> g_peakLiveGraphs{0};
+
+static void graphBuilt() {
+    const size_t n = g_liveGraphs.fetch_add(1) + 1;
+    size_t peak = g_peakLiveGraphs.load();
+    while (n > peak && !g_peakLiveGraphs.compare_exchange_weak(peak, n)) {}
+}
+
+size_t CpuReferenceBackend::liveGraphs() { return g_liveGraphs.load(); }
+size_t CpuReferenceBackend::peakLiveGraphs() { return g_peakLiveGraphs.load(); }
+void CpuReferenceBackend::resetPeakLiveGraphs() { g_peakLiveGraphs.store(g_liveGraphs.load()); }
+
+CpuReferenceBackend::CpuReferenceBackend(CpuModelSpec spec) : spec_(std::move(spec)) {}
+
+CpuReferenceBackend::~CpuReferenceBackend() {
+    if (built_) g_liveGraphs.fetch_sub(1);
+}
+
+static size_t elements(const TensorInfo& t) { return t.elements(); }
+
+bool CpuReferenceBackend::build(std::string* log) {
+    auto fail = [&](const std::string& m) {
+        LOGE_CR("build: %s", m.c_str());
+        if (log) *log += "CPU reference build failed: " + m + "\n";
+        return false;
+    };
+
+    if (spec_.inputs.empty() || spec_.outputs.empty()) return fail("no inputs or outputs");
+    if ((spec_.op == CpuModelSpec::Op::MATMUL || spec_.op == CpuModelSpec::Op::CONV3X3) &&
+        spec_.outputs.size() != 1) return fail("matmul/conv3x3 have exactly one output");
+
+    const TensorInfo& in0 = spec_.inputs[0];
+    const TensorInfo& out0 = spec_.outputs[0];
+    size_t fanIn = 0, fanOut = 0;
+    switch (spec_.op) {
+        case CpuModelSpec::Op::COPY:
+        case CpuModelSpec::Op::ADD:
+            break;
+        case CpuModelSpec::Op::MATMUL: {
+            if (in0.dims.empty() || out0.dims.empty()) return fail("matmul needs ranked tensors");
+            fanIn = in0.dims.back();
+            fanOut = out0.dims.back();
+            if (elements(in0) / fanIn != elements(out0) / fanOut)
+                return fail("matmul leading sizes differ between '" + in0.name + "' and '" + out0.name + "'");
+            break;
+        }
+        case CpuModelSpec::Op::CONV3X3: {
+            if (in0.dims.size() != 4 || out0.dims.size() != 4 || in0.dims[0] != 1 || out0.dims[0] != 1)
+                return fail("conv3x3 needs [1, C, H, W] tensors");
+            if (in0.dims[2] != out0.dims[2] || in0.dims[3] != out0.dims[3])
+                return fail("conv3x3 keeps H and W");
+            fanIn = in0.dims[1] * 9;
+            fanOut = out0.dims[1];
+            break;
+        }
+    }
+
+    // Uniform in +-1/sqrt(fanIn) from a fixed LCG: identical on every platform
+    uint32_t state = spec_.seed * 2654435761u + 1u;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) * (1.0f / 16777216.0f) - 0.5f;
+    };
+    const float scale = fanIn ? 2.0f / std::sqrt(static_cast<float>(fanIn)) : 0.f;
+    weights_.resize(fanIn * fanOut);
+    for (auto& w : weights_) w = next() * scale;
+    bias_.resize(fanOut);
+    for (auto& b : bias_) b = next() * 0.1f;
+
+    bool typed = false;
+    for (const auto& t : spec_.inputs) typed |= t.dataType != TensorDataType::FLOAT32;
+    for (const auto& t : spec_.outputs) typed |= t.dataType != TensorDataType::FLOAT32;
+    inFloat_.clear();
+    outFloat_.clear();
+    if (typed) {
+        for (const auto& t : spec_.inputs)
+            inFloat_.emplace_back(t.dataType == TensorDataType::FLOAT32 ? 0 : t.elements());
+        for (const auto& t : spec_.outputs)
+            outFloat_.emplace_back(t.dataType == TensorDataType::FLOAT32 ? 0 : t.elements());
+    }
+
+    if (!prepared_) prepare_();
+    if (spec_.loadUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(spec_.loadUs));
+    if (!built_) graphBuilt();
+    built_ = true;
+    return true;
+}
+
+bool CpuReferenceBackend::selectRuntime(const std::string& runtime, const std::string& profile) {
+    // Relative execute time under each profile's clock vote
+    static const std::pair<const char*, double> kProfileScale[] = {
+        {"BURST", 1.0}, {"SUSTAINED_HIGH_PERFORMANCE", 1.05}, {"HIGH_PERFORMANCE", 1.1},
+        {"DEFAULT", 1.35}, {"BALANCED", 1.35}, {"SYSTEM_SETTINGS", 1.35}, {"LOW_BALANCED", 1.6},
+        {"HIGH_POWER_SAVER", 1.9}, {"POWER_SAVER", 2.4}, {"LOW_POWER_SAVER", 3.0},
+        {"EXTREME_POWER_SAVER", 4.0},
+    };
+    double runtimeScale = runtime == "CPU_REF" ? 1.0 : 0.0;
+    for (const auto& r : spec_.runtimes)
+        if (r.name == runtime) runtimeScale = r.scale;
+    double profileScale = 0.0;
+    for (const auto& p : kProfileScale)
+        if (profile == p.first) profileScale = p.second;
+    if (runtimeScale == 0.0 || profileScale == 0.0) return false;
+
+    runtime_ = runtime;
+    profile_ = profile;
+    delayScale_ = runtimeScale * profileScale;
+    return true;
+}
+
+void CpuReferenceBackend::setInitCache(const std::string& dir, const std::string& model,
+                                       uint64_t maxBytes) {
+    cacheDir_ = dir;
+    cacheModel_ = model;
+    cacheMaxBytes_ = maxBytes;
+}
+
+void CpuReferenceBackend::prepare_() {
+    const bool persist = !cacheDir_.empty();
+    InitCacheKey key;
+    InitCacheStore store(cacheDir_, cacheMaxBytes_);
+    if (persist) {
+        key.model = cacheModel_;
+        key.dlcHash = InitCacheStore::hashBytes(spec_.source.data(), spec_.source.size());
+        key.libVersion = kLibVersion;
+        key.runtime = runtimeName();
+        key.socId = socIdentifier();
+        const std::string path = store.find(key);
+        if (!path.empty()) {
+            if (loadInitCache_(key, path)) {
+                prepared_ = preparedFromCache_ = true;
+                LOGI_CR("'%s' prepared from init cache %s", cacheModel_.c_str(), path.c_str());
+                return;
+            }
+            LOGI_CR("Init cache %s does not validate, evicting", path.c_str());
+            store.evict(key);
+        }
+    }
+
+    if (spec_.prepareUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(spec_.prepareUs));
+    prepared_ = true;
+
+    if (persist) {
+        store.store(key, [&](const std::string& path) {
+            std::ofstream ofs(path, std::ios::trunc);
+            ofs << kContainerMagic << "\nspec " << key.dlcHash << "\ncache " << key.runtime << ' '
+                << key.socId << '\n';
+            return bool(ofs.flush());
+        });
+    }
+}
+
+// Mirrors validateCache(): the container must be this model (by hash) and hold a
+// record for this runtime and SoC
+bool CpuReferenceBackend::loadInitCache_(const InitCacheKey& key, const std::string& path) const {
+    std::ifstream ifs(path);
+    std::string magic, spec, cache;
+    if (!std::getline(ifs, magic) || !std::getline(ifs, spec) || !std::getline(ifs, cache)) return false;
+    return magic == kContainerMagic && spec == "spec " + std::to_string(key.dlcHash) &&
+           cache == "cache " + key.runtime + " " + key.socId;
+}
+
+void CpuReferenceBackend::release() {
+    if (built_) g_liveGraphs.fetch_sub(1);
+    built_ = false;
+    weights_.clear();
+    weights_.shrink_to_fit();
+    bias_.clear();
+    bias_.shrink_to_fit();
+    inFloat_.clear();
+    outFloat_.clear();
+}
+
+bool CpuReferenceBackend::bind(const std::vector<const void*>& inputPtrs,
+                               const std::vector<void*>& outputPtrs) {
+    for (auto p : inputPtrs) if (!p) return false;
+    for (auto p : outputPtrs) if (!p) return false;
+    boundIn_ = inputPtrs;
+    boundOut_ = outputPtrs;
+    return true;
+}
+
+void CpuReferenceBackend::unbind() {
+    boundIn_.clear();
+    boundOut_.clear();
+}
+
+bool CpuReferenceBackend::executeBound() {
+    return run_(boundIn_, boundOut_);
+}
+
+bool CpuReferenceBackend::execute(const std::vector<const void*>& inputPtrs,
+                                  const std::vector<void*>& outputPtrs) {
+    for (auto p : inputPtrs) if (!p) return false;
+    for (auto p : outputPtrs) if (!p) return false;
+    return run_(inputPtrs, outputPtrs);
+}
+
+static const char* opName(CpuModelSpec::Op op) {
+    switch (op) {
+        case CpuModelSpec::Op::COPY: return "copy";
+        case CpuModelSpec::Op::ADD: return "add";
+        case CpuModelSpec::Op::MATMUL: return "matmul";
+        case CpuModelSpec::Op::CONV3X3: return "conv3x3";
+    }
+    return "op";
+}
+
+bool CpuReferenceBackend::lastLayerTimings(std::vector<LayerTiming>& out) const {
+    out.clear();
+    if (profiling_ == ProfilingLevel::OFF) return false;
+    if (profiling_ != ProfilingLevel::DETAILED) {
+        out.push_back({"(network)", runtimeName(), lastComputeNs_ + lastDelayNs_});
+        return true;
+    }
+    out.push_back({opName(spec_.op), runtimeName(), lastComputeNs_});
+    double total = 0.0;
+    for (const auto& l : spec_.layers) total += l.weight;
+    for (const auto& l : spec_.layers) {
+        out.push_back({l.name, l.runtime, uint64_t(double(lastDelayNs_) * l.weight / total)});
+    }
+    return true;
+}
+
+bool CpuReferenceBackend::run_(const std::vector<const void*>& in,
+                               const std::vector<void*>& out) {
+    if (!built_ || in.size() != spec_.inputs.size() || out.size() != spec_.outputs.size()) return false;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    if (inFloat_.empty() && outFloat_.empty()) {
+        compute_(in, out);
+    } else {
+        // Dequantize/widen the non-float inputs, compute, encode the outputs
+        inPtrs_.assign(in.begin(), in.end());
+        outPtrs_.assign(out.begin(), out.end());
+        for (size_t i = 0; i < in.size(); ++i) {
+            if (inFloat_[i].empty()) continue;
+            tensorToFloat(in[i], spec_.inputs[i], inFloat_[i].data(), inFloat_[i].size());
+            inPtrs_[i] = inFloat_[i].data();
+        }
+        for (size_t k = 0; k < out.size(); ++k) {
+            if (!outFloat_[k].empty()) outPtrs_[k] = outFloat_[k].data();
+        }
+        compute_(inPtrs_, outPtrs_);
+        for (size_t k = 0; k < out.size(); ++k) {
+            if (outFloat_[k].empty()) continue;
+            tensorFromFloat(outFloat_[k].data(), spec_.outputs[k], out[k], outFloat_[k].size());
+        }
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+    if (spec_.delayUs > 0) {
+        const auto until = t0 + std::chrono::microseconds(int64_t(spec_.delayUs * delayScale_));
+        if (spec_.spin) {
+            while (std::chrono::steady_clock::now() < until) {}
+        } else {
+            std::this_thread::sleep_until(until);
+        }
+    }
+    if (profiling_ != ProfilingLevel::OFF) {
+        using std::chrono::nanoseconds;
+        lastComputeNs_ = uint64_t(std::chrono::duration_cast<nanoseconds>(t1 - t0).count());
+        lastDelayNs_ = uint64_t(std::chrono::duration_cast<nanoseconds>(std::chrono::steady_clock::now() - t1).count());
+    }
+    return true;
+}
+
+void CpuReferenceBackend::compute_(const std::vector<const void*>& in,
+                                   const std::vector<void*>& out) {
+    const float* x = static_cast<const float*>(in[0]);
+    const size_t nx = elements(spec_.inputs[0]);
+
+    switch (spec_.op) {
+        case CpuModelSpec::Op::COPY:
+            for (size_t k = 0; k < out.size(); ++k) {
+                float* y = static_cast<float*>(out[k]);
+                const size_t ny = elements(spec_.outputs[k]);
+                for (size_t i = 0; i < ny; ++i) y[i] = x[i % nx];
+            }
+            break;
+        case CpuModelSpec::Op::ADD:
+            for (size_t k = 0; k < out.size(); ++k) {
+                float* y = static_cast<float*>(out[k]);
+                const size_t ny = elements(spec_.outputs[k]);
+                std::memset(y, 0, ny * sizeof(float));
+                for (size_t j = 0; j < in.size(); ++j) {
+                    const float* a = static_cast<const float*>(in[j]);
+                    const size_t na = elements(spec_.inputs[j]);
+                    for (size_t i = 0; i < ny; ++i) y[i] += a[i % na];
+                }
+            }
+            break;
+        case CpuModelSpec::Op::MATMUL: {
+            float* y = static_cast<float*>(out[0]);
+            const size_t K = spec_.inputs[0].dims.back();
+            const size_t N = spec_.outputs[0].dims.back();
+            const size_t M = nx / K;
+            for (size_t m = 0; m < M; ++m) {
+                float* row = y + m * N;
+                for (size_t n = 0; n < N; ++n) row[n] = bias_[n];
+                for (size_t k = 0; k < K; ++k) {
+                    const float a = x[m * K + k];
+                    const float* w = &weights_[k * N];
+                    for (size_t n = 0; n < N; ++n) row[n] += a * w[n];
+                }
+            }
+            break;
+        }
+        case CpuModelSpec::Op::CONV3X3: {
+            float* y = static_cast<float*>(out[0]);
+            const size_t C = spec_.inputs[0].dims[1];
+            const size_t F = spec_.outputs[0].dims[1];
+            const size_t H = spec_.inputs[0].dims[2], W = spec_.inputs[0].dims[3];
+            for (size_t f = 0; f < F; ++f) {
+                float* yf = y + f * H * W;
+                for (size_t i = 0; i < H * W; ++i) yf[i] = bias_[f];
+                for (size_t c = 0; c < C; ++c) {
+                    const float* xc = x + c * H * W;
+                    const float* w = &weights_[(f * C + c) * 9];
+                    for (size_t h = 0; h < H; ++h) {
+                        for (size_t v = 0; v < W; ++v) {
+                            float acc = 0.f;
+                            for (int dh = -1; dh <= 1; ++dh) {
+                                const long hh = static_cast<long>(h) + dh;
+                                if (hh < 0 || hh >= static_cast<long>(H)) continue;
+                                for (int dv = -1; dv <= 1; ++dv) {
+                                    const long vv = static_cast<long>(v) + dv;
+                                    if (vv < 0 || vv >= static_cast<long>(W)) continue;
+                                    acc += xc[hh * W + vv] * w[(dh + 1) * 3 + (dv + 1)];
+                                }
+                            }
+                            yf[h * W + v] += acc;
+                        }
+                    }
+                }
+            }
+            break;
+        }
+    }
+}
+#endif
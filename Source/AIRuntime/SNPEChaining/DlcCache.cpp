@@ -0,0 +1,171 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/DlcCache.hpp"
+#include "inc/hpp/Log.hpp"
+#include "inc/hpp/MMapFile.h"
+#if PLATFORM_ANDROID
+#include "inc/hpp/MMapAsset.hpp"
+#endif
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define  LOG_TAG_DC  "SNPE_DC"
+#define  LOGI_DC(...)  SNPE_LOG(SNPE_LOG_INFO,LOG_TAG_DC,__VA_ARGS__)
+
+namespace {
+struct FileMapping : DlcCache::Mapping {
+    MMapFile file;
+};
+#if PLATFORM_ANDROID
+struct AssetMapping : DlcCache::Mapping {
+    MMapAsset asset;
+};
+#endif
+
+// Page-aligned span covering [p, p + n)
+void pageSpan(const void* p, size_t n, uintptr_t& start, size_t& len) {
+    const uintptr_t page = uintptr_t(::sysconf(_SC_PAGESIZE));
+    const uintptr_t a = reinterpret_cast<uintptr_t>(p);
+    start = a & ~(page - 1);
+    len = (a + n) - start;
+}
+
+void adviseWillNeed(const DlcCache::Mapping& m) {
+    uintptr_t start;
+    size_t len;
+    pageSpan(m.data, m.size, start, len);
+    ::madvise(reinterpret_cast<void*>(start), len, MADV_WILLNEED);
+}
+} // namespace
+
+DlcCache& DlcCache::instance() {
+    static DlcCache cache;
+    return cache;
+}
+
+void DlcCache::setWillNeed(bool on) {
+    std::lock_guard<std::mutex> lk(mu_);
+    willNeed_ = on;
+}
+
+bool DlcCache::willNeed() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return willNeed_;
+}
+
+std::shared_ptr<DlcCache::Mapping> DlcCache::findLocked_(const std::string& key, const FileId& id) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return nullptr;
+    std::shared_ptr<Mapping> m = it->second.mapping.lock();
+    if (!m || !(it->second.id == id)) {
+        entries_.erase(it);   // unmapped, or the file changed since: map it again
+        return nullptr;
+    }
+    ++hits_;
+    return m;
+}
+
+void DlcCache::insertLocked_(const std::shared_ptr<Mapping>& m, const FileId& id) {
+    ++misses_;
+    if (willNeed_) adviseWillNeed(*m);
+    // Drop the entries whose mappings are gone
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.mapping.expired()) it = entries_.erase(it);
+        else ++it;
+    }
+    entries_[m->key] = Entry{m, id};
+    LOGI_DC("Mapped %s (%zu bytes)", m->key.c_str(), m->size);
+}
+
+std::shared_ptr<DlcCache::Mapping> DlcCache::mapFile(const std::string& path, std::string* emsg) {
+    char resolved[PATH_MAX];
+    if (!::realpath(path.c_str(), resolved)) {
+        if (emsg) *emsg = "realpath('" + path + "') failed: " + std::strerror(errno);
+        return nullptr;
+    }
+    struct stat st{};
+    if (::stat(resolved, &st) != 0) {
+        if (emsg) *emsg = std::string("stat('") + resolved + "') failed: " + std::strerror(errno);
+        return nullptr;
+    }
+    FileId id;
+    id.dev = uint64_t(st.st_dev);
+    id.ino = uint64_t(st.st_ino);
+    id.size = uint64_t(st.st_size);
+#ifdef __APPLE__
+    id.mtimeNs = int64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    id.mtimeNs = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+
+    std::lock_guard<std::mutex> lk(mu_);
+    if (auto m = findLocked_(resolved, id)) return m;
+
+    auto m = std::make_shared<FileMapping>();
+    if (!m->file.openPath(resolved, emsg)) return nullptr;
+    m->data = static_cast<const uint8_t*>(m->file.ptr);
+    m->size = m->file.size;
+    m->key = resolved;
+    insertLocked_(m, id);
+    return m;
+}
+
+#if PLATFORM_ANDROID
+std::shared_ptr<DlcCache::Mapping> DlcCache::mapAsset(AAssetManager* mgr, const std::string& name,
+                                                      std::string* emsg) {
+    const std::string key = "asset:" + name;   // the APK does not change while we run
+    std::lock_guard<std::mutex> lk(mu_);
+    if (auto m = findLocked_(key, FileId{})) return m;
+
+    auto m = std::make_shared<AssetMapping>();
+    if (!m->asset.openUncompressed(mgr, name.c_str(), emsg)) return nullptr;
+    m->data = static_cast<const uint8_t*>(m->asset.ptr);
+    m->size = m->asset.size;
+    m->key = key;
+    insertLocked_(m, FileId{});
+    return m;
+}
+#endif
+
+DlcCache::Stats DlcCache::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    Stats s;
+    s.hits = hits_;
+    s.misses = misses_;
+    for (const auto& e : entries_) {
+        if (auto m = e.second.mapping.lock()) {
+            ++s.mappings;
+            s.mappedBytes += m->size;
+        }
+    }
+    return s;
+}
+
+uint64_t DlcCache::residentBytes() const {
+    std::vector<std::shared_ptr<Mapping>> live;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        for (const auto& e : entries_)
+            if (auto m = e.second.mapping.lock()) live.push_back(std::move(m));
+    }
+    const size_t page = size_t(::sysconf(_SC_PAGESIZE));
+    uint64_t total = 0;
+    std::vector<unsigned char> vec;
+    for (const auto& m : live) {
+        uintptr_t start;
+        size_t len;
+        pageSpan(m->data, m->size, start, len);
+        vec.resize((len + page - 1) / page);
+        if (::mincore(reinterpret_cast<void*>(start), len, vec.data()) != 0) continue;
+        for (unsigned char v : vec) total += (v & 1) ? page : 0;
+    }
+    return total;
+}
+#endif
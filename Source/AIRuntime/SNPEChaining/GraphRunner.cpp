@@ -1,14 +1,59 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 //
 // Created by Chiheb Boussema on 16/9/25.
 //
 #include "inc/hpp/GraphRunner.hpp"
-#include <android/log.h>
+#include "inc/hpp/Log.hpp"
+#include "inc/hpp/Trace.hpp"
 #include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 #define  LOG_TAG_GR  "SNPE_GR"
-#define  LOGI_GR(...)  __android_log_print(ANDROID_LOG_INFO,LOG_TAG_GR,__VA_ARGS__)
-#define  LOGE_GR(...)  __android_log_print(ANDROID_LOG_ERROR,LOG_TAG_GR,__VA_ARGS__)
+#define  LOGI_GR(...)  SNPE_LOG(SNPE_LOG_INFO,LOG_TAG_GR,__VA_ARGS__)
+#define  LOGE_GR(...)  SNPE_LOG(SNPE_LOG_ERROR,LOG_TAG_GR,__VA_ARGS__)
+
+struct GraphRunner::Pipeline {
+    struct Stage {
+        const ExecutionPlan::Step* step = nullptr;
+        std::vector<std::vector<const void*>> inPtrs;   // [slot] in session->inputs() order
+        std::vector<std::vector<void*>> outPtrs;        // [slot]
+        std::deque<size_t> queue;                       // slots waiting for this stage
+        std::mutex mu;
+        std::condition_variable cv;
+        std::thread thread;
+    };
+
+    std::shared_ptr<const ExecutionPlan> plan;
+    std::vector<std::unique_ptr<Stage>> stages;
+    std::vector<std::vector<ExecInfo>> infos;           // [slot][node]
+    std::vector<uint64_t> seq;                          // [slot]
+    std::vector<std::vector<TensorWorkspace::TensorId>> slotIds; // [slot][base id]
+    std::vector<std::string> copies;                    // "<owner>@k" names to release
+    FrameDone onDone;
+
+    std::mutex freeMu;
+    std::condition_variable freeCv;
+    std::deque<size_t> freeSlots;
+    size_t inFlight = 0;
+    uint64_t nextSeq = 0;
+    std::atomic<bool> stop{false};
+};
+
+GraphRunner::GraphRunner(TensorWorkspace& ws) : ws_(ws) {}
+
+GraphRunner::~GraphRunner() {
+    stopPipeline();
+    residency_.reset();
+}
+
+SessionResidency::Stats GraphRunner::residencyStats() const {
+    return residency_ ? residency_->stats() : SessionResidency::Stats{};
+}
 
 GraphRunner::Node& GraphRunner::getNode(std::string name) {
     for (auto& node : this->nodes_) {
@@ -17,7 +62,25 @@ GraphRunner::Node& GraphRunner::getNode(std::string name) {
     throw std::runtime_error("Node not found: " + name);
 }
 
+std::vector<GraphRunner::NodeLatency> GraphRunner::nodeLatency() const {
+    std::vector<NodeLatency> out;
+    out.reserve(nodes_.size());
+    for (auto& n : nodes_) {
+        if (!n.session) continue;
+        out.push_back({n.name, n.session->bindLatency().stats(), n.session->executeLatency().stats()});
+    }
+    return out;
+}
+
+void GraphRunner::resetLatency() {
+    for (auto& n : nodes_) {
+        if (n.session) n.session->resetLatency();
+    }
+}
+
 bool GraphRunner::addNode(Node node, bool strictZeroCopy) {
+    node.inputIds.clear();
+    node.outputIds.clear();
     // Sanity: every bound IO has a workspace block and size that matches the model metadata
     for (auto& t : node.session->inputs()) {
         auto it = node.inputBinding.find(t.name);
@@ -36,6 +99,8 @@ bool GraphRunner::addNode(Node node, bool strictZeroCopy) {
                     node.name.c_str(), wsName.c_str(), sz, t.name.c_str(), t.bytes());
             return false;
         }
+        if (!encodingMatches_(node.name, t, wsName)) return false;
+        node.inputIds.push_back(ws_.find(wsName));
     }
     for (auto& t : node.session->outputs()) {
         auto it = node.outputBinding.find(t.name);
@@ -54,72 +119,528 @@ bool GraphRunner::addNode(Node node, bool strictZeroCopy) {
                     node.name.c_str(), wsName.c_str(), sz, t.name.c_str(), t.bytes());
             return false;
         }
+        if (!encodingMatches_(node.name, t, wsName)) return false;
+        node.outputIds.push_back(ws_.find(wsName));
     }
+    ExecInfo info;
+    info.name = node.name;
+    info.runtime = node.session->selectedRuntimeName();
+    lastRun_.push_back(std::move(info));
     nodes_.push_back(std::move(node));
+    plan_.reset(); // new node still needs its buffers bound
     return true;
 }
 
-std::vector<GraphRunner::ExecInfo> GraphRunner::runAll(bool reset_session) {
-    std::vector<ExecInfo> out;
-    out.reserve(nodes_.size());
-    for (auto& n : nodes_) {
-        // Build pointer maps
-        std::unordered_map<std::string, const void*> inPtrs;
-        std::unordered_map<std::string, void*> outPtrs;
-
-        // check if node session needs rebuilding
-        if (!n.session.get()->getSnpe()) {
-            n.session.get()->reCreate(nullptr);
-        }
-
-        for (auto& t : n.session->inputs()) {
-            const auto& wsName = n.inputBinding.at(t.name);
-            inPtrs[t.name] = ws_.data(wsName);
-        }
-        for (auto& t : n.session->outputs()) {
-            const auto& wsName = n.outputBinding.at(t.name);
-            outPtrs[t.name] = ws_.data(wsName);
-        }
-
-        int64_t ms = 0;
-        bool ok = n.session->execute(inPtrs, outPtrs, &ms);
-        ExecInfo e;
-        e.name = n.name;
-        e.runtime = n.session->selectedRuntimeName();
-        e.ms = ms;
-        e.ok = ok;
-        LOGI_GR("[%s] runtime=%s  time=%lld ms  status=%s",
-                e.name.c_str(), e.runtime.c_str(), (long long)e.ms, ok ? "OK" : "FAIL");
-
-        // 🔎 Log first 8 values of each output tensor
-        if (ok) {
-            for (const auto& t : n.session->outputs()) {
-                const auto& wsName = n.outputBinding.at(t.name);
-                void* ptr = ws_.data(wsName);
-                size_t nbytes = ws_.sizeOf(wsName);
-                size_t nfloat = nbytes / sizeof(float);
-
-                const float* f = static_cast<const float*>(ptr);
-                std::string vals;
-                size_t count = std::min<size_t>(8, nfloat);
-                for (size_t i = 0; i < count; ++i) {
-                    vals += std::to_string(f[i]);
-                    if (i + 1 < count) vals += ", ";
+const TensorInfo* GraphRunner::tensorInfo(TensorWorkspace::TensorId id) const {
+    if (id == TensorWorkspace::kInvalidTensor) return nullptr;
+    const std::string owner = ws_.ownerName(ws_.nameOf(id));
+    auto same = [&](TensorWorkspace::TensorId other) {
+        return other == id || (!owner.empty() && ws_.ownerName(ws_.nameOf(other)) == owner);
+    };
+    for (const auto& n : nodes_) {
+        for (size_t k = 0; k < n.inputIds.size(); ++k) {
+            if (same(n.inputIds[k])) return &n.session->inputs()[k];
+        }
+        for (size_t k = 0; k < n.outputIds.size(); ++k) {
+            if (same(n.outputIds[k])) return &n.session->outputs()[k];
+        }
+    }
+    return nullptr;
+}
+
+bool GraphRunner::encodingMatches_(const std::string& nodeName, const TensorInfo& t,
+                                   const std::string& wsName) const {
+    // Tensors pass between models as raw bytes: every model bound to a block must
+    // read/write the same encoding (type, and scale/offset when quantized)
+    const std::string owner = ws_.ownerName(wsName);
+    auto check = [&](const Node& n, const std::vector<TensorInfo>& infos,
+                     const std::vector<TensorWorkspace::TensorId>& ids) {
+        for (size_t k = 0; k < ids.size() && k < infos.size(); ++k) {
+            const TensorInfo& o = infos[k];
+            if (o.sameEncoding(t) || ws_.ownerName(ws_.nameOf(ids[k])) != owner) continue;
+            LOGE_GR("[%s] Encoding mismatch on '%s': '%s' is %s (scale=%g offset=%d) but %s.%s is %s "
+                    "(scale=%g offset=%d)", nodeName.c_str(), wsName.c_str(), t.name.c_str(),
+                    dataTypeName(t.dataType), t.qScale, int(t.qOffset), n.name.c_str(), o.name.c_str(),
+                    dataTypeName(o.dataType), o.qScale, int(o.qOffset));
+            return false;
+        }
+        return true;
+    };
+    for (const auto& n : nodes_) {
+        if (!check(n, n.session->inputs(), n.inputIds) || !check(n, n.session->outputs(), n.outputIds))
+            return false;
+    }
+    return true;
+}
+
+bool GraphRunner::planMemory(MemoryPlan& out, size_t alignment, std::string* emsg) const {
+    std::vector<MemoryPlanner::Step> steps;
+    std::unordered_map<std::string, size_t> bytes;
+    steps.reserve(nodes_.size());
+
+    auto resolve = [&](const std::string& wsName, std::vector<std::string>& dst) -> bool {
+        std::string owner = ws_.ownerName(wsName);
+        if (owner.empty()) {
+            if (emsg) *emsg = "Workspace tensor '" + wsName + "' not found";
+            return false;
+        }
+        bytes[owner] = ws_.sizeOf(owner);
+        dst.push_back(std::move(owner));
+        return true;
+    };
+
+    for (const auto& n : nodes_) {
+        MemoryPlanner::Step st;
+        for (const auto& t : n.session->inputs()) {
+            if (!resolve(n.inputBinding.at(t.name), st.reads)) return false;
+        }
+        for (const auto& t : n.session->outputs()) {
+            if (!resolve(n.outputBinding.at(t.name), st.writes)) return false;
+        }
+        steps.push_back(std::move(st));
+    }
+
+    if (!MemoryPlanner::plan(steps, bytes, alignment, out, emsg)) return false;
+    LOGI_GR("Memory plan: %zu tensors, peak=%zu bytes, naive=%zu bytes",
+            out.slots.size(), out.arenaBytes, out.naiveBytes);
+    return true;
+}
+
+std::shared_ptr<const ExecutionPlan> GraphRunner::compile(bool reset_session, std::string* emsg) {
+    SNPE_TRACE_SCOPE("graph", "compile");
+    auto fail = [&](const std::string& m) -> std::shared_ptr<const ExecutionPlan> {
+        LOGE_GR("compile: %s", m.c_str());
+        if (emsg) *emsg = m;
+        return nullptr;
+    };
+
+    // The previous plan's prefetcher must not rebuild while we bind
+    residency_.reset();
+
+    auto plan = std::make_shared<ExecutionPlan>();
+    plan->steps.reserve(nodes_.size());
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        Node& n = nodes_[i];
+        if (!n.session) return fail("[" + n.name + "] session was cleared");
+
+        // check if node session needs rebuilding (reset_session: done per step)
+        if (!reset_session && !n.session->ready()) {
+            n.session->reCreate(nullptr);
+            if (!n.session->ready()) return fail("[" + n.name + "] session rebuild failed");
+            lastRun_[i].runtime = n.session->selectedRuntimeName();
+        }
+
+        ExecutionPlan::Step st;
+        st.node = i;
+        st.session = n.session.get();
+        for (auto id : n.inputIds) {
+            if (!ws_.data(id)) return fail("[" + n.name + "] workspace tensor '" + ws_.nameOf(id) + "' was released");
+            st.inputs.push_back(ws_.data(id));
+        }
+        for (auto id : n.outputIds) {
+            if (!ws_.data(id)) return fail("[" + n.name + "] workspace tensor '" + ws_.nameOf(id) + "' was released");
+            st.outputs.push_back(ws_.data(id));
+        }
+        // User buffers are created once; an unchanged pointer is a no-op, a moved one is retargeted
+        if (!n.session->bind(st.inputs, st.outputs)) return fail("[" + n.name + "] failed to bind user buffers");
+
+        st.rebuildBeforeRun = reset_session;
+        st.resetAfterRun = reset_session;
+        st.logOutputs = logOutputsEnabled_;
+        plan->steps.push_back(std::move(st));
+    }
+    if (!buildDag_(*plan, emsg)) return nullptr;
+    plan->wsGeneration = ws_.generation();
+
+    if (reset_session) {
+        std::vector<std::pair<size_t, ModelSession*>> order;
+        for (const auto& st : plan->steps) order.emplace_back(st.node, st.session);
+        residency_.reset(new SessionResidency(std::move(order), maxResident_));
+    }
+    return plan;
+}
+
+bool GraphRunner::buildDag_(ExecutionPlan& plan, std::string* emsg) const {
+    const size_t n = plan.steps.size();
+    struct Range { const uint8_t* p; size_t bytes; };
+    std::vector<std::vector<Range>> reads(n), writes(n);
+    std::unordered_map<std::string, std::vector<size_t>> producers; // owner tensor -> nodes, insertion order
+    std::vector<std::vector<std::string>> readOwners(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        const Node& node = nodes_[plan.steps[i].node];
+        for (size_t k = 0; k < node.inputIds.size(); ++k) {
+            auto id = node.inputIds[k];
+            reads[i].push_back({static_cast<const uint8_t*>(plan.steps[i].inputs[k]), ws_.sizeOf(id)});
+            readOwners[i].push_back(ws_.ownerName(ws_.nameOf(id)));
+        }
+        for (size_t k = 0; k < node.outputIds.size(); ++k) {
+            auto id = node.outputIds[k];
+            writes[i].push_back({static_cast<const uint8_t*>(plan.steps[i].outputs[k]), ws_.sizeOf(id)});
+            producers[ws_.ownerName(ws_.nameOf(id))].push_back(i);
+        }
+    }
+
+    // 1) Data edges by tensor name, keeping insertion order between a reader and each
+    //    writer of what it reads: an earlier producer -> consumer (read-after-write),
+    //    a later one waits for the consumer (write-after-read: state carried to the
+    //    next frame is read before it is overwritten). Several producers of one
+    //    tensor run in insertion order.
+    std::vector<std::vector<bool>> adj(n, std::vector<bool>(n, false));
+    for (auto& kv : producers) {
+        auto& ps = kv.second;
+        ps.erase(std::unique(ps.begin(), ps.end()), ps.end());
+        for (size_t k = 1; k < ps.size(); ++k) adj[ps[k - 1]][ps[k]] = true;
+    }
+    for (size_t j = 0; j < n; ++j) {
+        for (const auto& owner : readOwners[j]) {
+            auto it = producers.find(owner);
+            if (it == producers.end()) continue; // seeded by the app
+            for (size_t p : it->second) {
+                if (p < j) adj[p][j] = true;
+                else if (p > j) adj[j][p] = true;
+            }
+        }
+    }
+
+    // 2) Topological order (Kahn), ties broken by insertion order
+    std::vector<uint32_t> indeg(n, 0);
+    for (size_t a = 0; a < n; ++a)
+        for (size_t b = 0; b < n; ++b) if (adj[a][b]) ++indeg[b];
+    std::vector<size_t> order;
+    std::vector<bool> done(n, false);
+    order.reserve(n);
+    while (order.size() < n) {
+        size_t pick = n;
+        for (size_t i = 0; i < n; ++i) if (!done[i] && indeg[i] == 0) { pick = i; break; }
+        if (pick == n) {
+            std::string m = "dependency cycle between nodes:";
+            for (size_t i = 0; i < n; ++i) if (!done[i]) m += " " + nodes_[plan.steps[i].node].name;
+            LOGE_GR("compile: %s", m.c_str());
+            if (emsg) *emsg = m;
+            return false;
+        }
+        done[pick] = true;
+        order.push_back(pick);
+        for (size_t b = 0; b < n; ++b) if (adj[pick][b]) --indeg[b];
+    }
+
+    // 3) Hazard edges along that order: any two nodes whose buffers overlap
+    //    (aliases, blocks shared by the memory plan) keep their relative order
+    //    unless both only read.
+    auto overlap = [](const std::vector<Range>& x, const std::vector<Range>& y) {
+        for (const auto& r : x)
+            for (const auto& q : y)
+                if (r.p < q.p + q.bytes && q.p < r.p + r.bytes) return true;
+        return false;
+    };
+    for (size_t x = 0; x < n; ++x) {
+        for (size_t y = x + 1; y < n; ++y) {
+            size_t a = order[x], b = order[y];
+            if (overlap(writes[a], reads[b]) || overlap(writes[a], writes[b]) || overlap(reads[a], writes[b]))
+                adj[a][b] = true;
+        }
+    }
+
+    // 4) Reorder steps and emit successor lists in plan indices
+    std::vector<uint32_t> pos(n);
+    for (size_t x = 0; x < n; ++x) pos[order[x]] = static_cast<uint32_t>(x);
+    std::vector<ExecutionPlan::Step> sorted;
+    sorted.reserve(n);
+    for (size_t x = 0; x < n; ++x) sorted.push_back(std::move(plan.steps[order[x]]));
+    size_t edges = 0;
+    for (size_t a = 0; a < n; ++a) {
+        for (size_t b = 0; b < n; ++b) {
+            if (!adj[a][b]) continue;
+            sorted[pos[a]].successors.push_back(pos[b]);
+            ++sorted[pos[b]].numDeps;
+            ++edges;
+        }
+    }
+    plan.steps = std::move(sorted);
+
+    // Width: most steps sharing a depth level (longest path from a root)
+    std::vector<size_t> level(n, 0), perLevel(n + 1, 0);
+    plan.maxWidth = n ? 1 : 0;
+    for (size_t x = 0; x < n; ++x) {
+        plan.maxWidth = std::max(plan.maxWidth, ++perLevel[level[x]]);
+        for (auto s : plan.steps[x].successors) level[s] = std::max(level[s], level[x] + 1);
+    }
+    LOGI_GR("Execution DAG: %zu nodes, %zu edges, max width %zu", n, edges, plan.maxWidth);
+    return true;
+}
+
+TensorWorkspace::TensorId GraphRunner::slotTensor(size_t slot, TensorWorkspace::TensorId id) const {
+    if (!pipeline_ || slot == 0) return id;
+    const auto& ids = pipeline_->slotIds[slot];
+    return id < ids.size() && ids[id] != TensorWorkspace::kInvalidTensor ? ids[id] : id;
+}
+
+bool GraphRunner::startPipeline(size_t inFlight, FrameDone onDone, std::string* emsg) {
+    std::unique_ptr<Pipeline> p;
+    // Every failure after step 1 began must drop the slot copies made so far
+    auto releaseCopies = [&] {
+        if (p) for (const auto& c : p->copies) ws_.release(c);
+    };
+    auto fail = [&](const std::string& m) {
+        releaseCopies();
+        LOGE_GR("startPipeline: %s", m.c_str());
+        if (emsg) *emsg = m;
+        return false;
+    };
+    if (pipeline_) return fail("already running");
+    if (nodes_.empty()) return fail("no nodes");
+    if (inFlight == 0) inFlight = 1;
+
+    p.reset(new Pipeline());
+    p->onDone = std::move(onDone);
+
+    // 1) Versioned copies of every tensor a node touches (owners only; aliases follow)
+    p->slotIds.resize(inFlight);
+    std::vector<TensorWorkspace::TensorId> touched;
+    for (const auto& n : nodes_) {
+        touched.insert(touched.end(), n.inputIds.begin(), n.inputIds.end());
+        touched.insert(touched.end(), n.outputIds.begin(), n.outputIds.end());
+    }
+    for (size_t k = 1; k < inFlight; ++k) {
+        auto& ids = p->slotIds[k];
+        for (auto id : touched) {
+            if (id >= ids.size()) ids.resize(id + 1, TensorWorkspace::kInvalidTensor);
+            if (ids[id] != TensorWorkspace::kInvalidTensor) continue;
+            const std::string owner = ws_.ownerName(ws_.nameOf(id));
+            const std::string copy = owner + "@" + std::to_string(k);
+            if (!ws_.has(copy)) {
+                void* dst = ws_.allocate(copy, ws_.sizeOf(owner));
+                if (!dst) return fail("cannot allocate '" + copy + "'");
+                std::memcpy(dst, ws_.data(owner), ws_.sizeOf(owner));
+                p->copies.push_back(copy);
+            }
+            ids[id] = ws_.find(copy);
+        }
+    }
+
+    // 2) Plan (binds slot 0) and per-slot pointer sets for every stage
+    p->plan = compile(false, emsg);
+    if (!p->plan) {
+        releaseCopies();
+        return false;
+    }
+    p->infos.assign(inFlight, lastRun_);
+    p->seq.assign(inFlight, 0);
+    for (const auto& st : p->plan->steps) {
+        auto stage = std::unique_ptr<Pipeline::Stage>(new Pipeline::Stage());
+        stage->step = &st;
+        const Node& n = nodes_[st.node];
+        stage->inPtrs.resize(inFlight);
+        stage->outPtrs.resize(inFlight);
+        for (size_t k = 0; k < inFlight; ++k) {
+            for (auto id : n.inputIds) stage->inPtrs[k].push_back(ws_.data(k ? p->slotIds[k][id] : id));
+            for (auto id : n.outputIds) stage->outPtrs[k].push_back(ws_.data(k ? p->slotIds[k][id] : id));
+        }
+        p->stages.push_back(std::move(stage));
+    }
+    for (size_t k = 0; k < inFlight; ++k) p->freeSlots.push_back(k);
+
+    // 3) One thread per stage; a slot moves down the stages in FIFO order
+    pipeline_ = std::move(p);
+    Pipeline* pl = pipeline_.get();
+    for (size_t i = 0; i < pl->stages.size(); ++i) {
+        pl->stages[i]->thread = std::thread([this, pl, i] {
+            Pipeline::Stage& stage = *pl->stages[i];
+            traceSetThreadName(("pipe:" + nodes_[stage.step->node].name).c_str());
+            for (;;) {
+                size_t slot;
+                {
+                    std::unique_lock<std::mutex> lk(stage.mu);
+                    stage.cv.wait(lk, [&] { return pl->stop || !stage.queue.empty(); });
+                    if (stage.queue.empty()) return;
+                    slot = stage.queue.front();
+                    stage.queue.pop_front();
                 }
-                LOGI_GR("   Output '%s' (workspace='%s', %zu floats): [%s%s]",
-                        t.name.c_str(), wsName.c_str(), nfloat,
-                        vals.c_str(), (nfloat > count ? ", ..." : ""));
+                const auto& st = *stage.step;
+                ExecInfo& e = pl->infos[slot][st.node];
+                SNPE_TRACE_SCOPE_ARG("pipeline", "frame", "seq", pl->seq[slot]);
+                // Retarget the bound buffers to this slot (setBufferAddress, no allocation)
+                if (st.session->bind(stage.inPtrs[slot], stage.outPtrs[slot])) {
+                    runStep_(st, e);
+                } else {
+                    e.ms = 0;
+                    e.ns = 0;
+                    e.ok = false;
+                }
+
+                if (i + 1 < pl->stages.size()) {
+                    Pipeline::Stage& next = *pl->stages[i + 1];
+                    {
+                        std::lock_guard<std::mutex> lk(next.mu);
+                        next.queue.push_back(slot);
+                    }
+                    next.cv.notify_one();
+                    continue;
+                }
+
+                // Last stage: FIFO queues keep frames in submit order
+                if (pl->onDone) pl->onDone(pl->seq[slot], slot, pl->infos[slot]);
+                {
+                    std::lock_guard<std::mutex> lk(pl->freeMu);
+                    --pl->inFlight;
+                    pl->freeSlots.push_back(slot);
+                }
+                pl->freeCv.notify_all();
             }
+        });
+    }
+    LOGI_GR("Pipeline started: %zu stages, %zu frames in flight", pl->stages.size(), inFlight);
+    return true;
+}
+
+uint64_t GraphRunner::submitFrame(const std::function<void(size_t slot)>& fill) {
+    SNPE_TRACE_SCOPE("pipeline", "submitFrame");
+    Pipeline* pl = pipeline_.get();
+    if (!pl) {
+        LOGE_GR("submitFrame() without startPipeline()");
+        return ~uint64_t(0);
+    }
+    size_t slot;
+    uint64_t seq;
+    {
+        std::unique_lock<std::mutex> lk(pl->freeMu);
+        pl->freeCv.wait(lk, [&] { return !pl->freeSlots.empty(); });
+        slot = pl->freeSlots.front();
+        pl->freeSlots.pop_front();
+        seq = pl->nextSeq++;
+        ++pl->inFlight;
+    }
+    if (fill) fill(slot);
+    pl->seq[slot] = seq;
+
+    Pipeline::Stage& first = *pl->stages.front();
+    {
+        std::lock_guard<std::mutex> lk(first.mu);
+        first.queue.push_back(slot);
+    }
+    first.cv.notify_one();
+    return seq;
+}
+
+void GraphRunner::drainPipeline() {
+    Pipeline* pl = pipeline_.get();
+    if (!pl) return;
+    std::unique_lock<std::mutex> lk(pl->freeMu);
+    pl->freeCv.wait(lk, [&] { return pl->inFlight == 0; });
+}
+
+void GraphRunner::stopPipeline() {
+    if (!pipeline_) return;
+    drainPipeline();
+    Pipeline* pl = pipeline_.get();
+    pl->stop = true;
+    for (auto& st : pl->stages) {
+        { std::lock_guard<std::mutex> lk(st->mu); }
+        st->cv.notify_all();
+    }
+    for (auto& st : pl->stages) st->thread.join();
+    for (const auto& c : pl->copies) ws_.release(c);
+    pipeline_.reset();
+    plan_.reset(); // sessions are bound to some slot; rebind on the next runAll()
+    LOGI_GR("Pipeline stopped");
+}
+
+void GraphRunner::setParallelism(size_t threads) {
+    if (threads <= 1) pool_.reset();
+    else if (!pool_ || pool_->size() != threads) pool_.reset(new WorkerPool(threads));
+}
+
+void GraphRunner::logOutputs_(const Node& n) const {
+    // 🔎 Log first 8 values of each output tensor
+    const auto& outs = n.session->outputs();
+    for (size_t k = 0; k < outs.size(); ++k) {
+        const auto id = n.outputIds[k];
+        size_t nfloat = ws_.sizeOf(id) / sizeof(float);
+
+        const float* f = static_cast<const float*>(ws_.data(id));
+        std::string vals;
+        size_t count = std::min<size_t>(8, nfloat);
+        for (size_t i = 0; i < count; ++i) {
+            vals += std::to_string(f[i]);
+            if (i + 1 < count) vals += ", ";
         }
+        LOGI_GR("   Output '%s' (workspace='%s', %zu floats): [%s%s]",
+                outs[k].name.c_str(), ws_.nameOf(id).c_str(), nfloat,
+                vals.c_str(), (nfloat > count ? ", ..." : ""));
+    }
+}
 
-        out.push_back(e);
+void GraphRunner::runStep_(const ExecutionPlan::Step& st, ExecInfo& e) {
+    SNPE_TRACE_SCOPE("node", e.name.c_str());
+    e.ms = 0;
+    e.ns = 0;
+    if (st.rebuildBeforeRun && !residency_->acquire(st.node)) {
+        e.ok = false;
+        LOGE_GR("[%s] session rebuild failed", e.name.c_str());
+        return;
+    }
+    e.ok = st.session->executeBound(&e.ms, &e.ns);
+    // Per-node lines only on failure or with output logging on: this runs every frame
+    if (!e.ok) {
+        LOGE_GR("[%s] runtime=%s  time=%lld ms  status=FAIL",
+                e.name.c_str(), e.runtime.c_str(), (long long)e.ms);
+    } else if (st.logOutputs) {
+        LOGI_GR("[%s] runtime=%s  time=%lld ms  status=OK",
+                e.name.c_str(), e.runtime.c_str(), (long long)e.ms);
+        logOutputs_(nodes_[st.node]);
+    }
+
+    if (st.resetAfterRun) residency_->release(st.node);
+}
 
-        if (reset_session) {
-            LOGI_GR("[Execution] Resetting session for node %s", n.name.c_str());
-            n.session.get()->reset();
-//            usleep(20*1000);
+void GraphRunner::runParallelStep_(uint32_t idx) {
+    const auto& st = running_->steps[idx];
+    runStep_(st, lastRun_[st.node]);
+    for (auto s : st.successors) {
+        if (pendingDeps_[s].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pool_->submit([this, s] { runParallelStep_(s); });
         }
     }
-    return out;
+}
+
+const std::vector<GraphRunner::ExecInfo>& GraphRunner::run(const ExecutionPlan& plan) {
+    SNPE_TRACE_SCOPE("graph", "run");
+    if (!pool_ || plan.maxWidth < 2) {
+        for (const auto& st : plan.steps) runStep_(st, lastRun_[st.node]);
+        return lastRun_;
+    }
+
+    const size_t n = plan.steps.size();
+    if (pendingCap_ < n) {
+        pendingDeps_.reset(new std::atomic<uint32_t>[n]);
+        pendingCap_ = n;
+    }
+    for (size_t i = 0; i < n; ++i) pendingDeps_[i].store(plan.steps[i].numDeps, std::memory_order_relaxed);
+    running_ = &plan;
+    for (uint32_t i = 0; i < n; ++i) {
+        if (plan.steps[i].numDeps == 0) pool_->submit([this, i] { runParallelStep_(i); });
+    }
+    pool_->wait();
+    running_ = nullptr;
+    return lastRun_;
+}
+
+const std::vector<GraphRunner::ExecInfo>& GraphRunner::runAll(bool reset_session) {
+    SNPE_TRACE_SCOPE("graph", "runAll");
+    if (pipeline_) {
+        LOGE_GR("runAll() while the pipeline is running; use submitFrame()");
+        for (auto& e : lastRun_) { e.ms = 0; e.ns = 0; e.ok = false; }
+        return lastRun_;
+    }
+    if (!plan_ || plan_->wsGeneration != ws_.generation() || planReset_ != reset_session) {
+        plan_ = compile(reset_session);
+        planReset_ = reset_session;
+        if (!plan_) {
+            for (auto& e : lastRun_) { e.ms = 0; e.ns = 0; e.ok = false; }
+            return lastRun_;
+        }
+    }
+    return run(*plan_);
 }
 #endif
\ No newline at end of file
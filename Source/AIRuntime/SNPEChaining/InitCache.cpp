@@ -0,0 +1,199 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/InitCache.hpp"
+#include "inc/hpp/Log.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if PLATFORM_ANDROID
+#include <sys/system_properties.h>
+#endif
+
+#define  LOG_TAG_IC  "SNPE_IC"
+#define  LOGI_IC(...)  SNPE_LOG(SNPE_LOG_INFO,LOG_TAG_IC,__VA_ARGS__)
+#define  LOGW_IC(...)  SNPE_LOG(SNPE_LOG_WARN,LOG_TAG_IC,__VA_ARGS__)
+
+static const char kSuffix[] = ".initcache.dlc";
+
+// Key fields are joined with '.', so they may not contain one
+static std::string sanitize(const std::string& s) {
+    std::string out = s.empty() ? std::string("none") : s;
+    for (char& c : out) {
+        const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                        (c >= '0' && c <= '9') || c == '-' || c == '_';
+        if (!ok) c = '_';
+    }
+    return out;
+}
+
+static bool endsWith(const std::string& s, const char* suffix) {
+    const size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+// mkdir -p
+static bool makeDirs(const std::string& dir) {
+    for (size_t pos = 1; pos <= dir.size(); ++pos) {
+        if (pos != dir.size() && dir[pos] != '/') continue;
+        const std::string part = dir.substr(0, pos);
+        if (::mkdir(part.c_str(), 0775) != 0 && errno != EEXIST) return false;
+    }
+    return true;
+}
+
+struct CacheEntry {
+    std::string name;
+    uint64_t bytes = 0;
+    int64_t mtime = 0;
+};
+
+static std::vector<CacheEntry> listEntries(const std::string& dir) {
+    std::vector<CacheEntry> out;
+    DIR* d = ::opendir(dir.c_str());
+    if (!d) return out;
+    while (const dirent* e = ::readdir(d)) {
+        CacheEntry ce;
+        ce.name = e->d_name;
+        if (!endsWith(ce.name, kSuffix)) continue;
+        struct stat st{};
+        if (::stat((dir + "/" + ce.name).c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+        ce.bytes = uint64_t(st.st_size);
+        ce.mtime = int64_t(st.st_mtime);
+        out.push_back(std::move(ce));
+    }
+    ::closedir(d);
+    return out;
+}
+
+std::string InitCacheKey::fileName() const {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)dlcHash);
+    return sanitize(model) + "." + hash + "." + sanitize(runtime) + "." + sanitize(socId) + "." +
+           sanitize(libVersion) + kSuffix;
+}
+
+std::string InitCacheStore::find(const InitCacheKey& key) const {
+    const std::string path = dir_ + "/" + key.fileName();
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) return {};
+    ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0);   // mark as recently used
+    return path;
+}
+
+bool InitCacheStore::store(const InitCacheKey& key,
+                           const std::function<bool(const std::string& path)>& save) {
+    if (!makeDirs(dir_)) {
+        LOGW_IC("Cannot create init cache directory %s: %s", dir_.c_str(), std::strerror(errno));
+        return false;
+    }
+    const std::string path = dir_ + "/" + key.fileName();
+    // Unique per writer: models built concurrently may share an entry
+    static std::atomic<unsigned> seq{0};
+    const std::string tmp = path + ".tmp" + std::to_string(::getpid()) + "_" + std::to_string(seq++);
+    if (!save(tmp)) {
+        ::unlink(tmp.c_str());
+        LOGW_IC("Saving init cache %s failed", path.c_str());
+        return false;
+    }
+    if (::rename(tmp.c_str(), path.c_str()) != 0) {
+        LOGW_IC("rename(%s) failed: %s", tmp.c_str(), std::strerror(errno));
+        ::unlink(tmp.c_str());
+        return false;
+    }
+    LOGI_IC("Stored init cache %s", path.c_str());
+    evictStale_(key);
+    return true;
+}
+
+void InitCacheStore::evict(const InitCacheKey& key) {
+    const std::string path = dir_ + "/" + key.fileName();
+    if (::unlink(path.c_str()) == 0) LOGI_IC("Evicted init cache %s", path.c_str());
+}
+
+uint64_t InitCacheStore::bytes() const {
+    uint64_t total = 0;
+    for (const auto& e : listEntries(dir_)) total += e.bytes;
+    return total;
+}
+
+void InitCacheStore::evictStale_(const InitCacheKey& keep) {
+    const std::string keepName = keep.fileName();
+    const std::string group = sanitize(keep.model) + ".";
+    std::vector<CacheEntry> entries = listEntries(dir_);
+
+    // Same model, other key: a previous DLC, library or runtime that will not come back
+    uint64_t total = 0;
+    std::vector<CacheEntry> rest;
+    for (auto& e : entries) {
+        if (e.name != keepName && e.name.compare(0, group.size(), group) == 0) {
+            if (::unlink((dir_ + "/" + e.name).c_str()) == 0)
+                LOGI_IC("Evicted stale init cache %s", e.name.c_str());
+            continue;
+        }
+        total += e.bytes;
+        rest.push_back(std::move(e));
+    }
+    if (maxBytes_ == 0 || total <= maxBytes_) return;
+
+    // Over budget: least recently used first, never the entry just stored
+    std::sort(rest.begin(), rest.end(),
+              [](const CacheEntry& a, const CacheEntry& b) { return a.mtime < b.mtime; });
+    for (const auto& e : rest) {
+        if (total <= maxBytes_) break;
+        if (e.name == keepName) continue;
+        if (::unlink((dir_ + "/" + e.name).c_str()) == 0) {
+            total -= e.bytes;
+            LOGI_IC("Evicted init cache %s (directory over %llu bytes)", e.name.c_str(),
+                    (unsigned long long)maxBytes_);
+        }
+    }
+}
+
+static inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+uint64_t InitCacheStore::hashBytes(const void* data, size_t n) {
+    // 8 bytes per step (a DLC is tens of MB and hashed on every cold start)
+    const uint64_t k1 = 0x9E3779B185EBCA87ull, k2 = 0xC2B2AE3D27D4EB4Full;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t h = 0x27D4EB2F165667C5ull ^ (uint64_t(n) * k1);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t v;
+        std::memcpy(&v, p + i, 8);
+        h ^= rotl64(v * k2, 31) * k1;
+        h = rotl64(h, 27) * k1 + 0x85EBCA77C2B2AE63ull;
+    }
+    uint64_t tail = 0;
+    for (size_t s = 0; i < n; ++i, s += 8) tail |= uint64_t(p[i]) << s;
+    h ^= rotl64(tail * k2, 31) * k1;
+    h ^= h >> 33; h *= k2;
+    h ^= h >> 29; h *= k1;
+    h ^= h >> 32;
+    return h;
+}
+
+const std::string& socIdentifier() {
+    static const std::string id = [] {
+        std::ifstream ifs("/sys/devices/soc0/soc_id");
+        std::string s;
+        if (ifs && std::getline(ifs, s) && !s.empty()) return s;
+#if PLATFORM_ANDROID
+        char prop[PROP_VALUE_MAX] = {};
+        if (__system_property_get("ro.soc.model", prop) > 0) return std::string(prop);
+        return std::string("unknown");
+#else
+        return std::string("host");
+#endif
+    }();
+    return id;
+}
+#endif
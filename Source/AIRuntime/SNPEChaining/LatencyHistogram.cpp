@@ -0,0 +1,44 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void LatencyHistogram::reset() {
+    for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    const uint64_t total = count();
+    if (total == 0) return 0;
+    q = std::min(1.0, std::max(0.0, q));
+    // Rank of the q-th value (1-based), as in HdrHistogram
+    const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(q * double(total))));
+    const uint64_t lo = min_.load(std::memory_order_relaxed);
+    const uint64_t hi = max_.load(std::memory_order_relaxed);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < kBuckets; ++b) {
+        seen += counts_[b].load(std::memory_order_relaxed);
+        if (seen >= rank) return std::min(hi, std::max(lo, bucketUpper(b)));
+    }
+    return hi;
+}
+
+LatencyStats LatencyHistogram::stats() const {
+    LatencyStats s;
+    s.count = count();
+    if (s.count == 0) return s;
+    s.minNs = min_.load(std::memory_order_relaxed);
+    s.maxNs = max_.load(std::memory_order_relaxed);
+    s.meanNs = double(sum_.load(std::memory_order_relaxed)) / double(s.count);
+    s.p50Ns = percentile(0.50);
+    s.p90Ns = percentile(0.90);
+    s.p99Ns = percentile(0.99);
+    return s;
+}
+#endif
@@ -0,0 +1,99 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/LayerProfiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+bool parseProfilingLevel(const std::string& text, ProfilingLevel& out) {
+    if (text == "off" || text.empty()) out = ProfilingLevel::OFF;
+    else if (text == "basic") out = ProfilingLevel::BASIC;
+    else if (text == "moderate") out = ProfilingLevel::MODERATE;
+    else if (text == "detailed") out = ProfilingLevel::DETAILED;
+    else return false;
+    return true;
+}
+
+const char* profilingLevelName(ProfilingLevel level) {
+    switch (level) {
+        case ProfilingLevel::OFF: return "off";
+        case ProfilingLevel::BASIC: return "basic";
+        case ProfilingLevel::MODERATE: return "moderate";
+        case ProfilingLevel::DETAILED: return "detailed";
+    }
+    return "off";
+}
+
+void LayerProfiler::addFrame(const std::vector<LayerTiming>& layers) {
+    std::string key;
+    for (const auto& t : layers) {
+        key.assign(t.layer).append(1, '\n').append(t.runtime);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            it = index_.emplace(key, entries_.size()).first;
+            entries_.push_back(Entry{t.layer, t.runtime, {}, 0});
+            entries_.back().samples.reserve(std::min<size_t>(window_, 4096));
+        }
+        Entry& e = entries_[it->second];
+        e.samples.push_back(t.ns);
+        e.sumNs += t.ns;
+    }
+    ++frames_;
+}
+
+std::vector<LayerHotspot> LayerProfiler::hotspots() const {
+    uint64_t total = 0;
+    for (const auto& e : entries_) total += e.sumNs;
+
+    std::vector<LayerHotspot> out;
+    out.reserve(entries_.size());
+    std::vector<uint64_t> sorted;
+    for (const auto& e : entries_) {
+        if (e.samples.empty()) continue;
+        LayerHotspot h;
+        h.layer = e.layer;
+        h.runtime = e.runtime;
+        h.count = e.samples.size();
+        h.meanUs = double(e.sumNs) / double(h.count) * 1e-3;
+        sorted = e.samples;
+        const size_t rank = std::min(sorted.size() - 1, (sorted.size() * 99 + 99) / 100 - 1);
+        std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+        h.p99Us = double(sorted[rank]) * 1e-3;
+        h.maxUs = double(*std::max_element(sorted.begin(), sorted.end())) * 1e-3;
+        h.share = total ? double(e.sumNs) / double(total) : 0.0;
+        out.push_back(std::move(h));
+    }
+    std::stable_sort(out.begin(), out.end(), [](const LayerHotspot& a, const LayerHotspot& b) {
+        return a.meanUs * double(a.count) > b.meanUs * double(b.count);
+    });
+    return out;
+}
+
+std::string LayerProfiler::table(const std::string& title, size_t topN) const {
+    const auto hs = hotspots();
+    const size_t rows = topN ? std::min(topN, hs.size()) : hs.size();
+    size_t width = 5;  // "layer"
+    for (size_t i = 0; i < rows; ++i) width = std::max(width, hs[i].layer.size());
+    width = std::min<size_t>(width, 48);
+
+    std::string out = title + " (" + std::to_string(frames_) + " frames, " +
+                      std::to_string(hs.size()) + " layers)\n";
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-*s  %-8s %8s %11s %11s %11s %7s\n", int(width), "layer",
+                  "runtime", "count", "mean us", "p99 us", "max us", "share");
+    out += line;
+    for (size_t i = 0; i < rows; ++i) {
+        const auto& h = hs[i];
+        std::snprintf(line, sizeof(line), "%-*.*s  %-8s %8llu %11.1f %11.1f %11.1f %6.1f%%\n",
+                      int(width), int(width), h.layer.c_str(), h.runtime.c_str(),
+                      (unsigned long long)h.count, h.meanUs, h.p99Us, h.maxUs, h.share * 100.0);
+        out += line;
+    }
+    return out;
+}
+
+void LayerProfiler::reset() {
+    frames_ = 0;
+    entries_.clear();
+    index_.clear();
+}
+#endif
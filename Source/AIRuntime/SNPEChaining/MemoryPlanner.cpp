@@ -0,0 +1,104 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/MemoryPlanner.hpp"
+
+#include <algorithm>
+
+static size_t alignUp(size_t v, size_t a) {
+    return (v + a - 1) / a * a;
+}
+
+bool MemoryPlanner::plan(const std::vector<Step>& steps,
+                         const std::unordered_map<std::string, size_t>& bytes,
+                         size_t alignment,
+                         MemoryPlan& out,
+                         std::string* emsg) {
+    out = MemoryPlan{};
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        if (emsg) *emsg = "alignment must be a power of two";
+        return false;
+    }
+    out.alignment = alignment;
+
+    // 1) First write / first read / last read per tensor, in node order
+    struct Use { int firstWrite = -1; int firstRead = -1; int lastRead = -1; int lastWrite = -1; };
+    std::unordered_map<std::string, Use> uses;
+    std::vector<std::string> order; // deterministic slot order (first appearance)
+    auto touch = [&](const std::string& n) -> Use& {
+        auto it = uses.find(n);
+        if (it == uses.end()) {
+            order.push_back(n);
+            it = uses.emplace(n, Use{}).first;
+        }
+        return it->second;
+    };
+    for (int k = 0; k < static_cast<int>(steps.size()); ++k) {
+        for (const auto& n : steps[k].reads) {
+            Use& u = touch(n);
+            if (u.firstRead < 0) u.firstRead = k;
+            u.lastRead = k;
+        }
+        for (const auto& n : steps[k].writes) {
+            Use& u = touch(n);
+            if (u.firstWrite < 0) u.firstWrite = k;
+            u.lastWrite = k;
+        }
+    }
+
+    // 2) Live ranges
+    const int lastStep = steps.empty() ? 0 : static_cast<int>(steps.size()) - 1;
+    out.slots.reserve(order.size());
+    for (const auto& n : order) {
+        auto sz = bytes.find(n);
+        if (sz == bytes.end() || sz->second == 0) {
+            if (emsg) *emsg = "No size known for workspace tensor '" + n + "'";
+            return false;
+        }
+        const Use& u = uses[n];
+        MemoryPlan::Slot s;
+        s.name = n;
+        s.bytes = sz->second;
+        s.pinned = u.firstWrite < 0 || u.lastRead < 0 || u.firstRead < u.firstWrite;
+        if (s.pinned) {
+            s.firstUse = 0;
+            s.lastUse = lastStep;
+        } else {
+            s.firstUse = u.firstWrite;
+            s.lastUse = std::max(u.lastRead, u.lastWrite);
+        }
+        out.naiveBytes += s.bytes;
+        out.slots.push_back(std::move(s));
+    }
+
+    // 3) Greedy by size: biggest first, lowest non-colliding offset
+    std::vector<size_t> bySize(out.slots.size());
+    for (size_t i = 0; i < bySize.size(); ++i) bySize[i] = i;
+    std::stable_sort(bySize.begin(), bySize.end(), [&](size_t a, size_t b) {
+        return out.slots[a].bytes > out.slots[b].bytes;
+    });
+
+    std::vector<size_t> placed;
+    std::vector<const MemoryPlan::Slot*> live;
+    for (size_t idx : bySize) {
+        MemoryPlan::Slot& s = out.slots[idx];
+
+        live.clear();
+        for (size_t p : placed) {
+            const auto& o = out.slots[p];
+            if (o.firstUse <= s.lastUse && s.firstUse <= o.lastUse) live.push_back(&o);
+        }
+        std::sort(live.begin(), live.end(), [](const MemoryPlan::Slot* a, const MemoryPlan::Slot* b) {
+            return a->offset < b->offset;
+        });
+
+        size_t offset = 0;
+        for (const auto* o : live) {
+            if (offset + s.bytes <= o->offset) break;        // fits in the gap before 'o'
+            offset = std::max(offset, alignUp(o->offset + o->bytes, alignment));
+        }
+        s.offset = offset;
+        out.arenaBytes = std::max(out.arenaBytes, alignUp(offset + s.bytes, alignment));
+        placed.push_back(idx);
+    }
+    return true;
+}
+#endif
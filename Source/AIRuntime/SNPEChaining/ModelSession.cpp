@@ -1,297 +1,258 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 //
 // Created by Chiheb Boussema on 16/9/25.
 //
 #include "inc/hpp/ModelSession.hpp"
+#include "inc/hpp/RuntimeTuner.hpp"
 #include "inc/hpp/TensorTypes.hpp"
-#include "inc/hpp/CheckRuntime.hpp"
+#include "inc/hpp/Log.hpp"
+#include "inc/hpp/Trace.hpp"
 
-#include "SNPE/SNPEFactory.hpp"
-#include "SNPE/SNPEBuilder.hpp"
-#include "DlContainer/IDlContainer.hpp"
-#include "DlSystem/PlatformConfig.hpp"
-#include "DlSystem/IUserBufferFactory.hpp"
-
-#include <android/log.h>
-#include <sys/time.h>
-#include <cstring>
-#include <cassert>
+#include <chrono>
+#include <fstream>
 
 #define  LOG_TAG_MS  "SNPE_MS"
-#define  LOGI_MS(...)  __android_log_print(ANDROID_LOG_INFO,LOG_TAG_MS,__VA_ARGS__)
-#define  LOGE_MS(...)  __android_log_print(ANDROID_LOG_ERROR,LOG_TAG_MS,__VA_ARGS__)
+#define  LOGI_MS(...)  SNPE_LOG(SNPE_LOG_INFO,LOG_TAG_MS,__VA_ARGS__)
+#define  LOGE_MS(...)  SNPE_LOG(SNPE_LOG_ERROR,LOG_TAG_MS,__VA_ARGS__)
 
-static const char* rtToStr(zdl::DlSystem::Runtime_t r) {
-    using zdl::DlSystem::Runtime_t;
-    switch (r) {
-        case Runtime_t::CPU: return "CPU";
-        case Runtime_t::GPU: return "GPU";
-        case Runtime_t::DSP: return "DSP";
-        case Runtime_t::AIP_FIXED_TF: return "AIP_FIXED_TF";
-        default: return "UNSET";
-    }
+using SessionClock = std::chrono::steady_clock;
+
+static int64_t elapsedNsSince(SessionClock::time_point t0) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(SessionClock::now() - t0).count();
 }
 
-void ModelSession::reCreate(std::string* buildLog= nullptr) {
-    using clock = std::chrono::steady_clock;
+static int64_t elapsedMsSince(SessionClock::time_point t0) {
+    return elapsedNsSince(t0) / 1000000;
+}
 
-    LOGI_MS("REBUILDING SESSION");
-    zdl::DlSystem::RuntimeList order = opt_.runtimeOrder;
-    if (order.empty()) {
-        LOGI_MS("Order is empty!");
-//        order.add(
-//                checkRuntime(zdl::DlSystem::Runtime_t::DSP)
-//                )
-        if (zdl::SNPE::SNPEFactory::isRuntimeAvailable(zdl::DlSystem::Runtime_t::DSP, zdl::DlSystem::RuntimeCheckOption_t::UNSIGNEDPD_CHECK) || zdl::SNPE::SNPEFactory::isRuntimeAvailable(zdl::DlSystem::Runtime_t::DSP)) {
-            order.add(zdl::DlSystem::Runtime_t::DSP);
-        } else {
-            order.add(zdl::DlSystem::Runtime_t::CPU);
-        }
+// Name -> pointer map to a vector in 'infos' order.
+template <typename Ptr>
+static bool inOrder(const std::vector<TensorInfo>& infos,
+                    const std::unordered_map<std::string, Ptr>& byName,
+                    const char* what, std::vector<Ptr>& out) {
+    out.assign(infos.size(), nullptr);
+    for (size_t i = 0; i < infos.size(); ++i) {
+        auto it = byName.find(infos[i].name);
+        if (it == byName.end()) { LOGE_MS("Missing %s: %s", what, infos[i].name.c_str()); return false; }
+        out[i] = it->second;
     }
-    // Platform options (HTP PD / adaptive, etc.)
-    zdl::DlSystem::PlatformConfig platformConfig;
-    platformConfig.setPlatformOptions("useAdaptivePD:ON");
+    return true;
+}
 
-    LOGI_MS("REbuilding SNPE");
-    // Build SNPE
-    auto t_builder0 = clock::now();
-    zdl::SNPE::SNPEBuilder builder(this->container_.get());
-    LOGI_MS("Got container");
-    auto newSnpe = builder
-            .setOutputLayers({})
-            .setPerformanceProfile(opt_.perf)
-            .setExecutionPriorityHint(zdl::DlSystem::ExecutionPriorityHint_t::HIGH)
-            .setRuntimeProcessorOrder(order)
-            .setUseUserSuppliedBuffers(opt_.useUserSuppliedBuffers)
-            .setPlatformConfig(platformConfig)
-            .setInitCacheMode(opt_.initCache)
-//            .setCPUFallbackMode(true)
-            .setUnconsumedTensorsAsOutputs(true)
-            .build();
-    auto t_builder1 = clock::now();
-    LOGI_MS("SNPE re-builder time: %lld", std::chrono::duration_cast<std::chrono::milliseconds>(t_builder1 - t_builder0).count());
+#if PLATFORM_ANDROID
+static bool runtimeFromName(const std::string& name, zdl::DlSystem::Runtime_t& out) {
+    using zdl::DlSystem::Runtime_t;
+    if      (name == "DSP") out = Runtime_t::DSP;
+    else if (name == "GPU") out = Runtime_t::GPU;
+    else if (name == "CPU") out = Runtime_t::CPU;
+    else return false;
+    return true;
+}
 
-    if (!newSnpe) {
-        if (buildLog) *buildLog += "SNPE re-build failed\n";
-        LOGE_MS("SNPE re-build failed");
-        return;
+static bool perfFromName(const std::string& name, zdl::DlSystem::PerformanceProfile_t& out) {
+    using zdl::DlSystem::PerformanceProfile_t;
+    static const std::pair<const char*, PerformanceProfile_t> kProfiles[] = {
+        {"DEFAULT", PerformanceProfile_t::DEFAULT},
+        {"BALANCED", PerformanceProfile_t::BALANCED},
+        {"HIGH_PERFORMANCE", PerformanceProfile_t::HIGH_PERFORMANCE},
+        {"POWER_SAVER", PerformanceProfile_t::POWER_SAVER},
+        {"SYSTEM_SETTINGS", PerformanceProfile_t::SYSTEM_SETTINGS},
+        {"SUSTAINED_HIGH_PERFORMANCE", PerformanceProfile_t::SUSTAINED_HIGH_PERFORMANCE},
+        {"BURST", PerformanceProfile_t::BURST},
+        {"LOW_POWER_SAVER", PerformanceProfile_t::LOW_POWER_SAVER},
+        {"HIGH_POWER_SAVER", PerformanceProfile_t::HIGH_POWER_SAVER},
+        {"LOW_BALANCED", PerformanceProfile_t::LOW_BALANCED},
+        {"EXTREME_POWER_SAVER", PerformanceProfile_t::EXTREME_POWER_SAVER},
+    };
+    for (const auto& p : kProfiles) {
+        if (name == p.first) { out = p.second; return true; }
     }
+    return false;
+}
 
-    // Swap in new graph (old one is freed)
-    snpe_.swap(newSnpe);
+// Runtime and profile of a tuning candidate or decision; false if either is unknown
+static bool applyChoice(const std::string& runtime, const std::string& profile,
+                        ModelSession::Options& o) {
+    zdl::DlSystem::Runtime_t rt;
+    zdl::DlSystem::PerformanceProfile_t perf;
+    if (!runtimeFromName(runtime, rt) || !perfFromName(profile, perf)) return false;
+    o.runtimeOrder = zdl::DlSystem::RuntimeList();
+    o.runtimeOrder.add(rt);
+    o.perf = perf;
+    return true;
 }
 
 std::unique_ptr<ModelSession> ModelSession::Create(const uint8_t* dlc, size_t bytes,
                      std::shared_ptr<void> dlcOwner,
                      const Options& opt, std::string* buildLog) {
-    std::unique_ptr<ModelSession> self(new ModelSession());
-    using clock = std::chrono::steady_clock;
-
-    self->dlcBacking_ = std::shared_ptr<const uint8_t>(
-        dlc,                   // raw pointer
-        [](const uint8_t*){}   // no-op deleter
-    );
-    self->dlcOwner_ = std::move(dlcOwner);
-
-    // Container
-    auto t1 = clock::now();
-    auto container = zdl::DlContainer::IDlContainer::open(dlc, bytes);
-    auto t2 = clock::now();
-    LOGI_MS("DLContainer open time: %lld", std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count());
-    if (!container) {
-        if (buildLog) *buildLog += "Failed to open DLC container\n";
-        LOGE_MS("DLC open failed");
-        return nullptr;
-    }
-    self->container_ = std::move(container);
-    self->opt_ = opt;
-
-    zdl::DlSystem::RuntimeList order = opt.runtimeOrder;
-    if (order.empty()) {
-//        order.add(
-//                checkRuntime(zdl::DlSystem::Runtime_t::DSP)
-//                )
-        if (zdl::SNPE::SNPEFactory::isRuntimeAvailable(zdl::DlSystem::Runtime_t::DSP, zdl::DlSystem::RuntimeCheckOption_t::UNSIGNEDPD_CHECK) || zdl::SNPE::SNPEFactory::isRuntimeAvailable(zdl::DlSystem::Runtime_t::DSP)) {
-            order.add(zdl::DlSystem::Runtime_t::DSP);
-        } else {
-            order.add(zdl::DlSystem::Runtime_t::CPU);
+    Options o = opt;
+    if (!opt.tuning.table.empty()) {
+        // One pass over the container serves the table key and the init cache key
+        if (o.dlcHash == 0) o.dlcHash = InitCacheStore::hashBytes(dlc, bytes);
+        const std::string key = TuningTable::key(o.dlcHash,
+                                                 zdl::SNPE::SNPEFactory::getLibraryVersion().toString());
+        // Candidates are built without profiling or persisting an init cache entry
+        // each (the next launch builds the decision and stores that one)
+        auto make = [&](const TuneCandidate& c) -> std::unique_ptr<ModelSession> {
+            zdl::DlSystem::Runtime_t rt;
+            if (!runtimeFromName(c.runtime, rt) || !zdl::SNPE::SNPEFactory::isRuntimeAvailable(rt))
+                return nullptr;
+            Options co = opt;
+            co.dlcHash = o.dlcHash;
+            if (!applyChoice(c.runtime, c.profile, co)) return nullptr;
+            co.initCacheDir.clear();
+            co.profiling = ProfilingLevel::OFF;
+            co.tuning = TuningOptions{};
+            return Create(dlc, bytes, dlcOwner, co, nullptr);
+        };
+        TuningDecision d;
+        std::unique_ptr<ModelSession> tuned;
+        const TuneResult r = resolveTuning(opt.tuning, key, make, d, &tuned);
+        if (r == TuneResult::TUNED) {
+            if (buildLog) *buildLog += "Tuned: " + d.runtime + "/" + d.profile + "\n";
+            if (opt.profiling == ProfilingLevel::OFF) return tuned;
+            tuned.reset();   // rebuilt below with profiling
         }
-    }// order.add(chosen);
-
-    // Choose runtime actually available (respect given order)
-//    zdl::DlSystem::Runtime_t chosen = pickFirstAvailable(opt.runtimeOrder);
-    zdl::DlSystem::Runtime_t chosen = checkRuntime(order[0]);
-    self->runtimeName_ = rtToStr(chosen);
-    LOGI_MS("Selected runtime=%s", self->runtimeName_.c_str());
-
-    // Platform options (HTP PD / adaptive, etc.)
-    zdl::DlSystem::PlatformConfig platformConfig;
-    platformConfig.setPlatformOptions("useAdaptivePD:ON");
-
-    // (Optional) log what’s requested
-    if (buildLog) {
-        auto names = order.getRuntimeListNames();
-        std::string s = "Runtime order: ";
-        for (const char* n : names) { s += n; s += " "; }
-        s += "\n";
-        *buildLog += s;
+        if (r != TuneResult::NONE && !applyChoice(d.runtime, d.profile, o))
+            LOGE_MS("Ignoring tuning decision %s/%s", d.runtime.c_str(), d.profile.c_str());
     }
+    auto backend = SnpeBackend::Open(dlc, bytes, std::move(dlcOwner), o, buildLog);
+    if (!backend) return nullptr;
+    return Create(std::move(backend), buildLog);
+}
+#endif
 
-    // Build SNPE
-    auto t_builder0 = clock::now();
-//    zdl::SNPE::SNPEBuilder builder(container.get());
-    zdl::SNPE::SNPEBuilder builder(self->container_.get());
-    self->snpe_ = builder
-            .setOutputLayers({})
-            .setPerformanceProfile(opt.perf)
-            .setExecutionPriorityHint(zdl::DlSystem::ExecutionPriorityHint_t::HIGH)
-            .setRuntimeProcessorOrder(order)
-            .setUseUserSuppliedBuffers(opt.useUserSuppliedBuffers)
-            .setPlatformConfig(platformConfig)
-            .setInitCacheMode(opt.initCache)
-//            .setCPUFallbackMode(true)
-            .setUnconsumedTensorsAsOutputs(true)
-            .build();
-    auto t_builder1 = clock::now();
-    LOGI_MS("SNPE builder time: %lld", std::chrono::duration_cast<std::chrono::milliseconds>(t_builder1 - t_builder0).count());
-
-    if (!self->snpe_) {
-        if (buildLog) *buildLog += "SNPE build failed\n";
-        const char* LastError = zdl::DlSystem::getLastErrorString();
-        LOGE_MS("SNPE build failed: %s", LastError);
-        //UE_LOG(LogTemp, Error, TEXT("SNPE LastError: %s"), LastErrStr ? UTF8_TO_TCHAR(LastErrStr) : TEXT("<null>"));
-        return nullptr;
-    }
+std::unique_ptr<ModelSession> ModelSession::Create(std::unique_ptr<IInferenceBackend> backend,
+                                                   std::string* buildLog) {
+    if (!backend) return nullptr;
+    if (!backend->ready() && !backend->build(buildLog)) return nullptr;
 
-//    self->builder_ = std::move(builder);
-//    self->opt_ = opt;
+    std::unique_ptr<ModelSession> self(new ModelSession());
+    self->backend_ = std::move(backend);
+    self->runtimeName_ = self->backend_->runtimeName();
+    LOGI_MS("Selected runtime=%s", self->runtimeName_.c_str());
 
-    // IO metadata
-    self->captureIO_();
     if (buildLog) {
-        *buildLog += "SNPE build success. Inputs:";
-        for (auto& t : self->inputs_) *buildLog += " " + t.name;
+        *buildLog += "Build success (" + self->runtimeName_ + "). Inputs:";
+        for (auto& t : self->inputs()) *buildLog += " " + t.name;
         *buildLog += "  Outputs:";
-        for (auto& t : self->outputs_) *buildLog += " " + t.name;
+        for (auto& t : self->outputs()) *buildLog += " " + t.name;
         *buildLog += "\n";
     }
     return self;
 }
 
-void ModelSession::captureIO_() {
-    // Inputs
-    auto inNamesOpt = snpe_->getInputTensorNames();
-    if (inNamesOpt) {
-        const auto& names = *inNamesOpt;
-        for (const char* n : names) {
-            auto attr = snpe_->getInputOutputBufferAttributes(n);
-            if (!attr) continue;
-            const auto& shape = (*attr)->getDims();
-            TensorInfo t;
-            t.name = n;
-            t.elementBytes = 4; // float32 for strict boundary
-//            t.dims.assign(shape.getDimensions(), shape.getDimensions() + shape.rank());
-            t.dims.clear();
-            for (size_t i = 0; i < shape.rank(); ++i) t.dims.push_back(shape[i]);
-            inputs_.push_back(std::move(t));
-        }
-    }
-    // Outputs
-    auto outNamesOpt = snpe_->getOutputTensorNames();
-    if (outNamesOpt) {
-        const auto& names = *outNamesOpt;
-        for (const char* n : names) {
-            auto attr = snpe_->getInputOutputBufferAttributes(n);
-            if (!attr) continue;
-            const auto& shape = (*attr)->getDims();
-            TensorInfo t;
-            t.name = n;
-            t.elementBytes = 4; // float32
-//            t.dims.assign(shape.getDimensions(), shape.getDimensions() + shape.rank());
-            t.dims.clear();
-            for (size_t i = 0; i < shape.rank(); ++i) t.dims.push_back(shape[i]);
-            outputs_.push_back(std::move(t));
-        }
+void ModelSession::reCreate(std::string* buildLog = nullptr) {
+    LOGI_MS("REBUILDING SESSION");
+    SNPE_TRACE_SCOPE("session", "rebuild");
+    auto t0 = SessionClock::now();
+    if (!backend_->build(buildLog)) {
+        LOGE_MS("Session re-build failed");
+        return;
     }
-    // NOTE: If your DLC exposes TfN on IO, you could probe encoding here
-    // and log loudly. For strict float32, we keep elementBytes=4 and
-    // fail at execute-time if enc != float.
+    runtimeName_ = backend_->runtimeName();
+    LOGI_MS("Session re-build time: %lld ms", (long long)elapsedMsSince(t0));
 }
 
 void ModelSession::reset() {
     LOGI_MS("[Model Session] Inside reset().");
-    snpe_.reset();
-//    inputs_.clear();
-//    outputs_.clear();
-//    runtimeName_.clear();
-    if (!snpe_) LOGI_MS("[Model Session] RESET SNPE EMPTY");
+    SNPE_TRACE_SCOPE("session", "release");
+    backend_->release();
 }
 
 bool ModelSession::execute(const std::unordered_map<std::string, const void*>& inputPtrs,
                            const std::unordered_map<std::string, void*>& outputPtrs,
                            int64_t* elapsedMs) const {
-    using namespace zdl::DlSystem;
+    SNPE_TRACE_SCOPE("session", "execute");
+    std::vector<const void*> in;
+    std::vector<void*> out;
+    if (!inOrder(inputs(), inputPtrs, "input", in) ||
+        !inOrder(outputs(), outputPtrs, "output", out)) return false;
 
-    UserBufferMap inMap, outMap;
-    std::vector<std::unique_ptr<IUserBuffer>> ubKeepAlive;
-    std::vector<std::unique_ptr<UserBufferEncoding>> encKeepAlive;
+    auto t0 = SessionClock::now();
+    if (!backend_->execute(in, out)) {
+        LOGE_MS("execute failed");
+        return false;
+    }
+    const int64_t ns = elapsedNsSince(t0);
+    executeLatency_.record(uint64_t(ns));
+    if (elapsedMs) *elapsedMs = ns / 1000000;
+    if (profiler_) collectProfile_();
+    return true;
+}
 
-    auto addOne = [&](const TensorInfo& t, const void* ptr, bool isInput) -> bool {
-        if (!ptr) {
-            LOGE_MS("Null pointer for %s '%s'", isInput ? "input" : "output", t.name.c_str());
-            return false;
-        }
-        // encoding: float32 strict
-//        std::unique_ptr<UserBufferEncoding> enc(new UserBufferEncodingFloat());
-        encKeepAlive.emplace_back(new UserBufferEncodingFloat());
-        auto* enc = encKeepAlive.back().get();
+bool ModelSession::bind(const std::unordered_map<std::string, const void*>& inputPtrs,
+                        const std::unordered_map<std::string, void*>& outputPtrs) {
+    std::vector<const void*> in;
+    std::vector<void*> out;
+    if (!inOrder(inputs(), inputPtrs, "input", in) ||
+        !inOrder(outputs(), outputPtrs, "output", out)) return false;
+    return bind(in, out);
+}
 
-        auto strides = computePackedStridesBytes(t.dims, t.elementBytes);
-        size_t bytes = t.bytes();
+bool ModelSession::bind(const std::vector<const void*>& inputPtrs,
+                        const std::vector<void*>& outputPtrs) {
+    if (inputPtrs.size() != inputs().size() || outputPtrs.size() != outputs().size()) {
+        LOGE_MS("bind(): expected %zu inputs / %zu outputs, got %zu / %zu",
+                inputs().size(), outputs().size(), inputPtrs.size(), outputPtrs.size());
+        return false;
+    }
+    SNPE_TRACE_SCOPE("session", "bind");
+    auto t0 = SessionClock::now();
+    bound_ = backend_->bind(inputPtrs, outputPtrs);
+    bindLatency_.recordSince(t0);
+    return bound_;
+}
 
-        auto& ubFactory = zdl::SNPE::SNPEFactory::getUserBufferFactory();
-        auto ub = ubFactory.createUserBuffer(
-                const_cast<void*>(ptr),
-                bytes, strides,
-                enc
-                );
-        if (!ub) {
-            LOGE_MS("Failed to create UserBuffer for %s", t.name.c_str());
-            return false;
-        }
-        if (isInput) inMap.add(t.name.c_str(), ub.get());
-        else         outMap.add(t.name.c_str(), ub.get());
+void ModelSession::unbind() {
+    backend_->unbind();
+    bound_ = false;
+}
 
-        ubKeepAlive.push_back(std::move(ub));
-        return true;
-    };
+bool ModelSession::executeBound(int64_t* elapsedMs, int64_t* elapsedNs) {
+    if (!bound_ || !backend_->ready()) {
+        LOGE_MS("executeBound() called before bind() or on a reset session");
+        return false;
+    }
+    SNPE_TRACE_SCOPE("session", "execute");
 
-    // Bind inputs
-    for (auto& t : inputs_) {
-        auto it = inputPtrs.find(t.name);
-        if (it == inputPtrs.end()) { LOGE_MS("Missing input: %s", t.name.c_str()); return false; }
-        if (!addOne(t, it->second, true)) return false;
+    auto t0 = SessionClock::now();
+    if (!backend_->executeBound()) {
+        LOGE_MS("execute failed");
+        return false;
     }
-    // Bind outputs
-    for (auto& t : outputs_) {
-        auto it = outputPtrs.find(t.name);
-        if (it == outputPtrs.end()) { LOGE_MS("Missing output: %s", t.name.c_str()); return false; }
-        if (!addOne(t, it->second, false)) return false;
+    const int64_t ns = elapsedNsSince(t0);
+    executeLatency_.record(uint64_t(ns));
+    if (elapsedMs) *elapsedMs = ns / 1000000;
+    if (elapsedNs) *elapsedNs = ns;
+    if (profiler_) collectProfile_();
+    return true;
+}
+
+void ModelSession::setProfiling(const ProfilingOptions& opt) {
+    profiling_ = opt;
+    backend_->setProfilingLevel(opt.level);
+    if (opt.level == ProfilingLevel::OFF) {
+        profiler_.reset();
+        return;
     }
+    profiler_.reset(new LayerProfiler(opt.frames));
+    LOGI_MS("Profiling %s (%s), report every %zu frames", profilingLevelName(opt.level),
+            opt.title.c_str(), opt.frames);
+}
 
-    // run
-    timeval t0{}, t1{};
-    gettimeofday(&t0, nullptr);
-    bool ok = snpe_->execute(inMap, outMap);
-    gettimeofday(&t1, nullptr);
+void ModelSession::collectProfile_() const {
+    if (!backend_->lastLayerTimings(layerScratch_)) return;
+    profiler_->addFrame(layerScratch_);
+    if (!profiler_->windowFull()) return;
 
-    if (!ok) {
-        LOGE_MS("SNPE execute failed");
-        return false;
-    }
-    if (elapsedMs) {
-        *elapsedMs = (t1.tv_sec - t0.tv_sec)*1000LL + (t1.tv_usec - t0.tv_usec)/1000LL;
+    const std::string table = profiler_->table(
+            (profiling_.title.empty() ? runtimeName_ : profiling_.title) + " hotspots", profiling_.topN);
+    LOGI_MS("%s", table.c_str());
+    if (!profiling_.reportPath.empty()) {
+        std::ofstream ofs(profiling_.reportPath, std::ios::trunc);
+        if (!(ofs << table)) LOGE_MS("Cannot write profiling report to %s", profiling_.reportPath.c_str());
     }
-    return true;
+    profiler_->reset();
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,337 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/OutputDecoder.hpp"
+#include "inc/hpp/ScoreReduce.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// [.., C, A] float output -> C, A
+bool channelsAnchors(const TensorInfo& t, const char* type, size_t& C, size_t& A, std::string* emsg) {
+    if (t.elementBytes != sizeof(float) || t.dims.size() < 2) {
+        if (emsg) *emsg = std::string(type) + ": '" + t.name + "' is not a float [.., channels, anchors] tensor";
+        return false;
+    }
+    C = t.dims[t.dims.size() - 2];
+    A = t.dims.back();
+    return C > 0 && A > 0;
+}
+
+bool fail(std::string* emsg, const std::string& m) {
+    if (emsg) *emsg = m;
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// YOLO pose: [1, C, A] with box, score and keypoint channels (see PoseDecoder)
+class YoloPoseDecoder final : public IOutputDecoder {
+public:
+    explicit YoloPoseDecoder(const DecoderCfg& cfg) {
+        PoseDecoder::Params p;
+        p.boxChannel = static_cast<int>(cfg.get("boxChannel", p.boxChannel));
+        p.scoreChannel = static_cast<int>(cfg.get("scoreChannel", p.scoreChannel));
+        p.keypointChannel = static_cast<int>(cfg.get("keypointChannel", p.keypointChannel));
+        p.numKeypoints = static_cast<int>(cfg.get("numKeypoints", p.numKeypoints));
+        p.visibilityFirst = cfg.get("visibilityFirst", p.visibilityFirst ? 1 : 0) != 0;
+        p.maxCandidates = static_cast<int>(cfg.get("maxCandidates", p.maxCandidates));
+        dec_.setParams(p);
+    }
+
+    const char* type() const override { return "yolo_pose"; }
+
+    bool prepare(const TensorInfo& out, std::string* emsg) override {
+        size_t C = 0, A = 0;
+        if (!channelsAnchors(out, type(), C, A, emsg)) return false;
+        PoseDecoder::Params p = dec_.params();
+        if (p.boxChannel < 0 || size_t(p.boxChannel) + 4 > C || p.scoreChannel < 0 ||
+            size_t(p.scoreChannel) >= C || p.keypointChannel < 0 ||
+            size_t(p.keypointChannel + 3 * p.numKeypoints) > C ||
+            p.numKeypoints > PoseDetection::kMaxKeypoints) {
+            return fail(emsg, "yolo_pose: channel layout does not fit '" + out.name + "' (" +
+                              std::to_string(C) + " channels)");
+        }
+        p.numChannels = static_cast<int>(C);
+        p.numAnchors = static_cast<int>(A);
+        dec_.setParams(p);
+        dec_.reserve(A);
+        return true;
+    }
+
+    bool decode(const TensorView<float>& out, const DecodeLimits& limits) override {
+        PoseDecoder::Params p = dec_.params();
+        p.scoreThreshold = limits.scoreThreshold;
+        p.iouThreshold = limits.iouThreshold;
+        p.maxDetections = limits.maxDetections;
+        dec_.setParams(p);
+        return dec_.decode(out);
+    }
+
+    const std::vector<PoseDetection>& detections() const override { return dec_.detections(); }
+
+private:
+    PoseDecoder dec_;
+};
+
+// ---------------------------------------------------------------------------
+// YOLO detect: [1, 4 + numClasses, A]; score = best class score of the anchor.
+// NMS is class-agnostic (same as a single-class pose head).
+class YoloDetectDecoder final : public IOutputDecoder {
+public:
+    explicit YoloDetectDecoder(const DecoderCfg& cfg)
+        : boxChannel_(static_cast<int>(cfg.get("boxChannel", 0))),
+          classChannel_(static_cast<int>(cfg.get("classChannel", 4))),
+          cfgClasses_(static_cast<int>(cfg.get("numClasses", 0))),
+          maxCandidates_(static_cast<int>(cfg.get("maxCandidates", 300))) {}
+
+    const char* type() const override { return "yolo_detect"; }
+
+    bool prepare(const TensorInfo& out, std::string* emsg) override {
+        size_t C = 0, A = 0;
+        if (!channelsAnchors(out, type(), C, A, emsg)) return false;
+        numClasses_ = cfgClasses_ > 0 ? cfgClasses_ : static_cast<int>(C) - classChannel_;
+        if (boxChannel_ < 0 || size_t(boxChannel_) + 4 > C || classChannel_ < 0 || numClasses_ <= 0 ||
+            size_t(classChannel_ + numClasses_) > C) {
+            return fail(emsg, "yolo_detect: channel layout does not fit '" + out.name + "' (" +
+                              std::to_string(C) + " channels)");
+        }
+        // NMS helper only reads the box channels
+        PoseDecoder::Params p;
+        p.numChannels = static_cast<int>(C);
+        p.numAnchors = static_cast<int>(A);
+        p.boxChannel = boxChannel_;
+        p.numKeypoints = 0;
+        nms_.setParams(p);
+        nms_.reserve(A);
+        scores_.assign(A, 0.f);
+        classOf_.assign(A, 0);
+        scan_.above.reserve(A);
+        cand_.reserve(A);
+        keep_.reserve(A);
+        dets_.reserve(64);
+        return true;
+    }
+
+    bool decode(const TensorView<float>& out, const DecodeLimits& limits) override {
+        dets_.clear();
+        const size_t A = scores_.size();
+        if (!out.valid() || out.cols() != A || out.rows() < size_t(classChannel_ + numClasses_)) return false;
+
+        // Best class per anchor; branch-free so the compiler vectorizes it
+        const float* first = out.row(classChannel_);
+        std::copy(first, first + A, scores_.begin());
+        std::fill(classOf_.begin(), classOf_.end(), 0);
+        for (int c = 1; c < numClasses_; ++c) {
+            const float* r = out.row(classChannel_ + c);
+            float* s = scores_.data();
+            int32_t* k = classOf_.data();
+            for (size_t a = 0; a < A; ++a) {
+                const bool gt = r[a] > s[a];
+                s[a] = gt ? r[a] : s[a];
+                k[a] = gt ? c : k[a];
+            }
+        }
+
+        scoreScan(scores_.data(), A, limits.scoreThreshold, scan_);
+        if (scan_.above.empty()) return true;
+        cand_.assign(scan_.above.begin(), scan_.above.end());
+        scoreSortTopK(scores_.data(), cand_, size_t(std::max(maxCandidates_, 1)));
+        nms_.nms(out.data(), cand_, size_t(std::max(limits.maxDetections, 0)), keep_);
+
+        const float* cx = out.row(boxChannel_);
+        const float* cy = cx + A;
+        const float* bw = cy + A;
+        const float* bh = bw + A;
+        dets_.resize(keep_.size());
+        for (size_t i = 0; i < keep_.size(); ++i) {
+            const int a = keep_[i];
+            PoseDetection& d = dets_[i];
+            d.cx = cx[a]; d.cy = cy[a]; d.w = bw[a]; d.h = bh[a];
+            d.score = scores_[a];
+            d.anchor = a;
+            d.classId = classOf_[a];
+            d.numKeypoints = 0;
+        }
+        return true;
+    }
+
+    const std::vector<PoseDetection>& detections() const override { return dets_; }
+
+private:
+    int boxChannel_, classChannel_, cfgClasses_, maxCandidates_;
+    int numClasses_ = 0;
+    PoseDecoder nms_;
+    std::vector<float> scores_;
+    std::vector<int32_t> classOf_;
+    ScoreScan scan_;
+    std::vector<int> cand_, keep_;
+    std::vector<PoseDetection> dets_;
+};
+
+// ---------------------------------------------------------------------------
+// Heatmap pose (single person): [1, K, H, W], or [1, H, W, K] with channelsLast.
+// Keypoint = heatmap peak with a quarter-pixel shift toward the higher neighbour,
+// scaled to the model input; score = mean peak; box = extent of visible keypoints.
+class HeatmapPoseDecoder final : public IOutputDecoder {
+public:
+    explicit HeatmapPoseDecoder(const DecoderCfg& cfg)
+        : inputW_(static_cast<float>(cfg.get("inputWidth", 256))),
+          inputH_(static_cast<float>(cfg.get("inputHeight", 256))),
+          visThreshold_(static_cast<float>(cfg.get("visibilityThreshold", 0.2))),
+          channelsLast_(cfg.get("channelsLast", 0) != 0) {}
+
+    const char* type() const override { return "heatmap_pose"; }
+
+    bool prepare(const TensorInfo& out, std::string* emsg) override {
+        const auto& d = out.dims;
+        if (out.elementBytes != sizeof(float) || d.size() < 3) {
+            return fail(emsg, "heatmap_pose: '" + out.name + "' is not a float [.., K, H, W] tensor");
+        }
+        const size_t n = d.size();
+        K_ = channelsLast_ ? d[n - 1] : d[n - 3];
+        H_ = channelsLast_ ? d[n - 3] : d[n - 2];
+        W_ = channelsLast_ ? d[n - 2] : d[n - 1];
+        if (K_ == 0 || H_ == 0 || W_ == 0 || K_ > size_t(PoseDetection::kMaxKeypoints)) {
+            return fail(emsg, "heatmap_pose: unsupported shape for '" + out.name + "' (max " +
+                              std::to_string(PoseDetection::kMaxKeypoints) + " keypoints)");
+        }
+        peak_.assign(K_, 0.f);
+        peakIdx_.assign(K_, 0);
+        dets_.reserve(1);
+        return true;
+    }
+
+    bool decode(const TensorView<float>& out, const DecodeLimits& limits) override {
+        dets_.clear();
+        const size_t plane = H_ * W_;
+        if (!out.valid() || out.size() < K_ * plane) return false;
+        const float* h = out.data();
+
+        // Peaks: one argmax per contiguous plane, or one pass over interleaved pixels
+        if (!channelsLast_) {
+            for (size_t k = 0; k < K_; ++k) {
+                const ScoreMax m = scoreArgmax(h + k * plane, plane);
+                peak_[k] = m.index < 0 ? 0.f : m.value;
+                peakIdx_[k] = m.index < 0 ? 0 : m.index;
+            }
+        } else {
+            std::fill(peak_.begin(), peak_.end(), -std::numeric_limits<float>::infinity());
+            for (size_t p = 0; p < plane; ++p) {
+                const float* px = h + p * K_;
+                for (size_t k = 0; k < K_; ++k) {
+                    if (px[k] > peak_[k]) { peak_[k] = px[k]; peakIdx_[k] = static_cast<int>(p); }
+                }
+            }
+        }
+
+        auto at = [&](size_t k, size_t y, size_t x) {
+            return channelsLast_ ? h[(y * W_ + x) * K_ + k] : h[k * plane + y * W_ + x];
+        };
+        PoseDetection d;
+        d.numKeypoints = static_cast<int>(K_);
+        float sum = 0.f;
+        float x0 = inputW_, y0 = inputH_, x1 = 0.f, y1 = 0.f;
+        bool any = false;
+        for (size_t k = 0; k < K_; ++k) {
+            const size_t y = size_t(peakIdx_[k]) / W_, x = size_t(peakIdx_[k]) % W_;
+            float fx = float(x), fy = float(y);
+            if (x > 0 && x + 1 < W_) {
+                const float dx = at(k, y, x + 1) - at(k, y, x - 1);
+                fx += dx > 0.f ? 0.25f : (dx < 0.f ? -0.25f : 0.f);
+            }
+            if (y > 0 && y + 1 < H_) {
+                const float dy = at(k, y + 1, x) - at(k, y - 1, x);
+                fy += dy > 0.f ? 0.25f : (dy < 0.f ? -0.25f : 0.f);
+            }
+            d.kpX[k] = (fx + 0.5f) * inputW_ / float(W_);
+            d.kpY[k] = (fy + 0.5f) * inputH_ / float(H_);
+            d.kpVis[k] = peak_[k];
+            sum += peak_[k];
+            if (peak_[k] >= visThreshold_) {
+                x0 = std::min(x0, d.kpX[k]); x1 = std::max(x1, d.kpX[k]);
+                y0 = std::min(y0, d.kpY[k]); y1 = std::max(y1, d.kpY[k]);
+                any = true;
+            }
+        }
+        d.score = sum / float(K_);
+        if (!any || d.score < limits.scoreThreshold || limits.maxDetections <= 0) return true;
+        d.cx = 0.5f * (x0 + x1);
+        d.cy = 0.5f * (y0 + y1);
+        d.w = x1 - x0;
+        d.h = y1 - y0;
+        dets_.push_back(d);
+        return true;
+    }
+
+    const std::vector<PoseDetection>& detections() const override { return dets_; }
+
+private:
+    float inputW_, inputH_, visThreshold_;
+    bool channelsLast_;
+    size_t K_ = 0, H_ = 0, W_ = 0;
+    std::vector<float> peak_;
+    std::vector<int> peakIdx_;
+    std::vector<PoseDetection> dets_;
+};
+
+// ---------------------------------------------------------------------------
+// Raw passthrough: no detections; consumers read the output view themselves.
+class RawDecoder final : public IOutputDecoder {
+public:
+    explicit RawDecoder(const DecoderCfg&) {}
+    const char* type() const override { return "raw"; }
+    bool prepare(const TensorInfo&, std::string*) override { return true; }
+    bool decode(const TensorView<float>& out, const DecodeLimits&) override { return out.valid(); }
+    const std::vector<PoseDetection>& detections() const override { return dets_; }
+
+private:
+    std::vector<PoseDetection> dets_;
+};
+
+template <typename T>
+OutputDecoderRegistry::Factory factoryOf() {
+    return [](const DecoderCfg& cfg) { return std::unique_ptr<IOutputDecoder>(new T(cfg)); };
+}
+
+} // namespace
+
+OutputDecoderRegistry::OutputDecoderRegistry() {
+    factories_["yolo_pose"] = factoryOf<YoloPoseDecoder>();
+    factories_["yolo_detect"] = factoryOf<YoloDetectDecoder>();
+    factories_["heatmap_pose"] = factoryOf<HeatmapPoseDecoder>();
+    factories_["raw"] = factoryOf<RawDecoder>();
+}
+
+OutputDecoderRegistry& OutputDecoderRegistry::instance() {
+    static OutputDecoderRegistry registry;
+    return registry;
+}
+
+void OutputDecoderRegistry::add(const std::string& type, Factory factory) {
+    std::lock_guard<std::mutex> lk(mu_);
+    factories_[type] = std::move(factory);
+}
+
+std::unique_ptr<IOutputDecoder> OutputDecoderRegistry::create(const DecoderCfg& cfg, std::string* emsg) const {
+    Factory f;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        auto it = factories_.find(cfg.type);
+        if (it != factories_.end()) f = it->second;
+    }
+    if (!f) {
+        if (emsg) *emsg = "Unknown decoder type '" + cfg.type + "'";
+        return nullptr;
+    }
+    return f(cfg);
+}
+
+std::vector<std::string> OutputDecoderRegistry::types() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    std::vector<std::string> out;
+    out.reserve(factories_.size());
+    for (const auto& kv : factories_) out.push_back(kv.first);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+#endif
@@ -1,4 +1,4 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 //
 // Created by Chiheb Boussema on 22/9/25.
 //
@@ -10,6 +10,7 @@
 #include <stdexcept>
 
 #include "inc/hpp/ParseConfig.hpp"
+#include "inc/hpp/RuntimeTuner.hpp"
 
 // Minimal JSON tokenizer/parser for a restricted subset
 namespace minijson {
@@ -107,8 +108,205 @@ namespace minijson {
         return true;
     }
 
+    // Parse: { "type":"...", "output":"...", "<param>": number | true | false, ... }
+    static bool parseDecoderObject(Cursor& c, DecoderCfg& d, std::string* emsg) {
+        d = DecoderCfg{};
+        if (!expect(c,'{',emsg)) return false;
+        c.skipWS();
+        if (!c.end() && c.peek()=='}') { ++c.i; return true; } // empty
+        while (true) {
+            std::string key;
+            if (!parseString(c,key,emsg)) return false;
+            if (!expect(c,':',emsg)) return false;
+            c.skipWS();
+            if (key=="type") {
+                if (!parseString(c,d.type,emsg)) return false;
+            } else if (key=="output") {
+                if (!parseString(c,d.output,emsg)) return false;
+            } else if (c.s->compare(c.i, 4, "true")==0) {
+                c.i += 4; d.params[key] = 1.0;
+            } else if (c.s->compare(c.i, 5, "false")==0) {
+                c.i += 5; d.params[key] = 0.0;
+            } else {
+                double v=0.0;
+                if (!parseNumber(c, v, emsg)) {
+                    if (emsg) *emsg = "Unsupported value in decoder at key '"+key+"'";
+                    return false;
+                }
+                d.params[key] = v;
+            }
+            c.skipWS();
+            if (!c.end() && c.peek()==',') { ++c.i; continue; }
+            if (!expect(c,'}',emsg)) return false;
+            break;
+        }
+        if (d.type.empty()) { if (emsg) *emsg = "Decoder object missing 'type'"; return false; }
+        return true;
+    }
+
+    // Parse: { "level":"detailed", "frames":100, "top":20, "report":"..." }
+    static bool parseProfilingObject(Cursor& c, ProfilingCfg& p, std::string* emsg) {
+        p = ProfilingCfg{};
+        if (!expect(c,'{',emsg)) return false;
+        c.skipWS();
+        if (!c.end() && c.peek()=='}') { ++c.i; return true; } // empty
+        while (true) {
+            std::string key;
+            if (!parseString(c,key,emsg)) return false;
+            if (!expect(c,':',emsg)) return false;
+            c.skipWS();
+            if (key=="level") {
+                if (!parseString(c,p.level,emsg)) return false;
+                if (p.level!="off" && p.level!="basic" && p.level!="moderate" && p.level!="detailed") {
+                    if (emsg) *emsg = "Unknown profiling level '"+p.level+"'";
+                    return false;
+                }
+            } else if (key=="report") {
+                if (!parseString(c,p.report,emsg)) return false;
+            } else if (key=="frames" || key=="top") {
+                double v=0.0;
+                if (!parseNumber(c, v, emsg)) return false;
+                if (v < 0) { if (emsg) *emsg = "Negative profiling '"+key+"'"; return false; }
+                (key=="frames" ? p.frames : p.top) = static_cast<size_t>(v);
+            } else {
+                if (emsg) *emsg = "Unknown profiling key '"+key+"'";
+                return false;
+            }
+            c.skipWS();
+            if (!c.end() && c.peek()==',') { ++c.i; continue; }
+            if (!expect(c,'}',emsg)) return false;
+            break;
+        }
+        return true;
+    }
+
+    // Parse: { "enabled":true, "dir":"...", "max_mb":256 }
+    static bool parseInitCacheObject(Cursor& c, InitCacheCfg& ic, std::string* emsg) {
+        ic = InitCacheCfg{};
+        if (!expect(c,'{',emsg)) return false;
+        c.skipWS();
+        if (!c.end() && c.peek()=='}') { ++c.i; return true; } // empty
+        while (true) {
+            std::string key;
+            if (!parseString(c,key,emsg)) return false;
+            if (!expect(c,':',emsg)) return false;
+            c.skipWS();
+            if (key=="enabled") {
+                if (c.s->compare(c.i, 4, "true")==0) { c.i += 4; ic.enabled = true; }
+                else if (c.s->compare(c.i, 5, "false")==0) { c.i += 5; ic.enabled = false; }
+                else { if (emsg) *emsg = "init_cache 'enabled' must be true or false"; return false; }
+            } else if (key=="dir") {
+                if (!parseString(c,ic.dir,emsg)) return false;
+            } else if (key=="max_mb") {
+                double v=0.0;
+                if (!parseNumber(c, v, emsg)) return false;
+                if (v < 0) { if (emsg) *emsg = "Negative init_cache 'max_mb'"; return false; }
+                ic.maxMb = static_cast<size_t>(v);
+            } else {
+                if (emsg) *emsg = "Unknown init_cache key '"+key+"'";
+                return false;
+            }
+            c.skipWS();
+            if (!c.end() && c.peek()==',') { ++c.i; continue; }
+            if (!expect(c,'}',emsg)) return false;
+            break;
+        }
+        return true;
+    }
+
+    // Parse: [ "a", "b", ... ]
+    static bool parseStringArray(Cursor& c, std::vector<std::string>& out, std::string* emsg) {
+        out.clear();
+        if (!expect(c,'[',emsg)) return false;
+        c.skipWS();
+        if (!c.end() && c.peek()==']') { ++c.i; return true; } // empty
+        while (true) {
+            std::string v;
+            if (!parseString(c,v,emsg)) return false;
+            out.push_back(std::move(v));
+            c.skipWS();
+            if (!c.end() && c.peek()==',') { ++c.i; continue; }
+            if (!expect(c,']',emsg)) return false;
+            break;
+        }
+        return true;
+    }
+
+    // Parse: { "enabled":true, "table":"...", "objective":"p95|power", "budget_ms":20,
+    //          "warmup":3, "iterations":20, "runtimes":[...], "profiles":[...] }
+    static bool parseTuningObject(Cursor& c, TuningCfg& tc, std::string* emsg) {
+        tc = TuningCfg{};
+        tc.enabled = true;
+        tc.table = "tuning.tsv";
+        if (!expect(c,'{',emsg)) return false;
+        c.skipWS();
+        if (!c.end() && c.peek()=='}') { ++c.i; return true; } // empty
+        while (true) {
+            std::string key;
+            if (!parseString(c,key,emsg)) return false;
+            if (!expect(c,':',emsg)) return false;
+            c.skipWS();
+            if (key=="enabled") {
+                if (c.s->compare(c.i, 4, "true")==0) { c.i += 4; tc.enabled = true; }
+                else if (c.s->compare(c.i, 5, "false")==0) { c.i += 5; tc.enabled = false; }
+                else { if (emsg) *emsg = "tuning 'enabled' must be true or false"; return false; }
+            } else if (key=="table") {
+                if (!parseString(c,tc.table,emsg)) return false;
+                if (tc.table.empty()) { if (emsg) *emsg = "Empty tuning 'table'"; return false; }
+            } else if (key=="objective") {
+                if (!parseString(c,tc.objective,emsg)) return false;
+                TuneObjective o;
+                if (!parseTuneObjective(tc.objective, o)) {
+                    if (emsg) *emsg = "Unknown tuning objective '"+tc.objective+"'";
+                    return false;
+                }
+            } else if (key=="budget_ms") {
+                if (!parseNumber(c, tc.budgetMs, emsg)) return false;
+                if (tc.budgetMs < 0) { if (emsg) *emsg = "Negative tuning 'budget_ms'"; return false; }
+            } else if (key=="warmup" || key=="iterations") {
+                double v=0.0;
+                if (!parseNumber(c, v, emsg)) return false;
+                if (v < 0) { if (emsg) *emsg = "Negative tuning '"+key+"'"; return false; }
+                (key=="warmup" ? tc.warmup : tc.iterations) = static_cast<size_t>(v);
+            } else if (key=="runtimes") {
+                if (!parseStringArray(c,tc.runtimes,emsg)) return false;
+            } else if (key=="profiles") {
+                if (!parseStringArray(c,tc.profiles,emsg)) return false;
+                for (const auto& p : tc.profiles) {
+                    if (profilePowerRank(p) < 0) { if (emsg) *emsg = "Unknown performance profile '"+p+"'"; return false; }
+                }
+            } else {
+                if (emsg) *emsg = "Unknown tuning key '"+key+"'";
+                return false;
+            }
+            c.skipWS();
+            if (!c.end() && c.peek()==',') { ++c.i; continue; }
+            if (!expect(c,'}',emsg)) return false;
+            break;
+        }
+        if (tc.iterations == 0) { if (emsg) *emsg = "tuning 'iterations' must be positive"; return false; }
+        return true;
+    }
+
+    // Parse: { "images":"uint8", "*":"fp16", ... }
+    static bool parseIoTypesObject(Cursor& c, DataTypeMap& types, std::string* emsg) {
+        std::unordered_map<std::string,std::string> raw;
+        if (!parseStringObject(c, raw, emsg)) return false;
+        types.clear();
+        for (const auto& kv : raw) {
+            TensorDataType t;
+            if (!parseDataType(kv.second, t)) {
+                if (emsg) *emsg = "Unknown io type '"+kv.second+"' for '"+kv.first+"'";
+                return false;
+            }
+            types[kv.first] = t;
+        }
+        return true;
+    }
+
     static bool parseModelObject(Cursor& c, ModelCfg& m, std::string* emsg) {
-        // Expects: { "name": "...", "asset": "...", ["runtime":"D"], "inputs": {...}, "outputs": {...} }
+        // Expects: { "name": "...", "asset": "...", ["runtime":"D"], "inputs": {...}, "outputs": {...},
+        //            ["decoder": {...}], ["profiling": {...}], ["io_types": {...}] }
         if (!expect(c,'{',emsg)) return false;
 
         bool haveName=false, haveAsset=false, haveInputs=false, haveOutputs=false;
@@ -139,6 +337,12 @@ namespace minijson {
             } else if (key=="outputs") {
                 if (!parseStringObject(c, m.outputs, emsg)) return false;
                 haveOutputs=true;
+            } else if (key=="decoder") {
+                if (!parseDecoderObject(c, m.decoder, emsg)) return false;
+            } else if (key=="profiling") {
+                if (!parseProfilingObject(c, m.profiling, emsg)) return false;
+            } else if (key=="io_types") {
+                if (!parseIoTypesObject(c, m.ioTypes, emsg)) return false;
             } else {
                 // skip value (string or object or array) — but we only need str/object here
                 // try string first
@@ -177,6 +381,14 @@ namespace minijson {
             if (emsg) *emsg = "Model object missing required fields (name/asset/inputs/outputs)";
             return false;
         }
+        // "*" also names every model tensor the config binds: the first build on DSP
+        // sets buffer types before the backend has listed the model's IO
+        auto any = m.ioTypes.find("*");
+        if (any != m.ioTypes.end()) {
+            const TensorDataType t = any->second;
+            for (const auto* binding : {&m.inputs, &m.outputs})
+                for (const auto& kv : *binding) m.ioTypes.emplace(kv.first, t);
+        }
         return true;
     }
 
@@ -325,6 +537,15 @@ namespace minijson {
                 haveModels = true;
             } else if (key=="init") {
                 if (!minijson::parseInitMap(c, cfg.init, emsg)) return false;
+            } else if (key=="build_threads") {
+                double v=0.0;
+                if (!parseNumber(c, v, emsg)) return false;
+                if (v < 0) { if (emsg) *emsg = "Negative 'build_threads'"; return false; }
+                cfg.buildThreads = static_cast<size_t>(v);
+            } else if (key=="init_cache") {
+                if (!parseInitCacheObject(c, cfg.initCache, emsg)) return false;
+            } else if (key=="tuning") {
+                if (!parseTuningObject(c, cfg.tuning, emsg)) return false;
             } else {
                 // skip unknown field (string / object / array)
                 c.skipWS();
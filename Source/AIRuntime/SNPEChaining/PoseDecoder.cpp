@@ -0,0 +1,147 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/PoseDecoder.hpp"
+#include "inc/hpp/Simd.hpp"
+
+#include <algorithm>
+
+void PoseDecoder::reserve(size_t anchors) {
+    const size_t padded = (anchors + 3) & ~size_t(3);
+    scan_.above.reserve(anchors);
+    cand_.reserve(anchors);
+    keep_.reserve(anchors);
+    x1_.reserve(padded); y1_.reserve(padded);
+    x2_.reserve(padded); y2_.reserve(padded);
+    area_.reserve(padded);
+    suppressed_.reserve(padded);
+    dets_.reserve(std::min(anchors, std::max(size_t(p_.maxDetections), size_t(64))));
+}
+
+bool PoseDecoder::decode(const float* out, size_t floats) {
+    dets_.clear();
+    scan_.best = ScoreMax();
+    scan_.above.clear();
+    const size_t A = size_t(p_.numAnchors);
+    if (!out || A == 0 || floats < size_t(p_.numChannels) * A) return false;
+    if (p_.scoreChannel >= p_.numChannels ||
+        p_.keypointChannel + 3 * p_.numKeypoints > p_.numChannels) return false;
+
+    // 1) Threshold the score row (vectorized; also records the argmax)
+    const float* score = out + size_t(p_.scoreChannel) * A;
+    scoreScan(score, A, p_.scoreThreshold, scan_);
+    if (scan_.above.empty()) return true;
+
+    // 2) Best first (stable: equal scores keep anchor order), capped for NMS
+    cand_.assign(scan_.above.begin(), scan_.above.end());
+    scoreSortTopK(score, cand_, size_t(std::max(p_.maxCandidates, 1)));
+
+    // 3) NMS
+    nms(out, cand_, size_t(std::max(p_.maxDetections, 0)), keep_);
+
+    // 4) Gather survivors
+    const float* cx = out + size_t(p_.boxChannel) * A;
+    const float* cy = cx + A;
+    const float* bw = cy + A;
+    const float* bh = bw + A;
+    const int nk = std::min(p_.numKeypoints, PoseDetection::kMaxKeypoints);
+    dets_.resize(keep_.size());
+    for (size_t k = 0; k < keep_.size(); ++k) {
+        const int a = keep_[k];
+        PoseDetection& d = dets_[k];
+        d.cx = cx[a];
+        d.cy = cy[a];
+        d.w = bw[a];
+        d.h = bh[a];
+        d.score = score[a];
+        d.anchor = a;
+        d.numKeypoints = nk;
+        for (int kp = 0; kp < nk; ++kp) {
+            const float* base = out + size_t(p_.keypointChannel + kp * 3) * A + a;
+            if (p_.visibilityFirst) {
+                d.kpVis[kp] = base[0];
+                d.kpX[kp] = base[A];
+                d.kpY[kp] = base[2 * A];
+            } else {
+                d.kpX[kp] = base[0];
+                d.kpY[kp] = base[A];
+                d.kpVis[kp] = base[2 * A];
+            }
+        }
+    }
+    return true;
+}
+
+bool PoseDecoder::decode(const TensorView<float>& out) {
+    if (!out.valid()) { dets_.clear(); return false; }
+    p_.numChannels = static_cast<int>(out.rows());
+    p_.numAnchors = static_cast<int>(out.cols());
+    return decode(out.data(), out.size());
+}
+
+void PoseDecoder::nms(const float* out, const std::vector<int>& sorted, size_t maxKeep, std::vector<int>& keep) {
+    keep.clear();
+    const size_t n = sorted.size();
+    if (n == 0 || maxKeep == 0) return;
+
+    // SoA corners, padded to a multiple of 4 with empty boxes
+    const size_t A = size_t(p_.numAnchors);
+    const float* cx = out + size_t(p_.boxChannel) * A;
+    const float* cy = cx + A;
+    const float* bw = cy + A;
+    const float* bh = bw + A;
+    const size_t padded = (n + 3) & ~size_t(3);
+    x1_.assign(padded, 0.f); y1_.assign(padded, 0.f);
+    x2_.assign(padded, 0.f); y2_.assign(padded, 0.f);
+    area_.assign(padded, 0.f);
+    suppressed_.assign(padded, 0u);
+    for (size_t i = 0; i < n; ++i) {
+        const int a = sorted[i];
+        x1_[i] = cx[a] - 0.5f * bw[a];
+        y1_[i] = cy[a] - 0.5f * bh[a];
+        x2_[i] = cx[a] + 0.5f * bw[a];
+        y2_[i] = cy[a] + 0.5f * bh[a];
+        area_[i] = std::max(bw[a], 0.f) * std::max(bh[a], 0.f);
+    }
+
+    // IoU > t  <=>  inter > t * (areaI + areaJ - inter)
+    const float t = p_.iouThreshold;
+    for (size_t i = 0; i < n && keep.size() < maxKeep; ++i) {
+        if (suppressed_[i]) continue;
+        keep.push_back(sorted[i]);
+
+        size_t j = (i + 1) & ~size_t(3); // aligned start; lanes <= i are already decided
+#if SNPE_SIMD_NEON
+        const float32x4_t X1 = vdupq_n_f32(x1_[i]), Y1 = vdupq_n_f32(y1_[i]);
+        const float32x4_t X2 = vdupq_n_f32(x2_[i]), Y2 = vdupq_n_f32(y2_[i]);
+        const float32x4_t AR = vdupq_n_f32(area_[i]), T = vdupq_n_f32(t), Z = vdupq_n_f32(0.f);
+        for (; j < padded; j += 4) {
+            float32x4_t iw = vmaxq_f32(vsubq_f32(vminq_f32(X2, vld1q_f32(&x2_[j])), vmaxq_f32(X1, vld1q_f32(&x1_[j]))), Z);
+            float32x4_t ih = vmaxq_f32(vsubq_f32(vminq_f32(Y2, vld1q_f32(&y2_[j])), vmaxq_f32(Y1, vld1q_f32(&y1_[j]))), Z);
+            float32x4_t inter = vmulq_f32(iw, ih);
+            float32x4_t uni = vsubq_f32(vaddq_f32(AR, vld1q_f32(&area_[j])), inter);
+            uint32x4_t over = vcgtq_f32(inter, vmulq_f32(T, uni));
+            vst1q_u32(&suppressed_[j], vorrq_u32(vld1q_u32(&suppressed_[j]), over));
+        }
+#elif SNPE_SIMD_SSE2
+        const __m128 X1 = _mm_set1_ps(x1_[i]), Y1 = _mm_set1_ps(y1_[i]);
+        const __m128 X2 = _mm_set1_ps(x2_[i]), Y2 = _mm_set1_ps(y2_[i]);
+        const __m128 AR = _mm_set1_ps(area_[i]), T = _mm_set1_ps(t), Z = _mm_setzero_ps();
+        for (; j < padded; j += 4) {
+            __m128 iw = _mm_max_ps(_mm_sub_ps(_mm_min_ps(X2, _mm_loadu_ps(&x2_[j])), _mm_max_ps(X1, _mm_loadu_ps(&x1_[j]))), Z);
+            __m128 ih = _mm_max_ps(_mm_sub_ps(_mm_min_ps(Y2, _mm_loadu_ps(&y2_[j])), _mm_max_ps(Y1, _mm_loadu_ps(&y1_[j]))), Z);
+            __m128 inter = _mm_mul_ps(iw, ih);
+            __m128 uni = _mm_sub_ps(_mm_add_ps(AR, _mm_loadu_ps(&area_[j])), inter);
+            __m128i over = _mm_castps_si128(_mm_cmpgt_ps(inter, _mm_mul_ps(T, uni)));
+            __m128i* s = reinterpret_cast<__m128i*>(&suppressed_[j]);
+            _mm_storeu_si128(s, _mm_or_si128(_mm_loadu_si128(s), over));
+        }
+#else
+        for (; j < padded; ++j) {
+            float iw = std::max(std::min(x2_[i], x2_[j]) - std::max(x1_[i], x1_[j]), 0.f);
+            float ih = std::max(std::min(y2_[i], y2_[j]) - std::max(y1_[i], y1_[j]), 0.f);
+            float inter = iw * ih;
+            if (inter > t * (area_[i] + area_[j] - inter)) suppressed_[j] = ~0u;
+        }
+#endif
+    }
+}
+#endif
@@ -0,0 +1,221 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/Preprocess.hpp"
+#include "inc/hpp/Simd.hpp"
+#include "inc/hpp/TensorConvert.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+bool ImagePreprocessor::configure(int srcW, int srcH) {
+    if (srcW <= 0 || srcH <= 0 || p_.dstW <= 0 || p_.dstH <= 0) return false;
+    if (srcW == srcW_ && srcH == srcH_) return true;
+
+    // Image rectangle inside the model input
+    LetterboxTransform t;
+    if (p_.fit == Fit::LETTERBOX) {
+        const double s = std::min(double(p_.dstW) / srcW, double(p_.dstH) / srcH);
+        t.roiW = std::max(1, std::min(p_.dstW, int(std::lround(srcW * s))));
+        t.roiH = std::max(1, std::min(p_.dstH, int(std::lround(srcH * s))));
+        t.roiX = (p_.dstW - t.roiW) / 2;
+        t.roiY = (p_.dstH - t.roiH) / 2;
+    } else {
+        t.roiW = p_.dstW;
+        t.roiH = p_.dstH;
+    }
+    // Exact for the sampling below: ROI pixel edge i maps to source edge i * src / roi
+    t.scaleX = float(t.roiW) / srcW;
+    t.scaleY = float(t.roiH) / srcH;
+    t.padX = float(t.roiX);
+    t.padY = float(t.roiY);
+
+    // Nearest neighbour: src = floor(i * src / roi), in integers
+    xOff_.resize(t.roiW);
+    for (int x = 0; x < t.roiW; ++x) {
+        int sx = static_cast<int>(int64_t(x) * srcW / t.roiW);
+        if (sx > srcW - 1) sx = srcW - 1;
+        xOff_[x] = sx * 3;
+    }
+    // Columns whose 4-byte load stays inside the row (the last pixel has only 3)
+    xVecEnd_ = 0;
+    while (xVecEnd_ < t.roiW && xOff_[xVecEnd_] + 4 <= srcW * 3) ++xVecEnd_;
+    yRow_.resize(t.roiH);
+    for (int y = 0; y < t.roiH; ++y) {
+        int sy = static_cast<int>(int64_t(y) * srcH / t.roiH);
+        if (sy > srcH - 1) sy = srcH - 1;
+        yRow_[y] = sy;
+    }
+    t_ = t;
+    srcW_ = srcW;
+    srcH_ = srcH;
+    return true;
+}
+
+template <typename T>
+void ImagePreprocessor::fillPad_(T* dst, T value) const {
+    if (t_.roiW == p_.dstW && t_.roiH == p_.dstH) return;
+    const size_t plane = size_t(p_.dstW) * p_.dstH;
+    for (int c = 0; c < 3; ++c) {
+        T* d = dst + c * plane;
+        // Bands above/below the image, then the left/right bands of its rows
+        std::fill(d, d + size_t(t_.roiY) * p_.dstW, value);
+        std::fill(d + size_t(t_.roiY + t_.roiH) * p_.dstW, d + plane, value);
+        for (int y = t_.roiY; y < t_.roiY + t_.roiH; ++y) {
+            T* row = d + size_t(y) * p_.dstW;
+            std::fill(row, row + t_.roiX, value);
+            std::fill(row + t_.roiX + t_.roiW, row + p_.dstW, value);
+        }
+    }
+}
+
+bool ImagePreprocessor::runScalar(const uint8_t* rgb, int srcW, int srcH, size_t srcStride, float* dst) {
+    if (!rgb || !dst || !configure(srcW, srcH)) return false;
+    if (srcStride == 0) srcStride = size_t(srcW) * 3;
+    fillPad_(dst, p_.padValue);
+
+    const size_t plane = size_t(p_.dstW) * p_.dstH;
+    float* dR = dst;
+    float* dG = dst + plane;
+    float* dB = dst + 2 * plane;
+    for (int y = 0; y < t_.roiH; ++y) {
+        const uint8_t* row = rgb + size_t(yRow_[y]) * srcStride;
+        const size_t o = size_t(y + t_.roiY) * p_.dstW + t_.roiX;
+        for (int x = 0; x < t_.roiW; ++x) {
+            const uint8_t* px = row + xOff_[x];
+            dR[o + x] = px[0] * p_.scale + p_.bias;
+            dG[o + x] = px[1] * p_.scale + p_.bias;
+            dB[o + x] = px[2] * p_.scale + p_.bias;
+        }
+    }
+    return true;
+}
+
+#if SNPE_SIMD_NEON
+// px: 4 pixels as little-endian 32-bit lanes 0x??BBGGRR -> 4 floats per plane
+static inline void store4(uint32x4_t px, float32x4_t scale, float32x4_t bias,
+                          float* r, float* g, float* b) {
+    const uint32x4_t mask = vdupq_n_u32(0xFF);
+    vst1q_f32(r, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vandq_u32(px, mask)), scale), bias));
+    vst1q_f32(g, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(px, 8), mask)), scale), bias));
+    vst1q_f32(b, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(px, 16), mask)), scale), bias));
+}
+#elif SNPE_SIMD_SSE2
+static inline void store4(__m128i px, __m128 scale, __m128 bias, float* r, float* g, float* b) {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    _mm_storeu_ps(r, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(px, mask)), scale), bias));
+    _mm_storeu_ps(g, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 8), mask)), scale), bias));
+    _mm_storeu_ps(b, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 16), mask)), scale), bias));
+}
+#endif
+
+bool ImagePreprocessor::run(const uint8_t* rgb, int srcW, int srcH, size_t srcStride, float* dst) {
+#if SNPE_SIMD_NONE
+    return runScalar(rgb, srcW, srcH, srcStride, dst);
+#else
+    if (!rgb || !dst || !configure(srcW, srcH)) return false;
+    if (srcStride == 0) srcStride = size_t(srcW) * 3;
+    fillPad_(dst, p_.padValue);
+
+#if SNPE_SIMD_NEON
+    const float32x4_t vScale = vdupq_n_f32(p_.scale);
+    const float32x4_t vBias = vdupq_n_f32(p_.bias);
+#else
+    const __m128 vScale = _mm_set1_ps(p_.scale);
+    const __m128 vBias = _mm_set1_ps(p_.bias);
+#endif
+
+    const size_t plane = size_t(p_.dstW) * p_.dstH;
+    float* dR = dst;
+    float* dG = dst + plane;
+    float* dB = dst + 2 * plane;
+    const int32_t* xo = xOff_.data();
+    const int vecEnd = xVecEnd_ & ~3;
+
+    for (int y = 0; y < t_.roiH; ++y) {
+        const uint8_t* row = rgb + size_t(yRow_[y]) * srcStride;
+        const size_t o = size_t(y + t_.roiY) * p_.dstW + t_.roiX;
+        int x = 0;
+        // One 32-bit load per pixel (RGB + next byte); lanes are split by mask/shift
+        for (; x < vecEnd; x += 4) {
+            alignas(16) uint32_t px[4];
+            std::memcpy(&px[0], row + xo[x + 0], 4);
+            std::memcpy(&px[1], row + xo[x + 1], 4);
+            std::memcpy(&px[2], row + xo[x + 2], 4);
+            std::memcpy(&px[3], row + xo[x + 3], 4);
+#if SNPE_SIMD_NEON
+            store4(vld1q_u32(px), vScale, vBias, dR + o + x, dG + o + x, dB + o + x);
+#else
+            store4(_mm_load_si128(reinterpret_cast<const __m128i*>(px)), vScale, vBias,
+                   dR + o + x, dG + o + x, dB + o + x);
+#endif
+        }
+        for (; x < t_.roiW; ++x) {
+            const uint8_t* px = row + xo[x];
+            dR[o + x] = px[0] * p_.scale + p_.bias;
+            dG[o + x] = px[1] * p_.scale + p_.bias;
+            dB[o + x] = px[2] * p_.scale + p_.bias;
+        }
+    }
+    return true;
+#endif
+}
+void ImagePreprocessor::buildTable_(const TensorInfo& info) {
+    if (tableValid_ && info.sameEncoding(tableInfo_)) return;
+    float values[257];
+    for (int v = 0; v < 256; ++v) values[v] = v * p_.scale + p_.bias;
+    values[256] = p_.padValue;
+    uint16_t encoded[257];
+    if (info.dataType == TensorDataType::UFIXED8) {
+        uint8_t q[257];
+        tensorFromFloat(values, info, q, 257);
+        for (int v = 0; v < 257; ++v) encoded[v] = q[v];
+    } else {
+        tensorFromFloat(values, info, encoded, 257);
+    }
+    std::memcpy(table_, encoded, sizeof(table_));
+    tablePad_ = encoded[256];
+    tableInfo_ = TensorInfo();
+    tableInfo_.setDataType(info.dataType);
+    tableInfo_.qScale = info.qScale;
+    tableInfo_.qOffset = info.qOffset;
+    tableValid_ = true;
+}
+
+template <typename T>
+bool ImagePreprocessor::runTable_(const uint8_t* rgb, int srcW, size_t srcStride, T* dst) {
+    if (srcStride == 0) srcStride = size_t(srcW) * 3;
+    fillPad_(dst, T(tablePad_));
+
+    T table[256];
+    for (int v = 0; v < 256; ++v) table[v] = T(table_[v]);
+    const size_t plane = size_t(p_.dstW) * p_.dstH;
+    T* dR = dst;
+    T* dG = dst + plane;
+    T* dB = dst + 2 * plane;
+    for (int y = 0; y < t_.roiH; ++y) {
+        const uint8_t* row = rgb + size_t(yRow_[y]) * srcStride;
+        const size_t o = size_t(y + t_.roiY) * p_.dstW + t_.roiX;
+        for (int x = 0; x < t_.roiW; ++x) {
+            const uint8_t* px = row + xOff_[x];
+            dR[o + x] = table[px[0]];
+            dG[o + x] = table[px[1]];
+            dB[o + x] = table[px[2]];
+        }
+    }
+    return true;
+}
+
+bool ImagePreprocessor::run(const uint8_t* rgb, int srcW, int srcH, size_t srcStride, void* dst,
+                            const TensorInfo& dstInfo) {
+    if (dstInfo.elements() != outputFloats()) return false;
+    if (dstInfo.dataType == TensorDataType::FLOAT32) {
+        return run(rgb, srcW, srcH, srcStride, static_cast<float*>(dst));
+    }
+    if (!rgb || !dst || !configure(srcW, srcH)) return false;
+    buildTable_(dstInfo);
+    if (dstInfo.dataType == TensorDataType::UFIXED8) {
+        return runTable_(rgb, srcW, srcStride, static_cast<uint8_t*>(dst));
+    }
+    return runTable_(rgb, srcW, srcStride, static_cast<uint16_t*>(dst));
+}
+#endif
@@ -0,0 +1,220 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/ReferenceChain.hpp"
+#include "inc/hpp/CpuReferenceBackend.hpp"
+#include "inc/hpp/ModelSession.hpp"
+#include "inc/hpp/RuntimeTuner.hpp"
+#include "inc/hpp/Trace.hpp"
+#include "inc/hpp/WorkerPool.hpp"
+#include "inc/hpp/initTensorsHelper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+static bool loadSpecText(const PipelineCfg& cfg, const ModelCfg& mc, std::string& text,
+                         std::string* emsg) {
+    static const char kInline[] = "cpu:";
+    if (mc.asset.compare(0, sizeof(kInline) - 1, kInline) == 0) {
+        text = mc.asset.substr(sizeof(kInline) - 1);
+        return true;
+    }
+    const std::string path = cfg.baseDir.empty() ? mc.asset : cfg.baseDir + "/" + mc.asset;
+    std::ifstream ifs(path);
+    if (!ifs) {
+        if (emsg) *emsg = "cannot read model spec '" + path + "'";
+        return false;
+    }
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    text = ss.str();
+    return true;
+}
+
+// Allocate (zeroed) or check the size of a workspace tensor
+static bool ensureBuffer(TensorWorkspace& ws, const std::string& wsName, size_t bytes,
+                         std::string* emsg) {
+    if (!ws.has(wsName)) {
+        void* p = ws.allocate(wsName, bytes);
+        if (!p) {
+            if (emsg) *emsg = "allocate('" + wsName + "') failed";
+            return false;
+        }
+        std::memset(p, 0, bytes);
+        return true;
+    }
+    if (ws.sizeOf(wsName) != bytes) {
+        if (emsg) *emsg = "Workspace tensor size mismatch for '" + wsName + "': have " +
+                          std::to_string(ws.sizeOf(wsName)) + ", need " + std::to_string(bytes);
+        return false;
+    }
+    return true;
+}
+
+static const TensorInfo* findTensor(const std::vector<TensorInfo>& v, const std::string& name) {
+    for (auto& t : v) if (t.name == name) return &t;
+    return nullptr;
+}
+
+// One model parsed and built, not yet in the graph
+struct PreparedModel {
+    std::unique_ptr<ModelSession> session;
+    std::string buildLog;
+    std::string error;
+    int64_t buildMs = 0;
+};
+
+static void prepareModel(const PipelineCfg& cfg, const ModelCfg& mc, const std::string& cacheDir,
+                         const std::string& tuningTable, int delayUsOverride, bool resetSessions,
+                         PreparedModel& out) {
+    SNPE_TRACE_SCOPE("build", mc.name.c_str());
+    const auto t0 = std::chrono::steady_clock::now();
+    std::string text, err;
+    CpuModelSpec spec;
+    if (!loadSpecText(cfg, mc, text, &err) || !CpuModelSpec::parse(text, spec, &err)) {
+        out.error = "Model '" + mc.name + "': " + err;
+        return;
+    }
+    if (delayUsOverride >= 0) spec.delayUs = delayUsOverride;
+    spec.applyDataTypes(mc.ioTypes);
+
+    std::unique_ptr<CpuReferenceBackend> backend(new CpuReferenceBackend(std::move(spec)));
+    if (!cacheDir.empty()) backend->setInitCache(cacheDir, mc.name, uint64_t(cfg.initCache.maxMb) << 20);
+
+    // Runtime/profile from the decision table or a tuning run (as ModelSession::Create on device)
+    if (!tuningTable.empty()) {
+        const CpuModelSpec& base = backend->spec();
+        const std::string key = TuningTable::key(InitCacheStore::hashBytes(base.source.data(), base.source.size()),
+                                                 "cpuref");
+        auto make = [&](const TuneCandidate& c) -> std::unique_ptr<ModelSession> {
+            std::unique_ptr<CpuReferenceBackend> b(new CpuReferenceBackend(base));
+            if (!b->selectRuntime(c.runtime, c.profile)) return nullptr;
+            return ModelSession::Create(std::unique_ptr<IInferenceBackend>(std::move(b)), nullptr);
+        };
+        TuningDecision d;
+        switch (resolveTuning(makeTuningOptions(cfg.tuning, tuningTable, mc.name), key, make, d, &out.session)) {
+            case TuneResult::TUNED:
+                out.buildLog += "Tuned: " + d.runtime + "/" + d.profile + "\n";
+                break;
+            case TuneResult::STORED:
+                if (!backend->selectRuntime(d.runtime, d.profile))
+                    out.buildLog += "Ignoring tuning decision " + d.runtime + "/" + d.profile + "\n";
+                break;
+            case TuneResult::NONE:
+                break;
+        }
+    }
+
+    if (!out.session)
+        out.session = ModelSession::Create(std::unique_ptr<IInferenceBackend>(std::move(backend)), &out.buildLog);
+    out.buildMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+    if (!out.session) {
+        out.error = "CPU reference build failed for '" + mc.name + "'";
+        return;
+    }
+    if (!mc.profiling.level.empty()) {
+        ModelSession::ProfilingOptions popt;
+        parseProfilingLevel(mc.profiling.level, popt.level);
+        popt.frames = mc.profiling.frames;
+        popt.topN = mc.profiling.top;
+        popt.title = mc.name;
+        if (!mc.profiling.report.empty())
+            popt.reportPath = (cfg.baseDir.empty() || mc.profiling.report[0] == '/')
+                              ? mc.profiling.report : cfg.baseDir + "/" + mc.profiling.report;
+        out.session->setProfiling(popt);
+    }
+    if (resetSessions) out.session->reset();   // rebuilt by its first run
+}
+
+bool buildReferenceChain(const PipelineCfg& cfg,
+                         TensorWorkspace& ws,
+                         GraphRunner& gr,
+                         std::string* log,
+                         std::string* emsg,
+                         int delayUsOverride,
+                         bool resetSessions) {
+    auto fail = [&](const std::string& m) {
+        if (emsg) *emsg = m;
+        return false;
+    };
+    if (cfg.models.empty()) return fail("Config has no models");
+
+    // Same placement as on device: cfg.initCache.dir, relative to the model directory
+    std::string cacheDir;
+    if (cfg.initCache.enabled) {
+        const std::string& dir = cfg.initCache.dir;
+        if (!dir.empty() && (dir[0] == '/' || cfg.baseDir.empty())) cacheDir = dir;
+        else if (!cfg.baseDir.empty()) cacheDir = dir.empty() ? cfg.baseDir : cfg.baseDir + "/" + dir;
+    }
+
+    // Decision table next to the models, like the init cache
+    std::string tuningTable;
+    const std::string& table = cfg.tuning.table;
+    if (!table.empty()) tuningTable = (table[0] == '/' || cfg.baseDir.empty()) ? table : cfg.baseDir + "/" + table;
+
+    // Build the models concurrently, then add them in config order (as buildArbitraryChain)
+    const size_t n = cfg.models.size();
+    size_t threads = cfg.buildThreads;
+    if (threads == 0) threads = std::min<size_t>({n, 4, std::max(1u, std::thread::hardware_concurrency())});
+    threads = std::min(threads, n);
+    if (resetSessions) threads = std::min(threads, gr.maxResidentSessions());
+
+    std::vector<PreparedModel> prepared(n);
+    const auto tPrep0 = std::chrono::steady_clock::now();
+    if (threads <= 1) {
+        for (size_t i = 0; i < n; ++i)
+            prepareModel(cfg, cfg.models[i], cacheDir, tuningTable, delayUsOverride, resetSessions, prepared[i]);
+    } else {
+        WorkerPool pool(threads);
+        for (size_t i = 0; i < n; ++i)
+            pool.submit([&, i] {
+                prepareModel(cfg, cfg.models[i], cacheDir, tuningTable, delayUsOverride, resetSessions, prepared[i]);
+            });
+        pool.wait();
+    }
+    const int64_t prepareWallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - tPrep0).count();
+
+    int64_t buildMs = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const ModelCfg& mc = cfg.models[i];
+        PreparedModel& pm = prepared[i];
+        if (log) *log += "[Build " + mc.name + "] " + pm.buildLog;
+        if (!pm.error.empty()) return fail(pm.error);
+        buildMs += pm.buildMs;
+        std::string err;
+
+        for (const auto& kv : mc.inputs) {
+            const TensorInfo* ti = findTensor(pm.session->inputs(), kv.first);
+            if (!ti) return fail("Model '" + mc.name + "': input tensor not found: " + kv.first);
+            if (!ensureBuffer(ws, kv.second, ti->bytes(), &err))
+                return fail("Workspace alloc (input) failed for '" + mc.name + "': " + err);
+        }
+        for (const auto& kv : mc.outputs) {
+            const TensorInfo* ti = findTensor(pm.session->outputs(), kv.first);
+            if (!ti) return fail("Model '" + mc.name + "': output tensor not found: " + kv.first);
+            if (!ensureBuffer(ws, kv.second, ti->bytes(), &err))
+                return fail("Workspace alloc (output) failed for '" + mc.name + "': " + err);
+        }
+
+        GraphRunner::Node node;
+        node.name = mc.name;
+        node.session = std::move(pm.session);
+        node.inputBinding = mc.inputs;
+        node.outputBinding = mc.outputs;
+        if (!gr.addNode(std::move(node), /*strictZeroCopy=*/true))
+            return fail("addNode failed for '" + mc.name + "'");
+    }
+    if (log) {
+        *log += "Build: " + std::to_string(n) + " models on " + std::to_string(std::max<size_t>(threads, 1)) +
+                " threads, wall " + std::to_string(prepareWallMs) + " ms, summed " + std::to_string(buildMs) + " ms\n";
+    }
+
+    std::string serr;
+    if (!seedRequiredInputs(cfg, ws, nullptr, &serr, &gr)) return fail("Input seeding failed: " + serr);
+    return true;
+}
+#endif
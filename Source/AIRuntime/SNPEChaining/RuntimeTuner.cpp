@@ -0,0 +1,267 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/RuntimeTuner.hpp"
+#include "inc/hpp/InitCache.hpp"
+#include "inc/hpp/LatencyHistogram.hpp"
+#include "inc/hpp/Log.hpp"
+#include "inc/hpp/ModelSession.hpp"
+#include "inc/hpp/ParseConfig.hpp"
+#include "inc/hpp/Trace.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+#include <unistd.h>
+
+#define  LOG_TAG_RT  "SNPE_RT"
+#define  LOGI_RT(...)  SNPE_LOG(SNPE_LOG_INFO,LOG_TAG_RT,__VA_ARGS__)
+#define  LOGW_RT(...)  SNPE_LOG(SNPE_LOG_WARN,LOG_TAG_RT,__VA_ARGS__)
+
+static const char kTableHeader[] = "# key\truntime\tprofile\tobjective\tp50_ms\tp95_ms";
+
+bool parseTuneObjective(const std::string& s, TuneObjective& out) {
+    if (s == "p95" || s == "latency") { out = TuneObjective::P95; return true; }
+    if (s == "power") { out = TuneObjective::POWER; return true; }
+    return false;
+}
+
+int profilePowerRank(const std::string& profile) {
+    static const char* const kByPower[] = {
+        "EXTREME_POWER_SAVER", "LOW_POWER_SAVER", "POWER_SAVER", "HIGH_POWER_SAVER",
+        "LOW_BALANCED", "BALANCED", "DEFAULT", "SYSTEM_SETTINGS",
+        "HIGH_PERFORMANCE", "SUSTAINED_HIGH_PERFORMANCE", "BURST",
+    };
+    for (size_t i = 0; i < sizeof(kByPower) / sizeof(kByPower[0]); ++i)
+        if (profile == kByPower[i]) return int(i);
+    return -1;
+}
+
+std::string TuningOptions::objectiveTag() const {
+    if (objective == TuneObjective::P95) return "p95";
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "power@%gms", budgetMs);
+    return buf;
+}
+
+// ---------------------------------------------------------------- RuntimeTuner
+
+bool RuntimeTuner::measure(ModelSession& s, size_t warmup, size_t iterations,
+                           double& p50Ms, double& p95Ms) {
+    std::vector<std::vector<uint8_t>> in(s.inputs().size()), out(s.outputs().size());
+    std::vector<const void*> inPtrs;
+    std::vector<void*> outPtrs;
+    for (size_t i = 0; i < in.size(); ++i) {
+        in[i].assign(s.inputs()[i].bytes(), 0);
+        inPtrs.push_back(in[i].data());
+    }
+    for (size_t i = 0; i < out.size(); ++i) {
+        out[i].assign(s.outputs()[i].bytes(), 0);
+        outPtrs.push_back(out[i].data());
+    }
+    if (!s.bind(inPtrs, outPtrs)) return false;
+
+    LatencyHistogram hist;
+    bool ok = true;
+    for (size_t i = 0; ok && i < warmup + iterations; ++i) {
+        int64_t ms = 0, ns = 0;
+        ok = s.executeBound(&ms, &ns);
+        if (ok && i >= warmup) hist.record(uint64_t(ns));
+    }
+    s.unbind();
+    s.resetLatency();   // keep the tuning runs out of the session's own statistics
+    if (!ok || hist.count() == 0) return false;
+    p50Ms = double(hist.percentile(0.50)) / 1e6;
+    p95Ms = double(hist.percentile(0.95)) / 1e6;
+    return true;
+}
+
+bool RuntimeTuner::better_(const Measurement& a, const Measurement& b) const {
+    if (a.ok != b.ok) return a.ok;
+    if (opt_.objective == TuneObjective::POWER) {
+        const bool aFits = a.p95Ms <= opt_.budgetMs, bFits = b.p95Ms <= opt_.budgetMs;
+        if (aFits != bFits) return aFits;
+        if (aFits) {
+            const int ra = profilePowerRank(a.candidate.profile);
+            const int rb = profilePowerRank(b.candidate.profile);
+            if (ra != rb) return ra < rb;
+        }
+    }
+    return a.p95Ms < b.p95Ms;
+}
+
+std::unique_ptr<ModelSession> RuntimeTuner::tune(const Factory& make, TuningDecision& out) {
+    static std::mutex tuneMu;
+    std::lock_guard<std::mutex> lk(tuneMu);
+    SNPE_TRACE_SCOPE("build", "tune");
+
+    measured_.clear();
+    std::unique_ptr<ModelSession> best;
+    size_t bestIdx = 0;
+    for (const auto& rt : opt_.runtimes) {
+        for (const auto& prof : opt_.profiles) {
+            Measurement m;
+            m.candidate = {rt, prof};
+            std::unique_ptr<ModelSession> s = make(m.candidate);
+            if (!s) {
+                // The runtime is missing, not the profile: skip its other profiles
+                LOGI_RT("[%s] %s: not available", opt_.model.c_str(), rt.c_str());
+                measured_.push_back(m);
+                break;
+            }
+            m.ok = measure(*s, opt_.warmup, opt_.iterations, m.p50Ms, m.p95Ms);
+            LOGI_RT("[%s] %s/%s: %s p50=%.2f ms p95=%.2f ms", opt_.model.c_str(), rt.c_str(), prof.c_str(),
+                    m.ok ? "ok" : "FAILED", m.p50Ms, m.p95Ms);
+            measured_.push_back(m);
+            if (m.ok && (!best || better_(m, measured_[bestIdx]))) {
+                best = std::move(s);
+                bestIdx = measured_.size() - 1;
+            }
+        }
+    }
+    if (!best) return nullptr;
+
+    const Measurement& w = measured_[bestIdx];
+    out.runtime = w.candidate.runtime;
+    out.profile = w.candidate.profile;
+    out.objective = opt_.objectiveTag();
+    out.p50Ms = w.p50Ms;
+    out.p95Ms = w.p95Ms;
+    LOGI_RT("[%s] tuned (%s): %s/%s p95=%.2f ms over %zu candidates", opt_.model.c_str(),
+            out.objective.c_str(), out.runtime.c_str(), out.profile.c_str(), out.p95Ms, measured_.size());
+    return best;
+}
+
+// ---------------------------------------------------------------- TuningTable
+
+static std::mutex& tableMutex() {
+    static std::mutex mu;
+    return mu;
+}
+
+// Lines other than the header and comments, by key
+static bool readTable(const std::string& path, std::vector<std::pair<std::string, TuningDecision>>& rows) {
+    std::ifstream ifs(path);
+    if (!ifs) return false;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream ls(line);
+        std::string key, p50, p95;
+        TuningDecision d;
+        if (!std::getline(ls, key, '\t') || !std::getline(ls, d.runtime, '\t') ||
+            !std::getline(ls, d.profile, '\t') || !std::getline(ls, d.objective, '\t') ||
+            !std::getline(ls, p50, '\t') || !std::getline(ls, p95)) {
+            continue;   // a malformed line is dropped, not fatal
+        }
+        d.p50Ms = std::atof(p50.c_str());
+        d.p95Ms = std::atof(p95.c_str());
+        rows.emplace_back(std::move(key), std::move(d));
+    }
+    return true;
+}
+
+std::string TuningTable::key(uint64_t modelHash, const std::string& libVersion) {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)modelHash);
+    std::string k = socIdentifier() + "/" + libVersion + "/" + hash;
+    for (char& c : k) if (c == '\t' || c == '\n') c = '_';
+    return k;
+}
+
+bool TuningTable::lookup(const std::string& path, const std::string& key, TuningDecision& out) {
+    std::lock_guard<std::mutex> lk(tableMutex());
+    std::vector<std::pair<std::string, TuningDecision>> rows;
+    if (!readTable(path, rows)) return false;
+    for (auto& r : rows) {
+        if (r.first != key) continue;
+        out = std::move(r.second);
+        return true;
+    }
+    return false;
+}
+
+bool TuningTable::store(const std::string& path, const std::string& key, const TuningDecision& d) {
+    std::lock_guard<std::mutex> lk(tableMutex());
+    std::vector<std::pair<std::string, TuningDecision>> rows;
+    readTable(path, rows);   // missing file: start a new one
+
+    static std::atomic<unsigned> seq{0};
+    const std::string tmp = path + ".tmp" + std::to_string(::getpid()) + "_" + std::to_string(seq++);
+    {
+        std::ofstream ofs(tmp, std::ios::trunc);
+        if (!ofs) {
+            LOGW_RT("Cannot write tuning table %s: %s", tmp.c_str(), std::strerror(errno));
+            return false;
+        }
+        ofs << kTableHeader << "\n";
+        char nums[64];
+        auto write = [&](const std::string& k, const TuningDecision& v) {
+            std::snprintf(nums, sizeof(nums), "%.3f\t%.3f", v.p50Ms, v.p95Ms);
+            ofs << k << '\t' << v.runtime << '\t' << v.profile << '\t' << v.objective << '\t' << nums << '\n';
+        };
+        for (const auto& r : rows) if (r.first != key) write(r.first, r.second);
+        write(key, d);
+        if (!ofs.flush()) {
+            ::unlink(tmp.c_str());
+            LOGW_RT("Writing tuning table %s failed", tmp.c_str());
+            return false;
+        }
+    }
+    if (::rename(tmp.c_str(), path.c_str()) != 0) {
+        LOGW_RT("rename(%s) failed: %s", tmp.c_str(), std::strerror(errno));
+        ::unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+TuningOptions makeTuningOptions(const TuningCfg& cfg, const std::string& table,
+                                const std::string& model) {
+    TuningOptions t;
+    t.enabled = cfg.enabled;
+    t.table = table;
+    t.model = model;
+    parseTuneObjective(cfg.objective, t.objective);
+    t.budgetMs = cfg.budgetMs;
+    t.warmup = cfg.warmup;
+    t.iterations = cfg.iterations;
+    if (!cfg.runtimes.empty()) t.runtimes = cfg.runtimes;
+    if (!cfg.profiles.empty()) t.profiles = cfg.profiles;
+    return t;
+}
+
+TuneResult resolveTuning(const TuningOptions& opt, const std::string& key,
+                         const RuntimeTuner::Factory& make, TuningDecision& out,
+                         std::unique_ptr<ModelSession>* session) {
+    if (opt.table.empty()) return TuneResult::NONE;
+    const std::string tag = opt.objectiveTag();
+    TuningDecision stored;
+    if (TuningTable::lookup(opt.table, key, stored)) {
+        if (stored.objective == tag) {
+            LOGI_RT("[%s] tuning table: %s/%s (p95=%.2f ms when tuned)", opt.model.c_str(),
+                    stored.runtime.c_str(), stored.profile.c_str(), stored.p95Ms);
+            out = std::move(stored);
+            return TuneResult::STORED;
+        }
+        LOGI_RT("[%s] stored decision was made for %s, not %s", opt.model.c_str(),
+                stored.objective.c_str(), tag.c_str());
+    }
+    if (!opt.enabled) return TuneResult::NONE;
+
+    RuntimeTuner tuner(opt);
+    std::unique_ptr<ModelSession> best = tuner.tune(make, out);
+    if (!best) {
+        LOGW_RT("[%s] no tuning candidate could run", opt.model.c_str());
+        return TuneResult::NONE;
+    }
+    if (!TuningTable::store(opt.table, key, out))
+        LOGW_RT("[%s] decision not persisted", opt.model.c_str());
+    if (session) *session = std::move(best);
+    return TuneResult::TUNED;
+}
+#endif
@@ -0,0 +1,209 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/ScoreReduce.hpp"
+#include "inc/hpp/Simd.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+constexpr float kNegInf = -std::numeric_limits<float>::infinity();
+
+// Strictly greater, so the first index of the maximum wins and NaN never does
+inline void takeMax(float v, int i, ScoreMax& m) {
+    if (v > m.value) { m.value = v; m.index = i; }
+}
+
+// Per-lane running max/index -> one ScoreMax (lowest index among equal lanes)
+inline void reduceLanes(const float* val, const int32_t* idx, ScoreMax& m) {
+    for (int l = 0; l < 4; ++l) {
+        if (idx[l] < 0) continue;
+        if (m.index < 0 || val[l] > m.value || (val[l] == m.value && idx[l] < m.index)) {
+            m.value = val[l];
+            m.index = idx[l];
+        }
+    }
+}
+
+#if SNPE_SIMD_NEON
+inline bool anyLane(uint32x4_t m) {
+    const uint32x2_t r = vorr_u32(vget_low_u32(m), vget_high_u32(m));
+    return (vget_lane_u32(r, 0) | vget_lane_u32(r, 1)) != 0;
+}
+inline void pushLanes(uint32x4_t m, int base, std::vector<int>& out) {
+    alignas(16) uint32_t l[4];
+    vst1q_u32(l, m);
+    for (int k = 0; k < 4; ++k) if (l[k]) out.push_back(base + k);
+}
+#elif SNPE_SIMD_SSE2
+inline void pushBits(int bits, int base, std::vector<int>& out) {
+    while (bits) {
+        out.push_back(base + __builtin_ctz(static_cast<unsigned>(bits)));
+        bits &= bits - 1;
+    }
+}
+#endif
+
+// Shared body of scoreArgmax/scoreCompactAbove/scoreScan; the flags are constants
+// at every call site, so the unused half compiles away.
+template <bool kMax, bool kCompact>
+void scan_(const float* row, size_t n, float threshold, ScoreMax* best, std::vector<int>* above) {
+    ScoreMax m;
+    m.value = kNegInf;
+    size_t i = 0;
+#if SNPE_SIMD_NEON
+    const float32x4_t T = vdupq_n_f32(threshold);
+    float32x4_t vMax = vdupq_n_f32(kNegInf);
+    int32x4_t vIdx = vdupq_n_s32(-1);
+    const int32_t lane0[4] = {0, 1, 2, 3};
+    int32x4_t vCur = vld1q_s32(lane0);
+    const int32x4_t four = vdupq_n_s32(4);
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t v = vld1q_f32(row + i);
+        if (kMax) {
+            const uint32x4_t gt = vcgtq_f32(v, vMax);
+            vMax = vbslq_f32(gt, v, vMax);
+            vIdx = vbslq_s32(gt, vCur, vIdx);
+            vCur = vaddq_s32(vCur, four);
+        }
+        if (kCompact) {
+            const uint32x4_t ge = vcgeq_f32(v, T);
+            if (anyLane(ge)) pushLanes(ge, static_cast<int>(i), *above);
+        }
+    }
+    if (kMax) {
+        alignas(16) float val[4];
+        alignas(16) int32_t idx[4];
+        vst1q_f32(val, vMax);
+        vst1q_s32(idx, vIdx);
+        reduceLanes(val, idx, m);
+    }
+#elif SNPE_SIMD_SSE2
+    const __m128 T = _mm_set1_ps(threshold);
+    __m128 vMax = _mm_set1_ps(kNegInf);
+    __m128i vIdx = _mm_set1_epi32(-1);
+    __m128i vCur = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i four = _mm_set1_epi32(4);
+    for (; i + 4 <= n; i += 4) {
+        const __m128 v = _mm_loadu_ps(row + i);
+        if (kMax) {
+            const __m128 gt = _mm_cmpgt_ps(v, vMax);
+            const __m128i gti = _mm_castps_si128(gt);
+            vMax = _mm_or_ps(_mm_and_ps(gt, v), _mm_andnot_ps(gt, vMax));
+            vIdx = _mm_or_si128(_mm_and_si128(gti, vCur), _mm_andnot_si128(gti, vIdx));
+            vCur = _mm_add_epi32(vCur, four);
+        }
+        if (kCompact) {
+            const int bits = _mm_movemask_ps(_mm_cmpge_ps(v, T));
+            if (bits) pushBits(bits, static_cast<int>(i), *above);
+        }
+    }
+    if (kMax) {
+        alignas(16) float val[4];
+        alignas(16) int32_t idx[4];
+        _mm_store_ps(val, vMax);
+        _mm_store_si128(reinterpret_cast<__m128i*>(idx), vIdx);
+        reduceLanes(val, idx, m);
+    }
+#endif
+    // Tail (everything without SIMD)
+    for (; i < n; ++i) {
+        if (kMax) takeMax(row[i], static_cast<int>(i), m);
+        if (kCompact && row[i] >= threshold) above->push_back(static_cast<int>(i));
+    }
+    if (kMax) *best = m.index < 0 ? ScoreMax() : m;
+}
+
+} // namespace
+
+ScoreMax scoreArgmax(const float* row, size_t n) {
+    ScoreMax m;
+    if (row) scan_<true, false>(row, n, 0.0f, &m, nullptr);
+    return m;
+}
+
+size_t scoreCountAbove(const float* row, size_t n, float threshold) {
+    if (!row) return 0;
+    size_t i = 0, count = 0;
+#if SNPE_SIMD_NEON
+    const float32x4_t T = vdupq_n_f32(threshold);
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; i + 4 <= n; i += 4) {
+        acc = vsubq_u32(acc, vcgeq_f32(vld1q_f32(row + i), T));   // true lanes are ~0 == -1
+    }
+    alignas(16) uint32_t l[4];
+    vst1q_u32(l, acc);
+    count = size_t(l[0]) + l[1] + l[2] + l[3];
+#elif SNPE_SIMD_SSE2
+    const __m128 T = _mm_set1_ps(threshold);
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_sub_epi32(acc, _mm_castps_si128(_mm_cmpge_ps(_mm_loadu_ps(row + i), T)));
+    }
+    alignas(16) uint32_t l[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(l), acc);
+    count = size_t(l[0]) + l[1] + l[2] + l[3];
+#endif
+    for (; i < n; ++i) count += row[i] >= threshold;
+    return count;
+}
+
+size_t scoreCompactAbove(const float* row, size_t n, float threshold, std::vector<int>& out) {
+    out.clear();
+    if (row) scan_<false, true>(row, n, threshold, nullptr, &out);
+    return out.size();
+}
+
+size_t scoreSortTopK(const float* row, std::vector<int>& idx, size_t k) {
+    if (k < idx.size()) {
+        // partial_sort is not stable: break ties by position explicitly
+        if (!std::is_sorted(idx.begin(), idx.end())) {
+            std::stable_sort(idx.begin(), idx.end(), [row](int a, int b) { return row[a] > row[b]; });
+        } else {
+            std::partial_sort(idx.begin(), idx.begin() + k, idx.end(), [row](int a, int b) {
+                return row[a] > row[b] || (row[a] == row[b] && a < b);
+            });
+        }
+        idx.resize(k);
+    } else {
+        std::stable_sort(idx.begin(), idx.end(), [row](int a, int b) { return row[a] > row[b]; });
+    }
+    return idx.size();
+}
+
+size_t scoreTopK(const float* row, size_t n, size_t k, std::vector<int>& out, float minScore) {
+    scoreCompactAbove(row, n, minScore, out);
+    return scoreSortTopK(row, out, k);
+}
+
+void scoreScan(const float* row, size_t n, float threshold, ScoreScan& out) {
+    out.threshold = threshold;
+    out.above.clear();
+    out.best = ScoreMax();
+    if (row) scan_<true, true>(row, n, threshold, &out.best, &out.above);
+}
+
+namespace scoreref {
+
+ScoreMax argmax(const float* row, size_t n) {
+    ScoreMax m;
+    m.value = kNegInf;
+    for (size_t i = 0; i < n; ++i) takeMax(row[i], static_cast<int>(i), m);
+    return m.index < 0 ? ScoreMax() : m;
+}
+
+size_t countAbove(const float* row, size_t n, float threshold) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) count += row[i] >= threshold;
+    return count;
+}
+
+size_t compactAbove(const float* row, size_t n, float threshold, std::vector<int>& out) {
+    out.clear();
+    for (size_t i = 0; i < n; ++i) if (row[i] >= threshold) out.push_back(static_cast<int>(i));
+    return out.size();
+}
+
+} // namespace scoreref
+#endif
@@ -0,0 +1,163 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/SessionResidency.hpp"
+#include "inc/hpp/Log.hpp"
+#include "inc/hpp/Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#define  LOG_TAG_SR  "SNPE_SR"
+#define  LOGI_SR(...)  SNPE_LOG(SNPE_LOG_INFO,LOG_TAG_SR,__VA_ARGS__)
+#define  LOGE_SR(...)  SNPE_LOG(SNPE_LOG_ERROR,LOG_TAG_SR,__VA_ARGS__)
+
+static const size_t kNoPos = ~size_t(0);
+
+SessionResidency::SessionResidency(std::vector<std::pair<size_t, ModelSession*>> order,
+                                   size_t maxResident)
+    : maxResident_(std::max<size_t>(maxResident, 1)) {
+    entries_.reserve(order.size());
+    for (const auto& o : order) {
+        if (o.first >= posOfNode_.size()) posOfNode_.resize(o.first + 1, kNoPos);
+        posOfNode_[o.first] = entries_.size();
+        entries_.push_back({o.first, o.second, o.second->ready() ? State::READY : State::RELEASED});
+    }
+    // Sessions built before the budget applied: keep the first maxResident in run order
+    size_t kept = 0;
+    for (auto& e : entries_) {
+        if (e.state != State::READY || ++kept <= maxResident_) continue;
+        e.session->reset();
+        e.state = State::RELEASED;
+    }
+    builder_ = std::thread([this] {
+        traceSetThreadName("session-prefetch");
+        loop_();
+    });
+    LOGI_SR("%zu sessions, at most %zu resident", entries_.size(), maxResident_);
+}
+
+SessionResidency::~SessionResidency() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+        queue_.clear();
+    }
+    cvWork_.notify_all();
+    builder_.join();
+    // Queued entries were never started
+    for (auto& e : entries_) if (e.state == State::QUEUED) e.state = State::RELEASED;
+}
+
+size_t SessionResidency::position_(size_t node) const {
+    return node < posOfNode_.size() ? posOfNode_[node] : kNoPos;
+}
+
+size_t SessionResidency::residentLocked_() const {
+    size_t n = 0;
+    for (const auto& e : entries_) n += e.state != State::RELEASED;
+    return n;
+}
+
+size_t SessionResidency::resident() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return residentLocked_();
+}
+
+SessionResidency::Stats SessionResidency::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return stats_;
+}
+
+void SessionResidency::prefetchAfter_(size_t pos) {
+    const size_t n = entries_.size();
+    size_t resident = residentLocked_();
+    // The next maxResident - 1 nodes in run order, wrapping into the next frame
+    for (size_t k = 1; k < std::min(maxResident_, n) && resident < maxResident_; ++k) {
+        Entry& e = entries_[(pos + k) % n];
+        if (e.state != State::RELEASED) continue;
+        e.state = State::QUEUED;
+        queue_.push_back((pos + k) % n);
+        ++resident;
+    }
+    if (!queue_.empty()) cvWork_.notify_one();
+}
+
+bool SessionResidency::acquire(size_t node) {
+    const size_t pos = position_(node);
+    if (pos == kNoPos) return false;
+    Entry& e = entries_[pos];
+
+    std::unique_lock<std::mutex> lk(mu_);
+    ++stats_.acquires;
+    if (e.state == State::BUILDING || e.state == State::RELEASING) {
+        SNPE_TRACE_SCOPE("session", "waitPrefetch");
+        const auto t0 = std::chrono::steady_clock::now();
+        cvState_.wait(lk, [&] { return e.state != State::BUILDING && e.state != State::RELEASING; });
+        stats_.waitNs += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - t0).count());
+    }
+    if (e.state == State::READY || e.state == State::IN_USE) {
+        if (e.state == State::READY) ++stats_.prefetchHits;
+        e.state = State::IN_USE;
+    } else {
+        // Released, or queued behind other prefetches: build it here
+        if (e.state == State::QUEUED) queue_.erase(std::find(queue_.begin(), queue_.end(), pos));
+        e.state = State::BUILDING;
+        ++stats_.inlineBuilds;
+        lk.unlock();
+        e.session->reCreate(nullptr);
+        lk.lock();
+        e.state = e.session->ready() ? State::IN_USE : State::RELEASED;
+        cvState_.notify_all();
+    }
+    const bool ok = e.state == State::IN_USE;
+    if (!ok) ++stats_.failed;
+    prefetchAfter_(pos);
+    return ok;
+}
+
+void SessionResidency::release(size_t node) {
+    const size_t pos = position_(node);
+    if (pos == kNoPos) return;
+    Entry& e = entries_[pos];
+
+    std::unique_lock<std::mutex> lk(mu_);
+    if (e.state != State::IN_USE) return;
+    if (entries_.size() <= maxResident_) {
+        e.state = State::READY;   // everything fits: keep it
+        return;
+    }
+    // Tear the graph down unlocked; the slot stays counted until it is gone
+    e.state = State::RELEASING;
+    lk.unlock();
+    e.session->reset();
+    lk.lock();
+    e.state = State::RELEASED;
+    cvState_.notify_all();
+    prefetchAfter_(pos);          // the freed slot goes to the next node in line
+}
+
+void SessionResidency::loop_() {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+        cvWork_.wait(lk, [this] { return stop_ || !queue_.empty(); });
+        if (stop_) return;
+        const size_t pos = queue_.front();
+        queue_.pop_front();
+        Entry& e = entries_[pos];
+        e.state = State::BUILDING;
+        lk.unlock();
+        {
+            SNPE_TRACE_SCOPE("session", "prefetch");
+            e.session->reCreate(nullptr);
+        }
+        lk.lock();
+        if (e.session->ready()) {
+            e.state = State::READY;
+        } else {
+            LOGE_SR("Prefetch of node %zu failed", e.node);
+            e.state = State::RELEASED;   // acquire() retries inline and reports it
+        }
+        cvState_.notify_all();
+    }
+}
+#endif
@@ -0,0 +1,446 @@
+#if PLATFORM_ANDROID
+//
+// SNPE implementation of IInferenceBackend (was the body of ModelSession).
+//
+#include "inc/hpp/SnpeBackend.hpp"
+#include "inc/hpp/CheckRuntime.hpp"
+#include "inc/hpp/Log.hpp"
+#include "inc/hpp/TensorConvert.hpp"
+
+#include "DlSystem/PlatformConfig.hpp"
+#include "DlSystem/IUserBufferFactory.hpp"
+
+#include <chrono>
+#include <cstring>
+
+#define  LOG_TAG_SB  "SNPE_MS"
+#define  LOGI_SB(...)  SNPE_LOG(SNPE_LOG_INFO,LOG_TAG_SB,__VA_ARGS__)
+#define  LOGE_SB(...)  SNPE_LOG(SNPE_LOG_ERROR,LOG_TAG_SB,__VA_ARGS__)
+
+static zdl::DlSystem::ProfilingLevel_t toSnpeProfiling(ProfilingLevel level) {
+    using zdl::DlSystem::ProfilingLevel_t;
+    switch (level) {
+        case ProfilingLevel::BASIC: return ProfilingLevel_t::BASIC;
+        case ProfilingLevel::MODERATE: return ProfilingLevel_t::MODERATE;
+        case ProfilingLevel::DETAILED: return ProfilingLevel_t::DETAILED;
+        default: return ProfilingLevel_t::OFF;
+    }
+}
+
+static zdl::DlSystem::IOBufferDataType_t toSnpeBufferType(TensorDataType t) {
+    using zdl::DlSystem::IOBufferDataType_t;
+    switch (t) {
+        case TensorDataType::FLOAT16: return IOBufferDataType_t::FLOATING_POINT_16;
+        case TensorDataType::UFIXED8: return IOBufferDataType_t::FIXED_POINT_8;
+        case TensorDataType::UFIXED16: return IOBufferDataType_t::FIXED_POINT_16;
+        default: return IOBufferDataType_t::FLOATING_POINT_32;
+    }
+}
+
+// UserBuffer encoding matching t.dataType (and its TfN parameters)
+static std::unique_ptr<zdl::DlSystem::UserBufferEncoding> makeEncoding(const TensorInfo& t) {
+    using namespace zdl::DlSystem;
+    switch (t.dataType) {
+        case TensorDataType::FLOAT16:
+            return std::unique_ptr<UserBufferEncoding>(new UserBufferEncodingFloatN(16));
+        case TensorDataType::UFIXED8:
+            return std::unique_ptr<UserBufferEncoding>(
+                    new UserBufferEncodingTfN(uint64_t(t.qOffset), t.qScale, 8));
+        case TensorDataType::UFIXED16:
+            return std::unique_ptr<UserBufferEncoding>(
+                    new UserBufferEncodingTfN(uint64_t(t.qOffset), t.qScale, 16));
+        default:
+            return std::unique_ptr<UserBufferEncoding>(new UserBufferEncodingFloat());
+    }
+}
+
+static const char* rtToStr(zdl::DlSystem::Runtime_t r) {
+    using zdl::DlSystem::Runtime_t;
+    switch (r) {
+        case Runtime_t::CPU: return "CPU";
+        case Runtime_t::GPU: return "GPU";
+        case Runtime_t::DSP: return "DSP";
+        case Runtime_t::AIP_FIXED_TF: return "AIP_FIXED_TF";
+        default: return "UNSET";
+    }
+}
+
+std::unique_ptr<SnpeBackend> SnpeBackend::Open(const uint8_t* dlc, size_t bytes,
+                                               std::shared_ptr<void> dlcOwner,
+                                               const Options& opt, std::string* buildLog) {
+    using clock = std::chrono::steady_clock;
+    std::unique_ptr<SnpeBackend> self(new SnpeBackend());
+    self->dlcOwner_ = std::move(dlcOwner);
+    self->opt_ = opt;
+
+    auto t1 = clock::now();
+    auto container = zdl::DlContainer::IDlContainer::open(dlc, bytes);
+    auto t2 = clock::now();
+    LOGI_SB("DLContainer open time: %lld",
+            (long long)std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count());
+    if (!container) {
+        if (buildLog) *buildLog += "Failed to open DLC container\n";
+        LOGE_SB("DLC open failed");
+        return nullptr;
+    }
+    self->container_ = std::move(container);
+
+    if (opt.dlcHash != 0) {
+        self->dlcHash_ = opt.dlcHash;
+    } else if (opt.initCache && !opt.initCacheDir.empty()) {
+        const auto h0 = clock::now();
+        self->dlcHash_ = InitCacheStore::hashBytes(dlc, bytes);
+        LOGI_SB("DLC hash %016llx (%zu bytes) in %lld ms", (unsigned long long)self->dlcHash_, bytes,
+                (long long)std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - h0).count());
+    }
+    return self;
+}
+
+bool SnpeBackend::build(std::string* buildLog) {
+    using clock = std::chrono::steady_clock;
+
+    zdl::DlSystem::RuntimeList order = opt_.runtimeOrder;
+    if (order.empty()) {
+        if (zdl::SNPE::SNPEFactory::isRuntimeAvailable(zdl::DlSystem::Runtime_t::DSP, zdl::DlSystem::RuntimeCheckOption_t::UNSIGNEDPD_CHECK) || zdl::SNPE::SNPEFactory::isRuntimeAvailable(zdl::DlSystem::Runtime_t::DSP)) {
+            order.add(zdl::DlSystem::Runtime_t::DSP);
+        } else {
+            order.add(zdl::DlSystem::Runtime_t::CPU);
+        }
+    }
+
+    // Choose runtime actually available (respect given order)
+    zdl::DlSystem::Runtime_t chosen = checkRuntime(order[0]);
+    runtimeName_ = rtToStr(chosen);
+    LOGI_SB("Selected runtime=%s", runtimeName_.c_str());
+
+    // Platform options (HTP PD / adaptive, etc.)
+    zdl::DlSystem::PlatformConfig platformConfig;
+    platformConfig.setPlatformOptions("useAdaptivePD:ON");
+
+    if (buildLog) {
+        auto names = order.getRuntimeListNames();
+        std::string s = "Runtime order: ";
+        for (const char* n : names) { s += n; s += " "; }
+        s += "\n";
+        *buildLog += s;
+    }
+
+    // Tell DSP which boundary buffers are not float32. Before the first build has
+    // listed the IO, "*" only reaches the tensors ParseConfig expanded it over.
+    zdl::DlSystem::IOBufferDataTypeMap bufferTypes;
+    const bool setBufferTypes = !opt_.ioTypes.empty() && chosen == zdl::DlSystem::Runtime_t::DSP;
+    if (setBufferTypes) addBufferDataTypes_(bufferTypes);
+
+    // Persisted init cache: the first build of this process tries the stored
+    // container, a build from the DLC stores the one SNPE prepared
+    const bool persist = opt_.initCache && !opt_.initCacheDir.empty();
+    InitCacheKey cacheKey;
+    if (persist) cacheKey = initCacheKey_();
+
+    auto t_builder0 = clock::now();
+    std::unique_ptr<zdl::SNPE::SNPE> newSnpe;
+    if (persist && !cacheLoaded_ && !cacheSaved_) {
+        newSnpe = buildFromInitCache_(cacheKey, order, platformConfig, setBufferTypes ? &bufferTypes : nullptr);
+    }
+    const bool fromDlc = !newSnpe;
+    if (fromDlc) {
+        zdl::SNPE::SNPEBuilder builder(container_.get());
+        newSnpe = configure_(builder, order, platformConfig, setBufferTypes ? &bufferTypes : nullptr).build();
+    }
+    auto t_builder1 = clock::now();
+    LOGI_SB("SNPE builder time: %lld",
+            (long long)std::chrono::duration_cast<std::chrono::milliseconds>(t_builder1 - t_builder0).count());
+
+    if (!newSnpe) {
+        if (buildLog) *buildLog += "SNPE build failed\n";
+        const char* lastError = zdl::DlSystem::getLastErrorString();
+        LOGE_SB("SNPE build failed: %s", lastError ? lastError : "<null>");
+        return false;
+    }
+
+    if (persist && fromDlc && !cacheLoaded_ && !cacheSaved_) saveInitCache_(cacheKey);
+
+    // Swap in new graph (old one is freed)
+    snpe_.swap(newSnpe);
+    if (inputs_.empty() && outputs_.empty()) captureIO_();
+    if (opt_.profiling != ProfilingLevel::OFF && !opt_.diagLogDir.empty()) startDiagLog_();
+    return true;
+}
+
+zdl::SNPE::SNPEBuilder& SnpeBackend::configure_(zdl::SNPE::SNPEBuilder& b,
+                                                const zdl::DlSystem::RuntimeList& order,
+                                                const zdl::DlSystem::PlatformConfig& platformConfig,
+                                                const zdl::DlSystem::IOBufferDataTypeMap* bufferTypes) const {
+    if (bufferTypes) b.setBufferDataType(*bufferTypes);
+    return b.setOutputLayers({})
+            .setPerformanceProfile(opt_.perf)
+            .setExecutionPriorityHint(zdl::DlSystem::ExecutionPriorityHint_t::HIGH)
+            .setRuntimeProcessorOrder(order)
+            .setUseUserSuppliedBuffers(opt_.useUserSuppliedBuffers)
+            .setPlatformConfig(platformConfig)
+            .setInitCacheMode(opt_.initCache)
+            .setProfilingLevel(toSnpeProfiling(opt_.profiling))
+            .setUnconsumedTensorsAsOutputs(true);
+}
+
+InitCacheKey SnpeBackend::initCacheKey_() const {
+    InitCacheKey key;
+    key.model = opt_.initCacheModel;
+    key.dlcHash = dlcHash_;
+    key.libVersion = zdl::SNPE::SNPEFactory::getLibraryVersion().toString();
+    key.runtime = runtimeName_;
+    key.socId = socIdentifier();
+    return key;
+}
+
+std::unique_ptr<zdl::SNPE::SNPE> SnpeBackend::buildFromInitCache_(
+        const InitCacheKey& key, const zdl::DlSystem::RuntimeList& order,
+        const zdl::DlSystem::PlatformConfig& platformConfig,
+        const zdl::DlSystem::IOBufferDataTypeMap* bufferTypes) {
+    InitCacheStore store(opt_.initCacheDir, opt_.initCacheMaxBytes);
+    const std::string path = store.find(key);
+    if (path.empty()) {
+        LOGI_SB("No init cache %s/%s yet", opt_.initCacheDir.c_str(), key.fileName().c_str());
+        return nullptr;
+    }
+    auto cached = zdl::DlContainer::IDlContainer::open(path);
+    if (!cached) {
+        LOGE_SB("Init cache %s unreadable, evicting", path.c_str());
+        store.evict(key);
+        return nullptr;
+    }
+
+    // validateCache() depends on every builder option, so configure first
+    zdl::SNPE::SNPEBuilder builder(cached.get());
+    configure_(builder, order, platformConfig, bufferTypes).setCacheCompatibilityMode(opt_.cacheCompatibility);
+    const Snpe_ErrorCode_t rc = builder.validateCache();
+    if (rc != SNPE_SUCCESS) {
+        LOGI_SB("Init cache %s rejected by validateCache (%d), evicting", path.c_str(), int(rc));
+        store.evict(key);
+        return nullptr;
+    }
+    auto snpe = builder.build();
+    if (!snpe) {
+        const char* lastError = zdl::DlSystem::getLastErrorString();
+        LOGE_SB("Build from init cache %s failed (%s), evicting", path.c_str(), lastError ? lastError : "<null>");
+        store.evict(key);
+        return nullptr;
+    }
+    // Rebuilds after release() keep using the prepared container
+    container_ = std::move(cached);
+    cacheLoaded_ = true;
+    LOGI_SB("Built from init cache %s", path.c_str());
+    return snpe;
+}
+
+void SnpeBackend::saveInitCache_(const InitCacheKey& key) {
+    const auto t0 = std::chrono::steady_clock::now();
+    InitCacheStore store(opt_.initCacheDir, opt_.initCacheMaxBytes);
+    cacheSaved_ = store.store(key, [this](const std::string& path) { return container_->save(path); });
+    LOGI_SB("Init cache save %s: %lld ms", cacheSaved_ ? "done" : "failed",
+            (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - t0).count());
+}
+
+void SnpeBackend::startDiagLog_() {
+    auto diag = snpe_->getDiagLogInterface();
+    if (!diag) {
+        LOGE_SB("Profiling requested but SNPE has no DiagLog interface");
+        return;
+    }
+    zdl::DiagLog::Options o = (*diag)->getOptions();
+    o.LogFileDirectory = opt_.diagLogDir;
+    o.LogFileName = opt_.diagLogName;
+    if (!(*diag)->setOptions(o) || !(*diag)->start()) {
+        LOGE_SB("DiagLog start failed (%s/%s)", opt_.diagLogDir.c_str(), opt_.diagLogName.c_str());
+        return;
+    }
+    LOGI_SB("Profiling %s: DiagLog in %s/%s", profilingLevelName(opt_.profiling),
+            opt_.diagLogDir.c_str(), opt_.diagLogName.c_str());
+}
+
+void SnpeBackend::setProfilingLevel(ProfilingLevel level) {
+    if (level == opt_.profiling) return;
+    opt_.profiling = level;
+    if (snpe_) LOGI_SB("Profiling level %s applies from the next build", profilingLevelName(level));
+}
+
+bool SnpeBackend::lastLayerTimings(std::vector<LayerTiming>& out) const {
+    out.clear();
+    if (opt_.profiling == ProfilingLevel::OFF) return false;
+    out.push_back({"(network)", runtimeName_, lastExecNs_});
+    return true;
+}
+
+bool SnpeBackend::run_(const zdl::DlSystem::UserBufferMap& in, const zdl::DlSystem::UserBufferMap& out) {
+    const auto t0 = std::chrono::steady_clock::now();
+    if (!snpe_->execute(in, out)) {
+        LOGE_SB("SNPE execute failed");
+        return false;
+    }
+    lastExecNs_ = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count());
+    return true;
+}
+
+void SnpeBackend::release() {
+    snpe_.reset();
+}
+
+void SnpeBackend::addBufferDataTypes_(zdl::DlSystem::IOBufferDataTypeMap& map) const {
+    TensorDataType type;
+    for (const auto& kv : opt_.ioTypes) {
+        if (kv.first != "*") map.add(kv.first.c_str(), toSnpeBufferType(kv.second));
+    }
+    for (const auto* v : {&inputs_, &outputs_}) {
+        for (const auto& t : *v) {
+            if (!opt_.ioTypes.count(t.name) && lookupDataType(opt_.ioTypes, t.name, type))
+                map.add(t.name.c_str(), toSnpeBufferType(type));
+        }
+    }
+}
+
+void SnpeBackend::captureIO_() {
+    using zdl::DlSystem::UserBufferEncoding;
+    auto probe = [&](const zdl::DlSystem::Optional<zdl::DlSystem::StringList>& namesOpt,
+                     std::vector<TensorInfo>& into) {
+        if (!namesOpt) return;
+        const auto& names = *namesOpt;
+        for (const char* n : names) {
+            auto attr = snpe_->getInputOutputBufferAttributes(n);
+            if (!attr) continue;
+            const auto& shape = (*attr)->getDims();
+            TensorInfo t;
+            t.name = n;
+            for (size_t i = 0; i < shape.rank(); ++i) t.dims.push_back(shape[i]);
+
+            TensorDataType type = TensorDataType::FLOAT32;
+            lookupDataType(opt_.ioTypes, t.name, type);
+            if (isQuantized(type)) {
+                // Quantization of the tensor as stored in the DLC; a different width
+                // requantizes the same range
+                const auto native = (*attr)->getEncodingType();
+                const int bits = type == TensorDataType::UFIXED16 ? 16 : 8;
+                if (native == UserBufferEncoding::ElementType_t::TF8 ||
+                    native == UserBufferEncoding::ElementType_t::TF16) {
+                    auto* tfn = static_cast<zdl::DlSystem::UserBufferEncodingTfN*>((*attr)->getEncoding());
+                    if ((native == UserBufferEncoding::ElementType_t::TF16) == (bits == 16)) {
+                        t.qScale = tfn->getQuantizedStepSize();
+                        t.qOffset = int32_t(tfn->getStepExactly0());
+                    } else {
+                        quantParamsForRange(tfn->getMin(), tfn->getMax(), type, t.qScale, t.qOffset);
+                    }
+                } else {
+                    LOGE_SB("'%s' has no quantization in the DLC, keeping float32 instead of %s",
+                            n, dataTypeName(type));
+                    type = TensorDataType::FLOAT32;
+                }
+            }
+            t.setDataType(type);
+            if (type != TensorDataType::FLOAT32) {
+                LOGI_SB("IO '%s': %s scale=%g offset=%d", n, dataTypeName(type), t.qScale, int(t.qOffset));
+            }
+            into.push_back(std::move(t));
+        }
+    };
+    probe(snpe_->getInputTensorNames(), inputs_);
+    probe(snpe_->getOutputTensorNames(), outputs_);
+}
+
+bool SnpeBackend::execute(const std::vector<const void*>& inputPtrs,
+                          const std::vector<void*>& outputPtrs) {
+    using namespace zdl::DlSystem;
+    if (!snpe_) {
+        LOGE_SB("execute() on a released session");
+        return false;
+    }
+
+    UserBufferMap inMap, outMap;
+    std::vector<std::unique_ptr<IUserBuffer>> ubKeepAlive;
+    std::vector<std::unique_ptr<UserBufferEncoding>> encKeepAlive;
+
+    auto addOne = [&](const TensorInfo& t, const void* ptr, UserBufferMap& map) -> bool {
+        if (!ptr) {
+            LOGE_SB("Null pointer for '%s'", t.name.c_str());
+            return false;
+        }
+        encKeepAlive.push_back(makeEncoding(t));
+        auto strides = computePackedStridesBytes(t.dims, t.elementBytes);
+        auto& ubFactory = zdl::SNPE::SNPEFactory::getUserBufferFactory();
+        auto ub = ubFactory.createUserBuffer(const_cast<void*>(ptr), t.bytes(), strides,
+                                             encKeepAlive.back().get());
+        if (!ub) {
+            LOGE_SB("Failed to create UserBuffer for %s", t.name.c_str());
+            return false;
+        }
+        map.add(t.name.c_str(), ub.get());
+        ubKeepAlive.push_back(std::move(ub));
+        return true;
+    };
+
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+        if (!addOne(inputs_[i], inputPtrs[i], inMap)) return false;
+    }
+    for (size_t i = 0; i < outputs_.size(); ++i) {
+        if (!addOne(outputs_[i], outputPtrs[i], outMap)) return false;
+    }
+
+    return run_(inMap, outMap);
+}
+
+bool SnpeBackend::bindOne_(const TensorInfo& t, const void* ptr, BoundBuffer& b,
+                           zdl::DlSystem::UserBufferMap& map) {
+    using namespace zdl::DlSystem;
+    if (!ptr) {
+        LOGE_SB("Null pointer for '%s'", t.name.c_str());
+        return false;
+    }
+    if (b.ub) {
+        if (b.ptr == ptr) return true;
+        // Block moved: retarget the existing buffer instead of recreating it
+        if (b.ub->setBufferAddress(const_cast<void*>(ptr))) {
+            b.ptr = ptr;
+            return true;
+        }
+        LOGI_SB("setBufferAddress failed for '%s', recreating UserBuffer", t.name.c_str());
+    }
+
+    b.enc = makeEncoding(t);
+    auto strides = computePackedStridesBytes(t.dims, t.elementBytes);
+    auto& ubFactory = zdl::SNPE::SNPEFactory::getUserBufferFactory();
+    auto ub = ubFactory.createUserBuffer(const_cast<void*>(ptr), t.bytes(), strides, b.enc.get());
+    if (!ub) {
+        LOGE_SB("Failed to create UserBuffer for %s", t.name.c_str());
+        return false;
+    }
+    map.add(t.name.c_str(), ub.get());
+    b.ub = std::move(ub);
+    b.ptr = ptr;
+    return true;
+}
+
+bool SnpeBackend::bind(const std::vector<const void*>& inputPtrs,
+                       const std::vector<void*>& outputPtrs) {
+    boundIn_.resize(inputs_.size());
+    boundOut_.resize(outputs_.size());
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+        if (!bindOne_(inputs_[i], inputPtrs[i], boundIn_[i], inMap_)) return false;
+    }
+    for (size_t i = 0; i < outputs_.size(); ++i) {
+        if (!bindOne_(outputs_[i], outputPtrs[i], boundOut_[i], outMap_)) return false;
+    }
+    return true;
+}
+
+void SnpeBackend::unbind() {
+    inMap_.clear();
+    outMap_.clear();
+    boundIn_.clear();
+    boundOut_.clear();
+}
+
+bool SnpeBackend::executeBound() {
+    if (!snpe_) return false;
+    return run_(inMap_, outMap_);
+}
+#endif
@@ -0,0 +1,119 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/TensorConvert.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+uint16_t floatToHalf(float f) {
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    const uint16_t sign = uint16_t((x >> 16) & 0x8000u);
+    const uint32_t absx = x & 0x7FFFFFFFu;
+    if (absx >= 0x7F800000u) {                              // inf / NaN (keep NaN quiet)
+        return uint16_t(sign | 0x7C00u | (absx > 0x7F800000u ? 0x200u : 0u));
+    }
+    if (absx >= 0x477FF000u) return uint16_t(sign | 0x7C00u);  // rounds past 65504
+    if (absx < 0x38800000u) {                               // half subnormal or zero
+        if (absx < 0x33000000u) return sign;                // below half the smallest subnormal
+        const uint32_t mant = (absx & 0x007FFFFFu) | 0x00800000u;
+        const int shift = 126 - int(absx >> 23);            // 14..24
+        const uint32_t q = mant >> shift;
+        const uint32_t rem = mant & ((1u << shift) - 1u);
+        const uint32_t half = 1u << (shift - 1);
+        return uint16_t(sign | (q + (rem > half || (rem == half && (q & 1u)))));
+    }
+    // Normal: rebias the exponent, round the 13 dropped mantissa bits to nearest even
+    const uint32_t r = absx - 0x38000000u;
+    return uint16_t(sign | ((r + 0x0FFFu + ((r >> 13) & 1u)) >> 13));
+}
+
+float halfToFloat(uint16_t h) {
+    const uint32_t sign = uint32_t(h & 0x8000u) << 16;
+    const uint32_t exp = (h >> 10) & 0x1Fu;
+    uint32_t mant = h & 0x3FFu;
+    uint32_t x;
+    if (exp == 0x1Fu) {
+        x = sign | 0x7F800000u | (mant << 13);
+    } else if (exp != 0) {
+        x = sign | ((exp + 112u) << 23) | (mant << 13);
+    } else if (mant == 0) {
+        x = sign;
+    } else {                                                // subnormal: normalize
+        int e = -1;
+        do { mant <<= 1; ++e; } while (!(mant & 0x400u));
+        x = sign | (uint32_t(112 - e) << 23) | ((mant & 0x3FFu) << 13);
+    }
+    float f;
+    std::memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+void quantParamsForRange(float minValue, float maxValue, TensorDataType type,
+                         float& qScale, int32_t& qOffset) {
+    const float qmax = type == TensorDataType::UFIXED16 ? 65535.0f : 255.0f;
+    minValue = std::min(minValue, 0.0f);
+    maxValue = std::max(maxValue, 0.0f);
+    if (maxValue - minValue < 1e-12f) maxValue = minValue + 1e-12f;
+    qScale = (maxValue - minValue) / qmax;
+    qOffset = int32_t(std::lround(-minValue / qScale));
+}
+
+namespace {
+
+template <typename Q>
+void dequantize(const Q* src, float scale, int32_t offset, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] = float(int32_t(src[i]) - offset) * scale;
+}
+
+template <typename Q>
+void quantize(const float* src, float scale, int32_t offset, Q* dst, size_t n) {
+    const float inv = 1.0f / scale;
+    const float hi = float(Q(~Q(0)));
+    for (size_t i = 0; i < n; ++i) {
+        const float q = std::nearbyint(src[i] * inv) + float(offset);
+        // The comparison is false for NaN, so NaN -> 0 (a NaN cast to Q is undefined)
+        dst[i] = Q(q > 0.0f ? std::min(q, hi) : 0.0f);
+    }
+}
+
+} // namespace
+
+void tensorToFloat(const void* src, const TensorInfo& info, float* dst, size_t n) {
+    switch (info.dataType) {
+        case TensorDataType::FLOAT32:
+            std::memcpy(dst, src, n * sizeof(float));
+            break;
+        case TensorDataType::FLOAT16: {
+            const uint16_t* h = static_cast<const uint16_t*>(src);
+            for (size_t i = 0; i < n; ++i) dst[i] = halfToFloat(h[i]);
+            break;
+        }
+        case TensorDataType::UFIXED8:
+            dequantize(static_cast<const uint8_t*>(src), info.qScale, info.qOffset, dst, n);
+            break;
+        case TensorDataType::UFIXED16:
+            dequantize(static_cast<const uint16_t*>(src), info.qScale, info.qOffset, dst, n);
+            break;
+    }
+}
+
+void tensorFromFloat(const float* src, const TensorInfo& info, void* dst, size_t n) {
+    switch (info.dataType) {
+        case TensorDataType::FLOAT32:
+            std::memcpy(dst, src, n * sizeof(float));
+            break;
+        case TensorDataType::FLOAT16: {
+            uint16_t* h = static_cast<uint16_t*>(dst);
+            for (size_t i = 0; i < n; ++i) h[i] = floatToHalf(src[i]);
+            break;
+        }
+        case TensorDataType::UFIXED8:
+            quantize(src, info.qScale, info.qOffset, static_cast<uint8_t*>(dst), n);
+            break;
+        case TensorDataType::UFIXED16:
+            quantize(src, info.qScale, info.qOffset, static_cast<uint16_t*>(dst), n);
+            break;
+    }
+}
+#endif
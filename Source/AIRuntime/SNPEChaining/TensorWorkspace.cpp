@@ -1,73 +1,237 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 //
 // Created by Chiheb Boussema on 16/9/25.
 //
 #include "inc/hpp/TensorWorkspace.hpp"
 
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// One anonymous mapping; blocks are carved from it with a bump pointer.
+struct TensorWorkspace::Arena {
+    void*    map = nullptr;
+    size_t   mapLen = 0;
+    uint8_t* base = nullptr;   // first aligned byte
+    size_t   capacity = 0;
+    size_t   used = 0;
+
+    ~Arena() { if (map) ::munmap(map, mapLen); }
+
+    uint8_t* carve(size_t bytes, size_t alignment) {
+        size_t off = (used + alignment - 1) / alignment * alignment;
+        if (off + bytes > capacity) return nullptr;
+        used = off + bytes;
+        return base + off;
+    }
+};
+
+static bool isPow2(size_t v) { return v && (v & (v - 1)) == 0; }
+
+std::shared_ptr<TensorWorkspace::Arena>
+TensorWorkspace::makeArena_(size_t capacity, size_t alignment, ArenaAdvice advice,
+                            std::string* emsg) const {
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGE_SIZE));
+    // mmap is page aligned; only larger alignments need slack
+    const size_t slack = alignment > page ? alignment : 0;
+    const size_t len = (capacity + slack + page - 1) / page * page;
+    void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        if (emsg) *emsg = "mmap of " + std::to_string(len) + " byte arena failed: " + std::strerror(errno);
+        return nullptr;
+    }
+    if (advice == ArenaAdvice::WILLNEED) {
+        ::madvise(p, len, MADV_WILLNEED);
+    } else if (advice == ArenaAdvice::HUGEPAGE) {
+#ifdef MADV_HUGEPAGE
+        ::madvise(p, len, MADV_HUGEPAGE);
+#endif
+    }
+    auto a = std::make_shared<Arena>();
+    a->map = p;
+    a->mapLen = len;
+    auto addr = reinterpret_cast<uintptr_t>(p);
+    a->base = static_cast<uint8_t*>(p) + ((alignment - addr % alignment) % alignment);
+    a->capacity = capacity;
+    return a;
+}
+
+bool TensorWorkspace::reserveArena(const ArenaOptions& opt, std::string* emsg) {
+    if (!isPow2(opt.alignment)) {
+        if (emsg) *emsg = "arena alignment must be a power of two";
+        return false;
+    }
+    alignment_ = opt.alignment;
+    advice_ = opt.advice;
+    arena_.reset();
+    if (opt.capacity == 0) return true;
+
+    arena_ = makeArena_(opt.capacity, opt.alignment, opt.advice, emsg);
+    if (!arena_) {
+        LOGE_WS("reserveArena(%zu): %s", opt.capacity, emsg ? emsg->c_str() : "failed");
+        return false;
+    }
+    LOGI_WS("Reserved %zu byte arena (alignment %zu)", opt.capacity, opt.alignment);
+    return true;
+}
+
+size_t TensorWorkspace::arenaUsed() const { return arena_ ? arena_->used : 0; }
+size_t TensorWorkspace::arenaCapacity() const { return arena_ ? arena_->capacity : 0; }
+
+TensorWorkspace::TensorId TensorWorkspace::intern(const std::string& name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) return it->second;
+    const TensorId id = static_cast<TensorId>(entries_.size());
+    entries_.emplace_back();
+    entries_.back().name = name;
+    ids_.emplace(name, id);
+    return id;
+}
+
+TensorWorkspace::TensorId TensorWorkspace::find(const std::string& name) const {
+    auto it = ids_.find(name);
+    return it == ids_.end() ? kInvalidTensor : it->second;
+}
+
+const std::string& TensorWorkspace::nameOf(TensorId id) const {
+    static const std::string kEmpty;
+    return id < entries_.size() ? entries_[id].name : kEmpty;
+}
+
+const TensorWorkspace::Entry* TensorWorkspace::entry_(const std::string& name) const {
+    auto it = ids_.find(name);
+    if (it == ids_.end()) return nullptr;
+    const Entry& e = entries_[it->second];
+    return e.block ? &e : nullptr;
+}
+
 void* TensorWorkspace::allocate(const std::string& name, size_t bytes) {
-    auto it = m_.find(name);
-    if (it != m_.end()) {
+    Entry& e = entries_[intern(name)];
+    if (e.block) {
         // strict: must match size and be owner
-        if (!it->second.owner) {
+        if (!e.owner) {
             LOGE_WS("allocate('%s'): name already aliasing another block", name.c_str());
             return nullptr;
         }
-        if (it->second.block->size != bytes) {
+        if (e.block->size != bytes) {
             LOGE_WS("allocate('%s'): size mismatch (had %zu, want %zu)", name.c_str(),
-                    it->second.block->size, bytes);
+                    e.block->size, bytes);
             return nullptr;
         }
-        return it->second.block->bytes.get();
+        return e.block->base;
     }
     auto blk = std::make_shared<Block>();
-    blk->bytes.reset(new uint8_t[bytes]);
+    if (arena_) {
+        blk->base = arena_->carve(bytes, alignment_);
+        if (blk->base) blk->arena = arena_;
+        else LOGI_WS("allocate('%s'): %zu bytes do not fit the arena, using heap", name.c_str(), bytes);
+    }
+    if (!blk->base) {
+        blk->bytes.reset(new uint8_t[bytes + alignment_ - 1]);
+        auto addr = reinterpret_cast<uintptr_t>(blk->bytes.get());
+        blk->base = blk->bytes.get() + ((alignment_ - addr % alignment_) % alignment_);
+    }
     blk->size = bytes;
-    Entry e; e.owner = true; e.block = blk;
-    m_[name] = std::move(e);
-    return blk->bytes.get();
+    e.owner = true;
+    e.ownerKey.clear();
+    e.block = blk;
+    ++generation_;
+    return blk->base;
 }
 
 void TensorWorkspace::alias(const std::string& dstName, const std::string& srcName) {
-    auto it = m_.find(srcName);
-    if (it == m_.end()) {
+    const Entry* src = entry_(srcName);
+    if (!src) {
         LOGE_WS("alias('%s' <- '%s'): src not found", dstName.c_str(), srcName.c_str());
         return;
     }
-    Entry e; e.owner = false; e.ownerKey = srcName; e.block = it->second.block;
-    m_[dstName] = std::move(e);
+    std::shared_ptr<Block> blk = src->block; // copy before intern() may grow entries_
+    Entry& e = entries_[intern(dstName)];
+    e.owner = false;
+    e.ownerKey = srcName;
+    e.block = std::move(blk);
+    ++generation_;
 }
 
 void* TensorWorkspace::data(const std::string& name) const {
-    auto it = m_.find(name);
-    if (it == m_.end()) return nullptr;
-    return it->second.block ? it->second.block->bytes.get() : nullptr;
+    const Entry* e = entry_(name);
+    return e ? e->block->base : nullptr;
 }
 
 size_t TensorWorkspace::sizeOf(const std::string& name) const {
-    auto it = m_.find(name);
-    if (it == m_.end() || !it->second.block) return 0;
-    return it->second.block->size;
+    const Entry* e = entry_(name);
+    return e ? e->block->size : 0;
 }
 
 void TensorWorkspace::release(const std::string& name) {
-    auto it = m_.find(name);
-    if (it == m_.end()) return;
+    auto it = ids_.find(name);
+    if (it == ids_.end() || !entries_[it->second].block) return;
     // If owner, drop shared_ptr (aliases will see it go null when last ref ends)
-    // If alias, just erase entry.
-    m_.erase(it);
+    // If alias, just forget the mapping. The id stays reserved for this name.
+    Entry& e = entries_[it->second];
+    e.block.reset();
+    e.owner = false;
+    e.ownerKey.clear();
+    ++generation_;
 }
 
 void TensorWorkspace::dump() const {
     LOGI_WS("Workspace dump:");
-    for (auto& kv : m_) {
-        const auto& k = kv.first;
-        const auto& e = kv.second;
-        LOGI_WS("  %s  owner=%d  size=%zu", k.c_str(), int(e.owner),
-                e.block ? e.block->size : 0);
+    for (const auto& e : entries_) {
+        if (!e.block) continue;
+        LOGI_WS("  %s  owner=%d  size=%zu", e.name.c_str(), int(e.owner), e.block->size);
     }
 }
 
 bool TensorWorkspace::has(const std::string& name) const {
-    return m_.find(name) != m_.end();
+    return entry_(name) != nullptr;
+}
+
+std::string TensorWorkspace::ownerName(const std::string& name) const {
+    std::string cur = name;
+    for (size_t hops = 0; hops <= entries_.size(); ++hops) {
+        const Entry* e = entry_(cur);
+        if (!e) return {};
+        if (e->owner) return cur;
+        cur = e->ownerKey;
+    }
+    return {}; // alias cycle
+}
+
+bool TensorWorkspace::applyPlan(const MemoryPlan& plan, std::string* emsg) {
+    // Validate first so a bad plan leaves the workspace untouched
+    for (const auto& s : plan.slots) {
+        const Entry* e = entry_(s.name);
+        if (!e || !e->owner) {
+            if (emsg) *emsg = "applyPlan: '" + s.name + "' is not an owned block";
+            return false;
+        }
+        if (e->block->size != s.bytes) {
+            if (emsg) *emsg = "applyPlan: size mismatch for '" + s.name + "'";
+            return false;
+        }
+    }
+
+    const size_t align = isPow2(plan.alignment) ? plan.alignment : alignment_;
+    auto arena = makeArena_(plan.arenaBytes, align, advice_, emsg);
+    if (!arena) return false;
+    arena->used = plan.arenaBytes;
+    uint8_t* base = arena->base; // anonymous mapping: already zeroed
+
+    for (const auto& s : plan.slots) {
+        Block& blk = *entry_(s.name)->block;
+        uint8_t* dst = base + s.offset;
+        if (s.pinned) std::memcpy(dst, blk.base, s.bytes);
+        blk.bytes.reset();
+        blk.arena = arena;
+        blk.base = dst;
+    }
+    ++generation_;
+
+    LOGI_WS("Planned %zu tensors into one arena: peak=%zu bytes, naive=%zu bytes (%.1f%%)",
+            plan.slots.size(), plan.arenaBytes, plan.naiveBytes,
+            plan.naiveBytes ? 100.0 * plan.arenaBytes / plan.naiveBytes : 100.0);
+    return true;
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,196 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/Trace.hpp"
+#include "inc/hpp/Log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define  LOG_TAG_TR  "SNPE_TRACE"
+#define  LOGI_TR(...)  SNPE_LOG(SNPE_LOG_INFO,LOG_TAG_TR,__VA_ARGS__)
+#define  LOGE_TR(...)  SNPE_LOG(SNPE_LOG_ERROR,LOG_TAG_TR,__VA_ARGS__)
+
+std::atomic<bool> g_traceEnabled{false};
+
+namespace {
+
+struct TraceEvent {
+    uint64_t startNs;
+    uint64_t durNs;
+    int64_t arg;
+    const char* cat;
+    const char* argName;
+    char name[48];
+};
+
+// Written only by its thread; head is published with release so a reader sees
+// complete events below it. Buffers live until process exit so finished
+// threads still show up in a dump.
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    char threadName[32] = {};
+    std::unique_ptr<TraceEvent[]> events{new TraceEvent[kTraceEventsPerThread]};
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};  // events below this index were cleared
+};
+
+struct Registry {
+    std::mutex mu;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& registry() {
+    static Registry* r = new Registry();  // leaked: threads may record during static destruction
+    return *r;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+thread_local char t_threadName[32] = {};  // kept until the buffer exists
+
+ThreadBuffer& threadBuffer() {
+    if (!t_buffer) {
+        auto b = std::make_unique<ThreadBuffer>();
+        std::memcpy(b->threadName, t_threadName, sizeof(b->threadName));
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lk(r.mu);
+        b->tid = uint32_t(r.buffers.size() + 1);
+        t_buffer = b.get();
+        r.buffers.push_back(std::move(b));
+    }
+    return *t_buffer;
+}
+
+void appendEscaped(std::string& out, const char* s) {
+    for (; *s; ++s) {
+        const unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') { out += '\\'; out += char(c); }
+        else if (c < 0x20) { char u[8]; std::snprintf(u, sizeof(u), "\\u%04x", c); out += u; }
+        else out += char(c);
+    }
+}
+
+} // namespace
+
+uint64_t traceNowNs() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void traceStart() {
+    g_traceEnabled.store(true, std::memory_order_relaxed);
+    LOGI_TR("Tracing started");
+}
+
+void traceStop() {
+    g_traceEnabled.store(false, std::memory_order_relaxed);
+    LOGI_TR("Tracing stopped");
+}
+
+void traceClear() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.mu);
+    for (auto& b : r.buffers) b->tail.store(b->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+void traceSetThreadName(const char* name) {
+    std::strncpy(t_threadName, name ? name : "", sizeof(t_threadName) - 1);
+    t_threadName[sizeof(t_threadName) - 1] = '\0';
+    if (!t_buffer) return;  // no buffer (and no memory) until the thread records
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.mu);  // readers copy names under the same lock
+    std::memcpy(t_buffer->threadName, t_threadName, sizeof(t_threadName));
+}
+
+void traceRecord(const char* cat, const char* name, uint64_t startNs, uint64_t endNs,
+                 const char* argName, int64_t arg) {
+    ThreadBuffer& b = threadBuffer();
+    const uint64_t h = b.head.load(std::memory_order_relaxed);
+    TraceEvent& e = b.events[h % kTraceEventsPerThread];
+    e.startNs = startNs;
+    e.durNs = endNs > startNs ? endNs - startNs : 0;
+    e.arg = arg;
+    e.cat = cat;
+    e.argName = argName;
+    std::strncpy(e.name, name ? name : "", sizeof(e.name) - 1);
+    e.name[sizeof(e.name) - 1] = '\0';
+    b.head.store(h + 1, std::memory_order_release);
+}
+
+std::string traceChromeJson() {
+    struct ThreadDump { uint32_t tid; std::string name; std::vector<TraceEvent> events; };
+    std::vector<ThreadDump> dumps;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lk(r.mu);
+        dumps.reserve(r.buffers.size());
+        for (auto& b : r.buffers) {
+            ThreadDump d;
+            d.tid = b->tid;
+            d.name = b->threadName[0] ? b->threadName : "thread-" + std::to_string(b->tid);
+            const uint64_t h1 = b->head.load(std::memory_order_acquire);
+            uint64_t begin = std::max(b->tail.load(std::memory_order_relaxed),
+                                      h1 > kTraceEventsPerThread ? h1 - kTraceEventsPerThread : 0);
+            d.events.reserve(size_t(h1 - std::min(begin, h1)));
+            for (uint64_t i = begin; i < h1; ++i) d.events.push_back(b->events[i % kTraceEventsPerThread]);
+            // The writer may have lapped the oldest entries (and be writing index h2) meanwhile
+            const uint64_t h2 = b->head.load(std::memory_order_acquire);
+            const uint64_t valid = h2 + 1 > kTraceEventsPerThread ? h2 + 1 - kTraceEventsPerThread : 0;
+            if (valid > begin) {
+                const size_t drop = size_t(std::min<uint64_t>(valid - begin, d.events.size()));
+                d.events.erase(d.events.begin(), d.events.begin() + drop);
+            }
+            dumps.push_back(std::move(d));
+        }
+    }
+
+    uint64_t base = ~uint64_t(0);
+    for (auto& d : dumps) for (auto& e : d.events) base = std::min(base, e.startNs);
+
+    std::string out;
+    out.reserve(256 + 160 * [&] { size_t n = 0; for (auto& d : dumps) n += d.events.size(); return n; }());
+    out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char num[96];
+    for (auto& d : dumps) {
+        out += first ? "\n" : ",\n";
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(d.tid) + ",\"args\":{\"name\":\"";
+        appendEscaped(out, d.name.c_str());
+        out += "\"}}";
+        for (auto& e : d.events) {
+            out += ",\n{\"name\":\"";
+            appendEscaped(out, e.name);
+            out += "\",\"cat\":\"";
+            appendEscaped(out, e.cat ? e.cat : "");
+            std::snprintf(num, sizeof(num), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+                          double(e.startNs - base) * 1e-3, double(e.durNs) * 1e-3, d.tid);
+            out += num;
+            if (e.argName) {
+                out += ",\"args\":{\"";
+                appendEscaped(out, e.argName);
+                out += "\":" + std::to_string(e.arg) + "}";
+            }
+            out += "}";
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool traceWriteChromeJson(const std::string& path, std::string* emsg) {
+    const std::string json = traceChromeJson();
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    if (!ofs || !ofs.write(json.data(), std::streamsize(json.size()))) {
+        LOGE_TR("Cannot write trace to %s", path.c_str());
+        if (emsg) *emsg = "cannot write " + path;
+        return false;
+    }
+    LOGI_TR("Trace written to %s (%zu bytes)", path.c_str(), json.size());
+    return true;
+}
+#endif
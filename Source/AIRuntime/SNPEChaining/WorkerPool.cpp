@@ -0,0 +1,58 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#include "inc/hpp/WorkerPool.hpp"
+#include "inc/hpp/Trace.hpp"
+
+#include <string>
+
+WorkerPool::WorkerPool(size_t threads) {
+    if (threads == 0) threads = 1;
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this, i] {
+            traceSetThreadName(("pool-" + std::to_string(i)).c_str());
+            loop_();
+        });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cvTask_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void WorkerPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        queue_.push_back(std::move(task));
+        ++pending_;
+    }
+    cvTask_.notify_one();
+}
+
+void WorkerPool::wait() {
+    std::unique_lock<std::mutex> lk(mu_);
+    cvIdle_.wait(lk, [this] { return pending_ == 0; });
+}
+
+void WorkerPool::loop_() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            cvTask_.wait(lk, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) return; // stop_ and drained
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            if (--pending_ == 0) cvIdle_.notify_all();
+        }
+    }
+}
+#endif
@@ -0,0 +1,387 @@
+#if SNPE_CHAINING_HOST
+#pragma once
+// Minimal Google-Benchmark-style harness for the host build: same loop idiom,
+// flag names and JSON layout (so the usual compare tooling reads the output),
+// without the external dependency.
+//
+//   static void BM_Foo(mb::State& st) { for (auto _ : st) mb::doNotOptimize(foo()); }
+//   MB_BENCHMARK(BM_Foo)->arg(1)->arg(16);
+//   int main(int argc, char** argv) { return mb::runMain(argc, argv); }
+//
+// Flags: --benchmark_filter=<regex> --benchmark_min_time=<s> --benchmark_repetitions=<n>
+//        --benchmark_format=console|json --benchmark_out=<file>
+//        --benchmark_baseline=<file.json> --benchmark_max_regression=<fraction>
+// With a baseline, every benchmark present in both runs is compared on its fastest
+// real_time and the process exits with 1 if any got slower by more than the allowed
+// fraction (default 0.10).
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace mb {
+
+template <typename T>
+inline void doNotOptimize(T const& value) { asm volatile("" : : "r,m"(value) : "memory"); }
+inline void clobberMemory() { asm volatile("" : : : "memory"); }
+
+class State {
+public:
+    State(uint64_t iterations, std::vector<int64_t> args)
+        : iterations_(iterations), args_(std::move(args)) {}
+
+    struct Iterator {
+        State* st;
+        uint64_t left;
+        bool operator!=(const Iterator&) {
+            if (left != 0) return true;
+            st->stop_();
+            return false;
+        }
+        void operator++() { --left; }
+        int operator*() const { return 0; }
+    };
+    Iterator begin() { start_(); return Iterator{this, iterations_}; }
+    Iterator end() { return Iterator{this, 0}; }
+
+    int64_t range(size_t i = 0) const { return i < args_.size() ? args_[i] : 0; }
+    uint64_t iterations() const { return iterations_; }
+
+    // Exclude setup inside the loop from the measurement
+    void pauseTiming() { pausedAt_ = now_(); pausedCpuAt_ = cpu_(); }
+    void resumeTiming() { excluded_ += now_() - pausedAt_; excludedCpu_ += cpu_() - pausedCpuAt_; }
+
+    void setItemsProcessed(int64_t n) { items_ = n; }
+    void setBytesProcessed(int64_t n) { bytes_ = n; }
+    void setLabel(const std::string& l) { label_ = l; }
+    void skipWithError(const std::string& e) { error_ = e; }
+    std::map<std::string, double> counters;
+
+    // Results
+    double realNs() const { return realNs_; }
+    double cpuNs() const { return cpuNs_; }
+    int64_t items() const { return items_; }
+    int64_t bytes() const { return bytes_; }
+    const std::string& label() const { return label_; }
+    const std::string& error() const { return error_; }
+
+private:
+    static double now_() {
+        return std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    static double cpu_() {
+        timespec ts{};
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return double(ts.tv_sec) * 1e9 + double(ts.tv_nsec);
+    }
+    void start_() { t0_ = now_(); c0_ = cpu_(); }
+    void stop_() {
+        realNs_ = now_() - t0_ - excluded_;
+        cpuNs_ = cpu_() - c0_ - excludedCpu_;
+    }
+
+    uint64_t iterations_;
+    std::vector<int64_t> args_;
+    double t0_ = 0, c0_ = 0, pausedAt_ = 0, pausedCpuAt_ = 0, excluded_ = 0, excludedCpu_ = 0;
+    double realNs_ = 0, cpuNs_ = 0;
+    int64_t items_ = 0, bytes_ = 0;
+    std::string label_, error_;
+};
+
+class Benchmark {
+public:
+    using Fn = std::function<void(State&)>;
+    Benchmark(std::string name, Fn fn) : name_(std::move(name)), fn_(std::move(fn)) {}
+
+    Benchmark* arg(int64_t a) { args_.push_back({a}); return this; }
+    Benchmark* args(std::vector<int64_t> a) { args_.push_back(std::move(a)); return this; }
+
+    const std::string& name() const { return name_; }
+    const Fn& fn() const { return fn_; }
+    const std::vector<std::vector<int64_t>>& argSets() const { return args_; }
+
+private:
+    std::string name_;
+    Fn fn_;
+    std::vector<std::vector<int64_t>> args_;
+};
+
+inline std::vector<std::unique_ptr<Benchmark>>& registry() {
+    static std::vector<std::unique_ptr<Benchmark>> r;
+    return r;
+}
+
+inline Benchmark* registerBenchmark(const char* name, Benchmark::Fn fn) {
+    registry().emplace_back(new Benchmark(name, std::move(fn)));
+    return registry().back().get();
+}
+
+#define MB_CONCAT2_(a, b) a##b
+#define MB_CONCAT_(a, b) MB_CONCAT2_(a, b)
+#define MB_BENCHMARK(fn) \
+    static ::mb::Benchmark* MB_CONCAT_(mb_reg_, __LINE__) = ::mb::registerBenchmark(#fn, fn)
+
+struct Run {
+    std::string name;
+    std::string runType = "iteration";      // or "aggregate"
+    std::string aggregate;                  // mean / median / stddev
+    uint64_t iterations = 0;
+    double realNs = 0, cpuNs = 0;           // per iteration
+    double itemsPerSec = 0, bytesPerSec = 0;
+    std::map<std::string, double> counters;
+    std::string label, error;
+};
+
+struct Options {
+    std::string filter = ".";
+    double minTime = 0.2;
+    int repetitions = 1;
+    bool json = false;
+    std::string out;
+    std::string baseline;
+    double maxRegression = 0.10;
+};
+
+inline Run measure(const Benchmark& b, const std::string& name, const std::vector<int64_t>& args,
+                   double minTime) {
+    Run r;
+    r.name = name;
+    uint64_t iters = 1;
+    for (;;) {
+        State st(iters, args);
+        b.fn()(st);
+        if (!st.error().empty()) { r.error = st.error(); return r; }
+        const double secs = st.realNs() * 1e-9;
+        if (secs >= minTime || iters >= (uint64_t(1) << 40)) {
+            r.iterations = iters;
+            r.realNs = st.realNs() / double(iters);
+            r.cpuNs = st.cpuNs() / double(iters);
+            if (st.items()) r.itemsPerSec = double(st.items()) / secs;
+            if (st.bytes()) r.bytesPerSec = double(st.bytes()) / secs;
+            r.counters = st.counters;
+            r.label = st.label();
+            return r;
+        }
+        // Aim 40% past the target, growing at most 10x per round (as Google Benchmark does)
+        const double scale = secs > 0 ? (minTime * 1.4) / secs : 10.0;
+        iters = uint64_t(std::max<double>(double(iters) + 1, std::min(double(iters) * 10, std::ceil(double(iters) * scale))));
+    }
+}
+
+inline std::vector<Run> aggregate(const std::vector<Run>& reps) {
+    std::vector<Run> out;
+    if (reps.size() < 2) return out;
+    auto stat = [&](const char* what, double (*pick)(const std::vector<double>&)) {
+        Run a = reps[0];
+        a.runType = "aggregate";
+        a.aggregate = what;
+        a.name = reps[0].name + "_" + what;
+        std::vector<double> real, cpu;
+        for (auto& r : reps) { real.push_back(r.realNs); cpu.push_back(r.cpuNs); }
+        a.realNs = pick(real);
+        a.cpuNs = pick(cpu);
+        out.push_back(a);
+    };
+    stat("mean", [](const std::vector<double>& v) {
+        double s = 0; for (double x : v) s += x; return s / double(v.size()); });
+    stat("median", [](const std::vector<double>& v) {
+        std::vector<double> s = v; std::sort(s.begin(), s.end());
+        return s.size() % 2 ? s[s.size() / 2] : 0.5 * (s[s.size() / 2 - 1] + s[s.size() / 2]); });
+    stat("stddev", [](const std::vector<double>& v) {
+        double m = 0; for (double x : v) m += x; m /= double(v.size());
+        double q = 0; for (double x : v) q += (x - m) * (x - m);
+        return std::sqrt(q / double(v.size() - 1)); });
+    return out;
+}
+
+inline std::string jsonEscape(const std::string& s) {
+    std::string o;
+    for (char c : s) {
+        if (c == '"' || c == '\\') { o += '\\'; o += c; }
+        else if (c == '\n') o += "\\n";
+        else o += c;
+    }
+    return o;
+}
+
+inline std::string toJson(const std::vector<Run>& runs, const char* contextExtra) {
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+    char date[64];
+    std::time_t t = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&t));
+
+    std::ostringstream os;
+    os.precision(10);
+    os << "{\n  \"context\": {\n"
+       << "    \"date\": \"" << date << "\",\n"
+       << "    \"host_name\": \"" << jsonEscape(host) << "\",\n"
+       << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+       << "    \"library_build_type\": \"release\"";
+#else
+       << "    \"library_build_type\": \"debug\"";
+#endif
+    if (contextExtra && *contextExtra) os << ",\n    " << contextExtra;
+    os << "\n  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const Run& r = runs[i];
+        os << (i ? ",\n" : "\n") << "    {\n"
+           << "      \"name\": \"" << jsonEscape(r.name) << "\",\n"
+           << "      \"run_type\": \"" << r.runType << "\",\n";
+        if (!r.aggregate.empty()) os << "      \"aggregate_name\": \"" << r.aggregate << "\",\n";
+        if (!r.error.empty()) {
+            os << "      \"error_occurred\": true,\n"
+               << "      \"error_message\": \"" << jsonEscape(r.error) << "\"\n    }";
+            continue;
+        }
+        os << "      \"iterations\": " << r.iterations << ",\n"
+           << "      \"real_time\": " << r.realNs << ",\n"
+           << "      \"cpu_time\": " << r.cpuNs << ",\n"
+           << "      \"time_unit\": \"ns\"";
+        if (r.itemsPerSec > 0) os << ",\n      \"items_per_second\": " << r.itemsPerSec;
+        if (r.bytesPerSec > 0) os << ",\n      \"bytes_per_second\": " << r.bytesPerSec;
+        for (auto& kv : r.counters) os << ",\n      \"" << jsonEscape(kv.first) << "\": " << kv.second;
+        if (!r.label.empty()) os << ",\n      \"label\": \"" << jsonEscape(r.label) << "\"";
+        os << "\n    }";
+    }
+    os << "\n  ]\n}\n";
+    return os.str();
+}
+
+// name -> fastest real_time (ns) over the iteration runs (repetitions) in a file
+// written by toJson()
+inline std::map<std::string, double> readBaseline(const std::string& path) {
+    std::map<std::string, double> out;
+    std::ifstream ifs(path);
+    if (!ifs) return out;
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    const std::string text = ss.str();
+    static const std::regex entry(
+            "\"name\":\\s*\"([^\"]+)\",\\s*\"run_type\":\\s*\"iteration\",[^}]*?\"real_time\":\\s*([0-9.eE+-]+)");
+    for (std::sregex_iterator it(text.begin(), text.end(), entry), end; it != end; ++it) {
+        const double ns = std::strtod((*it)[2].str().c_str(), nullptr);
+        auto ins = out.emplace((*it)[1].str(), ns);
+        if (!ins.second) ins.first->second = std::min(ins.first->second, ns);
+    }
+    return out;
+}
+
+inline bool parseFlag(const char* arg, const char* name, std::string& value) {
+    const size_t n = std::strlen(name);
+    if (std::strncmp(arg, name, n) != 0 || arg[n] != '=') return false;
+    value = arg + n + 1;
+    return true;
+}
+
+inline const char* humanTime(double ns, char* buf, size_t len) {
+    if (ns < 1e3) std::snprintf(buf, len, "%9.1f ns", ns);
+    else if (ns < 1e6) std::snprintf(buf, len, "%9.2f us", ns * 1e-3);
+    else std::snprintf(buf, len, "%9.3f ms", ns * 1e-6);
+    return buf;
+}
+
+inline int runMain(int argc, char** argv, const char* contextExtra = nullptr) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string v;
+        if (parseFlag(argv[i], "--benchmark_filter", v)) opt.filter = v;
+        else if (parseFlag(argv[i], "--benchmark_min_time", v)) opt.minTime = std::atof(v.c_str());
+        else if (parseFlag(argv[i], "--benchmark_repetitions", v)) opt.repetitions = std::max(1, std::atoi(v.c_str()));
+        else if (parseFlag(argv[i], "--benchmark_format", v)) opt.json = (v == "json");
+        else if (parseFlag(argv[i], "--benchmark_out", v)) opt.out = v;
+        else if (parseFlag(argv[i], "--benchmark_baseline", v)) opt.baseline = v;
+        else if (parseFlag(argv[i], "--benchmark_max_regression", v)) opt.maxRegression = std::atof(v.c_str());
+        else {
+            std::fprintf(stderr, "unknown flag %s (see MicroBench.hpp for the supported ones)\n", argv[i]);
+            return 2;
+        }
+    }
+
+    std::regex filter;
+    try { filter = std::regex(opt.filter); }
+    catch (const std::regex_error&) { std::fprintf(stderr, "bad --benchmark_filter\n"); return 2; }
+
+    std::vector<Run> all;
+    if (!opt.json) std::printf("%-44s %12s %12s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+    for (auto& b : registry()) {
+        std::vector<std::vector<int64_t>> sets = b->argSets();
+        if (sets.empty()) sets.push_back({});
+        for (auto& args : sets) {
+            std::string name = b->name();
+            for (auto a : args) name += "/" + std::to_string(a);
+            if (!std::regex_search(name, filter)) continue;
+
+            std::vector<Run> reps;
+            for (int r = 0; r < opt.repetitions; ++r) reps.push_back(measure(*b, name, args, opt.minTime));
+            std::vector<Run> aggs = aggregate(reps);
+            for (auto* group : {&reps, &aggs}) {
+                for (auto& r : *group) {
+                    all.push_back(r);
+                    if (opt.json) continue;
+                    if (!r.error.empty()) { std::printf("%-44s ERROR: %s\n", r.name.c_str(), r.error.c_str()); continue; }
+                    char a[32], c[32];
+                    std::printf("%-44s %12s %12s %12llu", r.name.c_str(), humanTime(r.realNs, a, sizeof a),
+                                humanTime(r.cpuNs, c, sizeof c), (unsigned long long)r.iterations);
+                    if (r.itemsPerSec > 0) std::printf("  items/s=%.4g", r.itemsPerSec);
+                    if (r.bytesPerSec > 0) std::printf("  MB/s=%.1f", r.bytesPerSec / 1e6);
+                    for (auto& kv : r.counters) std::printf("  %s=%g", kv.first.c_str(), kv.second);
+                    if (!r.label.empty()) std::printf("  %s", r.label.c_str());
+                    std::printf("\n");
+                }
+            }
+        }
+    }
+
+    const std::string json = toJson(all, contextExtra);
+    if (opt.json) std::fputs(json.c_str(), stdout);
+    if (!opt.out.empty()) {
+        std::ofstream ofs(opt.out);
+        if (!ofs) { std::fprintf(stderr, "cannot write %s\n", opt.out.c_str()); return 1; }
+        ofs << json;
+    }
+
+    int rc = 0;
+    for (auto& r : all) if (!r.error.empty()) rc = 1;
+    if (!opt.baseline.empty()) {
+        const auto base = readBaseline(opt.baseline);
+        if (base.empty()) { std::fprintf(stderr, "baseline %s has no results\n", opt.baseline.c_str()); return 1; }
+        // Fastest repetition against fastest repetition: least sensitive to noise
+        std::map<std::string, double> best;
+        for (auto& r : all) {
+            if (r.runType != "iteration" || !r.error.empty()) continue;
+            auto ins = best.emplace(r.name, r.realNs);
+            if (!ins.second) ins.first->second = std::min(ins.first->second, r.realNs);
+        }
+        for (auto& kv : best) {
+            auto it = base.find(kv.first);
+            if (it == base.end() || it->second <= 0) continue;
+            const double change = kv.second / it->second - 1.0;
+            if (change > opt.maxRegression) {
+                std::fprintf(stderr, "REGRESSION %-40s %+.1f%% (%.1f -> %.1f ns)\n", kv.first.c_str(),
+                             100.0 * change, it->second, kv.second);
+                rc = 1;
+            }
+        }
+    }
+    return rc;
+}
+
+} // namespace mb
+#endif
@@ -0,0 +1,392 @@
+#if SNPE_CHAINING_HOST
+// Runs a model chain on the CPU reference backend and reports per-frame latency
+// for sequential, parallel and pipelined execution, plus a checksum of the final
+// outputs (identical across runs and modes for the same config) and the
+// per-node bind/execute latency distributions of the pipelined run.
+//
+//   chain_bench [--config file.json] [--frames N] [--delay-us US] [--threads T] [--in-flight K]
+//               [--trace out.json] [--profile basic|moderate|detailed]
+//               [--io-type float32|fp16|uint8|uint16] [--init-cache DIR] [--build-threads B]
+//               [--resident M] [--tune TABLE [--objective p95|power] [--budget-ms MS]]
+//
+// --trace records every run as Chrome trace JSON (open in ui.perfetto.dev).
+// --profile prints each model's layer hotspot table over all runs; the built-in
+// models carry mock layers (CpuModelSpec 'layers') that share their --delay-us.
+// --io-type sets "io_types": {"*": TYPE} on every model, so the tensors passed
+// between models use that encoding (quantized ones with the default [0, 1] range).
+// --init-cache persists each model's prepared graph in DIR ("init_cache"): the
+// first run pays every prepare_us, later runs load the cache and build faster.
+// --build-threads sets "build_threads" (1 = build the models one after the other).
+// --resident also runs the chain with reset_session, rebuilding every model per
+// frame (CpuModelSpec 'load_us'): inline (1 resident) and with M sessions resident,
+// the next one prefetched in the background, and checks that building the chain
+// for reset_session never holds more than M graphs at once.
+// --tune picks each model's runtime and performance profile ("tuning"): from TABLE
+// when it has a decision for the model, else by measuring every candidate (the
+// built-in models list DSP/GPU/CPU runtimes that scale their --delay-us) and
+// storing the winner in TABLE for the next run.
+//
+// Without --config a built-in four-model diamond is used:
+//   stem (conv3x3) -> left (matmul), right (matmul) -> merge (add)
+// Every run also checks a chain that carries state across frames (a node reads
+// a tensor a later node writes), sequentially and in parallel.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "inc/hpp/CpuReferenceBackend.hpp"
+#include "inc/hpp/GraphRunner.hpp"
+#include "inc/hpp/ParseConfig.hpp"
+#include "inc/hpp/ReferenceChain.hpp"
+#include "inc/hpp/RuntimeTuner.hpp"
+#include "inc/hpp/TensorConvert.hpp"
+#include "inc/hpp/TensorWorkspace.hpp"
+#include "inc/hpp/Trace.hpp"
+
+static const char* kDefaultConfig = R"({
+  "models": [
+    { "name": "stem",
+      "asset": "cpu:op=conv3x3;in=images:1x3x64x64;out=feat:1x8x64x64;seed=1;prepare_us=30000;load_us=4000;layers=conv1@DSP:4,bn1@DSP:1,act1@CPU:2;runtimes=DSP:1,GPU:1.6,CPU:3.5",
+      "inputs":  { "images": "frame" },
+      "outputs": { "feat": "stem_out" } },
+    { "name": "left",
+      "asset": "cpu:op=matmul;in=x:1x8x4096;out=y:1x8x64;seed=2;prepare_us=10000;load_us=2000;layers=fc_left@DSP;runtimes=DSP:1,GPU:1.2,CPU:2",
+      "inputs":  { "x": "stem_out" },
+      "outputs": { "y": "left_out" } },
+    { "name": "right",
+      "asset": "cpu:op=matmul;in=x:1x8x4096;out=y:1x8x64;seed=3;prepare_us=10000;load_us=2000;layers=fc_right@DSP:3,topk@CPU:1;runtimes=DSP:1,GPU:1.2,CPU:2",
+      "inputs":  { "x": "stem_out" },
+      "outputs": { "y": "right_out" } },
+    { "name": "merge",
+      "asset": "cpu:op=add;in=a:1x8x64,b:1x8x64;out=sum:1x8x64;prepare_us=2000;load_us=500;runtimes=DSP:1.5,CPU:1",
+      "inputs":  { "a": "left_out", "b": "right_out" },
+      "outputs": { "sum": "result" } }
+  ],
+  "init": { "frame": { "kind": "random", "mean": 0.0, "std": 1.0, "seed": 42 } }
+})";
+
+// 'accum' reads the state 'carry' writes: the state is read before it is written
+// within a frame, so after k frames out = k * frame
+static const char* kCarriedStateConfig = R"({
+  "models": [
+    { "name": "accum",
+      "asset": "cpu:op=add;in=s:1x256,x:1x256;out=y:1x256",
+      "inputs":  { "s": "state", "x": "frame" },
+      "outputs": { "y": "mid" } },
+    { "name": "carry",
+      "asset": "cpu:op=copy;in=x:1x256;out=y:1x256",
+      "inputs":  { "x": "mid" },
+      "outputs": { "y": "state" } },
+    { "name": "tap",
+      "asset": "cpu:op=copy;in=x:1x256;out=y:1x256",
+      "inputs":  { "x": "mid" },
+      "outputs": { "y": "out" } }
+  ],
+  "init": { "frame": { "kind": "random", "mean": 0.0, "std": 1.0, "seed": 7 } }
+})";
+
+using Clock = std::chrono::steady_clock;
+
+static double msBetween(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// Sum of every graph output (tensors no node consumes), as a determinism check;
+// 'slot' reads a pipeline slot's copies
+static double outputChecksum(GraphRunner& gr, const TensorWorkspace& ws, size_t slot = 0) {
+    std::vector<TensorWorkspace::TensorId> consumed;
+    for (auto& n : gr.getNodes()) consumed.insert(consumed.end(), n.inputIds.begin(), n.inputIds.end());
+    double sum = 0.0;
+    for (auto& n : gr.getNodes()) {
+        for (auto id : n.outputIds) {
+            if (std::find(consumed.begin(), consumed.end(), id) != consumed.end()) continue;
+            const TensorInfo* info = gr.tensorInfo(id);
+            if (!info) continue;
+            std::vector<float> f(info->elements());
+            tensorToFloat(ws.data(gr.slotTensor(slot, id)), *info, f.data(), f.size());
+            for (float v : f) sum += v;
+        }
+    }
+    return sum;
+}
+
+static void printNodeLatency(const GraphRunner& gr) {
+    std::printf("  %-16s %8s %10s %10s %10s %10s\n", "node", "count", "p50 us", "p90 us", "p99 us", "max us");
+    for (auto& n : gr.nodeLatency()) {
+        const LatencyStats& s = n.execute;
+        std::printf("  %-16s %8llu %10.1f %10.1f %10.1f %10.1f\n", n.name.c_str(),
+                    (unsigned long long)s.count, s.p50Ns * 1e-3, s.p90Ns * 1e-3, s.p99Ns * 1e-3, s.maxNs * 1e-3);
+    }
+}
+
+static double runFrames(GraphRunner& gr, int frames, bool resetSessions = false) {
+    gr.runAll(resetSessions); // warm-up, compiles and binds
+    auto t0 = Clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (auto& e : gr.runAll(resetSessions)) {
+            if (!e.ok) { std::fprintf(stderr, "node %s failed\n", e.name.c_str()); std::exit(1); }
+        }
+    }
+    return msBetween(t0, Clock::now()) / frames;
+}
+
+static double tensorSum(const TensorWorkspace& ws, const char* name) {
+    const float* f = static_cast<const float*>(ws.data(name));
+    double sum = 0.0;
+    for (size_t i = 0; i < ws.sizeOf(name) / sizeof(float); ++i) sum += f[i];
+    return sum;
+}
+
+// Carried state must compile (no false cycle) and keep read-before-write order
+static bool carriedStateCheck(int frames, std::string* emsg) {
+    PipelineCfg cfg;
+    if (!ParseConfig(kCarriedStateConfig, cfg, emsg)) return false;
+    for (size_t threads : {size_t(1), size_t(3)}) {
+        TensorWorkspace ws;
+        GraphRunner gr(ws);
+        if (!buildReferenceChain(cfg, ws, gr, nullptr, emsg, 0)) return false;
+        gr.setParallelism(threads);
+        std::memset(ws.data("state"), 0, ws.sizeOf("state"));
+        for (int f = 1; f <= frames; ++f) {
+            for (auto& e : gr.runAll()) {
+                if (!e.ok) { *emsg = "node " + e.name + " failed"; return false; }
+            }
+            const double want = f * tensorSum(ws, "frame"), got = tensorSum(ws, "out");
+            if (std::abs(got - want) > 1e-4 * (1.0 + std::abs(want))) {
+                char buf[128];
+                std::snprintf(buf, sizeof(buf), "frame %d on %zu threads: out sums to %.6f, expected %.6f",
+                              f, threads, got, want);
+                *emsg = buf;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string configPath, tracePath, profileLevel, ioType, initCacheDir, tuneTable, objective;
+    double budgetMs = -1.0;
+    int frames = 100, delayUs = -1, buildThreads = -1;
+    size_t threads = 0, inFlight = 0, resident = 0;
+    for (int i = 1; i < argc; ++i) {
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) { std::fprintf(stderr, "%s needs a value\n", argv[i]); std::exit(2); }
+            return argv[++i];
+        };
+        if (!std::strcmp(argv[i], "--config")) configPath = next();
+        else if (!std::strcmp(argv[i], "--frames")) frames = std::atoi(next());
+        else if (!std::strcmp(argv[i], "--delay-us")) delayUs = std::atoi(next());
+        else if (!std::strcmp(argv[i], "--threads")) threads = std::strtoul(next(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--in-flight")) inFlight = std::strtoul(next(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--trace")) tracePath = next();
+        else if (!std::strcmp(argv[i], "--profile")) profileLevel = next();
+        else if (!std::strcmp(argv[i], "--io-type")) ioType = next();
+        else if (!std::strcmp(argv[i], "--init-cache")) initCacheDir = next();
+        else if (!std::strcmp(argv[i], "--build-threads")) buildThreads = std::atoi(next());
+        else if (!std::strcmp(argv[i], "--resident")) resident = std::strtoul(next(), nullptr, 10);
+        else if (!std::strcmp(argv[i], "--tune")) tuneTable = next();
+        else if (!std::strcmp(argv[i], "--objective")) objective = next();
+        else if (!std::strcmp(argv[i], "--budget-ms")) budgetMs = std::atof(next());
+        else {
+            std::fprintf(stderr, "usage: %s [--config file.json] [--frames N] [--delay-us US]"
+                                 " [--threads T] [--in-flight K] [--trace out.json]"
+                                 " [--profile basic|moderate|detailed]"
+                                 " [--io-type float32|fp16|uint8|uint16] [--init-cache DIR]"
+                                 " [--build-threads B] [--resident M]"
+                                 " [--tune TABLE [--objective p95|power] [--budget-ms MS]]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames <= 0) frames = 1;
+
+    std::string text = kDefaultConfig;
+    if (!configPath.empty()) {
+        std::ifstream ifs(configPath);
+        if (!ifs) { std::fprintf(stderr, "cannot read %s\n", configPath.c_str()); return 1; }
+        std::stringstream ss;
+        ss << ifs.rdbuf();
+        text = ss.str();
+    }
+
+    PipelineCfg cfg;
+    std::string emsg, log;
+    if (!ParseConfig(text, cfg, &emsg)) {
+        std::fprintf(stderr, "config: %s\n", emsg.c_str());
+        return 1;
+    }
+    if (!ioType.empty()) {
+        TensorDataType type;
+        if (!parseDataType(ioType, type)) {
+            std::fprintf(stderr, "unknown io type '%s'\n", ioType.c_str());
+            return 2;
+        }
+        for (auto& m : cfg.models) m.ioTypes["*"] = type;
+    }
+    if (buildThreads >= 0) cfg.buildThreads = size_t(buildThreads);
+    if (!initCacheDir.empty()) {
+        cfg.initCache.enabled = true;
+        cfg.initCache.dir = initCacheDir;
+    }
+    if (!tuneTable.empty()) {
+        cfg.tuning.enabled = true;
+        cfg.tuning.table = tuneTable;
+    }
+    if (!objective.empty()) {
+        TuneObjective o;
+        if (!parseTuneObjective(objective, o)) {
+            std::fprintf(stderr, "unknown objective '%s'\n", objective.c_str());
+            return 2;
+        }
+        cfg.tuning.objective = objective;
+    }
+    if (budgetMs >= 0.0) cfg.tuning.budgetMs = budgetMs;
+    if (cfg.baseDir.empty() && !configPath.empty()) {
+        const size_t slash = configPath.find_last_of('/');
+        if (slash != std::string::npos) cfg.baseDir = configPath.substr(0, slash);
+    }
+
+    if (!tracePath.empty()) {
+        traceSetThreadName("main");
+        traceStart();
+    }
+
+    TensorWorkspace ws;
+    GraphRunner gr(ws);
+    auto tBuild = Clock::now();
+    if (!buildReferenceChain(cfg, ws, gr, &log, &emsg, delayUs)) {
+        std::fprintf(stderr, "build: %s\n", emsg.c_str());
+        return 1;
+    }
+    const double buildMs = msBetween(tBuild, Clock::now());
+    if (!profileLevel.empty()) {
+        ModelSession::ProfilingOptions popt;
+        if (!parseProfilingLevel(profileLevel, popt.level)) {
+            std::fprintf(stderr, "unknown profiling level '%s'\n", profileLevel.c_str());
+            return 2;
+        }
+        popt.frames = size_t(-1);  // one report at the end
+        popt.topN = 0;
+        for (auto& n : gr.getNodes()) {
+            popt.title = n.name;
+            n.session->setProfiling(popt);
+        }
+    }
+    const size_t nodes = gr.getNodes().size();
+    if (threads == 0) threads = nodes;
+    if (inFlight == 0) inFlight = std::min<size_t>(nodes, 3);
+
+    std::printf("chain: %zu models, build %.2f ms, %d frames\n", nodes, buildMs, frames);
+    if (!cfg.tuning.table.empty()) {
+        for (auto& n : gr.getNodes()) {
+            const auto* b = dynamic_cast<const CpuReferenceBackend*>(n.session->backend());
+            std::printf("  %-16s %s/%s\n", n.name.c_str(), n.session->selectedRuntimeName().c_str(),
+                        b ? b->profile().c_str() : "?");
+        }
+    }
+
+    gr.setParallelism(1);
+    const double seqMs = runFrames(gr, frames);
+    const double seqSum = outputChecksum(gr, ws);
+    std::printf("  sequential         %8.3f ms/frame  checksum %.6f\n", seqMs, seqSum);
+
+    gr.setParallelism(threads);
+    const double parMs = runFrames(gr, frames);
+    const double parSum = outputChecksum(gr, ws);
+    std::printf("  parallel (%zu thr)   %8.3f ms/frame  checksum %.6f\n", threads, parMs, parSum);
+    gr.setParallelism(1);
+
+    // Every delivered frame must match the sequential result, in submit order
+    uint64_t nextSeq = 0, badFrames = 0;
+    auto onDone = [&](uint64_t seq, size_t slot, const std::vector<GraphRunner::ExecInfo>& infos) {
+        bool ok = seq == nextSeq++;
+        for (const auto& e : infos) ok = ok && e.ok;
+        if (!ok || outputChecksum(gr, ws, slot) != seqSum) ++badFrames;
+    };
+    if (!gr.startPipeline(inFlight, onDone, &emsg)) {
+        std::fprintf(stderr, "pipeline: %s\n", emsg.c_str());
+        return 1;
+    }
+    gr.submitFrame(nullptr);
+    gr.drainPipeline();
+    gr.resetLatency();
+    auto t0 = Clock::now();
+    for (int f = 0; f < frames; ++f) gr.submitFrame(nullptr);
+    gr.drainPipeline();
+    const double pipeMs = msBetween(t0, Clock::now()) / frames;
+    gr.stopPipeline();
+    std::printf("  pipelined (%zu fly)  %8.3f ms/frame  %llu/%llu frames differ\n", inFlight, pipeMs,
+                (unsigned long long)badFrames, (unsigned long long)nextSeq);
+
+    printNodeLatency(gr);
+    for (auto& n : gr.getNodes()) {
+        if (const LayerProfiler* prof = n.session->profiler())
+            std::printf("\n%s", prof->table(n.name + " hotspots").c_str());
+    }
+
+    double resetSum = seqSum;
+    if (resident > 0) {
+        std::printf("\n");
+        // Startup with reset_session must stay within the budget too: graphs are
+        // released as they are built
+        {
+            TensorWorkspace rws;
+            GraphRunner rgr(rws);
+            rgr.setMaxResidentSessions(resident);
+            const size_t before = CpuReferenceBackend::liveGraphs();
+            CpuReferenceBackend::resetPeakLiveGraphs();
+            std::string rlog;
+            if (!buildReferenceChain(cfg, rws, rgr, &rlog, &emsg, delayUs, /*resetSessions=*/true)) {
+                std::fprintf(stderr, "build (reset): %s\n", emsg.c_str());
+                return 1;
+            }
+            const size_t peak = CpuReferenceBackend::peakLiveGraphs() - before;
+            const size_t after = CpuReferenceBackend::liveGraphs() - before;
+            std::printf("  reset startup      peak %zu built graphs (budget %zu), %zu after build\n",
+                        peak, resident, after);
+            if (peak > resident || after != 0) {
+                std::fprintf(stderr, "reset_session startup exceeded its resident budget\n");
+                return 1;
+            }
+        }
+        for (size_t m : {size_t(1), resident}) {
+            gr.setMaxResidentSessions(m);
+            const double ms = runFrames(gr, frames, /*resetSessions=*/true);
+            const SessionResidency::Stats rs = gr.residencyStats();
+            resetSum = outputChecksum(gr, ws);
+            std::printf("  reset (%zu resident) %8.3f ms/frame  checksum %.6f  prefetched %llu/%llu,"
+                        " waited %.3f ms/frame\n", m, ms, resetSum,
+                        (unsigned long long)rs.prefetchHits, (unsigned long long)rs.acquires,
+                        rs.waitNs * 1e-6 / (frames + 1));
+        }
+    }
+
+    if (!tracePath.empty()) {
+        traceStop();
+        if (!traceWriteChromeJson(tracePath, &emsg)) {
+            std::fprintf(stderr, "trace: %s\n", emsg.c_str());
+            return 1;
+        }
+        std::printf("trace written to %s\n", tracePath.c_str());
+    }
+
+    if (!carriedStateCheck(std::min(frames, 50), &emsg)) {
+        std::fprintf(stderr, "carried state: %s\n", emsg.c_str());
+        return 1;
+    }
+    std::printf("  carried state      ok\n");
+
+    if (seqSum != parSum || seqSum != resetSum || badFrames != 0) {
+        std::fprintf(stderr, "checksum mismatch between sequential, parallel, pipelined and reset runs\n");
+        return 1;
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,509 @@
+#if SNPE_CHAINING_HOST
+// Per-frame hot path microbenchmarks (host build). See MicroBench.hpp for flags;
+// --benchmark_format=json / --benchmark_out=<file> give Google-Benchmark JSON,
+// --benchmark_baseline=<file> fails the run on regressions.
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MicroBench.hpp"
+
+#include "inc/hpp/DlcCache.hpp"
+#include "inc/hpp/GraphRunner.hpp"
+#include "inc/hpp/InferenceBackend.hpp"
+#include "inc/hpp/LatencyHistogram.hpp"
+#include "inc/hpp/ModelSession.hpp"
+#include "inc/hpp/OutputDecoder.hpp"
+#include "inc/hpp/ParseConfig.hpp"
+#include "inc/hpp/PoseDecoder.hpp"
+#include "inc/hpp/Preprocess.hpp"
+#include "inc/hpp/ScoreReduce.hpp"
+#include "inc/hpp/Simd.hpp"
+#include "inc/hpp/TensorConvert.hpp"
+#include "inc/hpp/TensorView.hpp"
+#include "inc/hpp/TensorWorkspace.hpp"
+#include "inc/hpp/Trace.hpp"
+
+#ifndef SNPE_MODEL_CONFIG
+#define SNPE_MODEL_CONFIG "model-config.json"
+#endif
+
+namespace {
+
+uint32_t lcg(uint32_t& s) { s = s * 1664525u + 1013904223u; return s; }
+float unit(uint32_t& s) { return float(lcg(s) >> 8) / float(1u << 24); }
+
+const int kFrameSizes[][2] = {{640, 480}, {1280, 720}, {1920, 1080}};
+
+std::vector<uint8_t> syntheticRgb(int w, int h) {
+    std::vector<uint8_t> rgb(size_t(w) * h * 3);
+    uint32_t seed = 12345;
+    for (auto& v : rgb) v = uint8_t(lcg(seed) >> 24);
+    return rgb;
+}
+
+// [1, 56, 1344] YOLO-pose head: 6 people, each hit by ~12 anchors, plus noise
+// (same layout as benchmarkPoseDecoder() in newInferenceHelper.cpp)
+std::vector<float> syntheticPoseOutput(const PoseDecoder::Params& p) {
+    const size_t A = size_t(p.numAnchors);
+    std::vector<float> out(size_t(p.numChannels) * A, 0.f);
+    uint32_t seed = 777;
+    for (size_t a = 0; a < A; ++a) out[size_t(p.scoreChannel) * A + a] = 0.2f * unit(seed);
+    for (int k = 0; k < 6; ++k) {
+        const float cx = 40.f + 80.f * (k % 3), cy = 64.f + 128.f * (k / 3);
+        for (int j = 0; j < 12; ++j) {
+            const size_t a = (size_t(k) * 211 + size_t(j) * 7) % A;
+            out[0 * A + a] = cx + 4.f * (unit(seed) - 0.5f);
+            out[1 * A + a] = cy + 4.f * (unit(seed) - 0.5f);
+            out[2 * A + a] = 60.f + 4.f * unit(seed);
+            out[3 * A + a] = 110.f + 4.f * unit(seed);
+            out[size_t(p.scoreChannel) * A + a] = 0.55f + 0.4f * unit(seed);
+            for (int kp = 0; kp < p.numKeypoints; ++kp) {
+                const size_t c = size_t(p.keypointChannel + 3 * kp);
+                out[c * A + a] = unit(seed);
+                out[(c + 1) * A + a] = cx + 20.f * (unit(seed) - 0.5f);
+                out[(c + 2) * A + a] = cy + 40.f * (unit(seed) - 0.5f);
+            }
+        }
+    }
+    return out;
+}
+
+// ---- Preprocessing ------------------------------------------------------------
+
+void BM_Preprocess(mb::State& st) {
+    const int W = kFrameSizes[st.range(0)][0], H = kFrameSizes[st.range(0)][1];
+    const auto rgb = syntheticRgb(W, H);
+    ImagePreprocessor pp;
+    std::vector<float> out(pp.outputFloats());
+    for (auto _ : st) {
+        pp.run(rgb.data(), W, H, 0, out.data());
+        mb::clobberMemory();
+    }
+    st.setBytesProcessed(int64_t(st.iterations()) * int64_t(rgb.size()));
+    st.setLabel(std::to_string(W) + "x" + std::to_string(H) + " " + simdName());
+}
+MB_BENCHMARK(BM_Preprocess)->arg(0)->arg(1)->arg(2);
+
+void BM_PreprocessScalar(mb::State& st) {
+    const int W = kFrameSizes[st.range(0)][0], H = kFrameSizes[st.range(0)][1];
+    const auto rgb = syntheticRgb(W, H);
+    ImagePreprocessor pp;
+    std::vector<float> out(pp.outputFloats());
+    for (auto _ : st) {
+        pp.runScalar(rgb.data(), W, H, 0, out.data());
+        mb::clobberMemory();
+    }
+    st.setBytesProcessed(int64_t(st.iterations()) * int64_t(rgb.size()));
+    st.setLabel(std::to_string(W) + "x" + std::to_string(H));
+}
+MB_BENCHMARK(BM_PreprocessScalar)->arg(0)->arg(2);
+
+void BM_PreprocessLetterbox(mb::State& st) {
+    const int W = kFrameSizes[st.range(0)][0], H = kFrameSizes[st.range(0)][1];
+    const auto rgb = syntheticRgb(W, H);
+    ImagePreprocessor::Params p;
+    p.fit = ImagePreprocessor::Fit::LETTERBOX;
+    ImagePreprocessor pp(p);
+    std::vector<float> out(pp.outputFloats());
+    for (auto _ : st) {
+        pp.run(rgb.data(), W, H, 0, out.data());
+        mb::clobberMemory();
+    }
+    st.setBytesProcessed(int64_t(st.iterations()) * int64_t(rgb.size()));
+    st.setLabel(std::to_string(W) + "x" + std::to_string(H) + " " + simdName());
+}
+MB_BENCHMARK(BM_PreprocessLetterbox)->arg(0)->arg(2);
+
+// Typed model input: arg 0 = fp16, 1 = uint8 TfN (what a quantized DSP model reads)
+void BM_PreprocessTyped(mb::State& st) {
+    const int W = kFrameSizes[1][0], H = kFrameSizes[1][1];
+    const auto rgb = syntheticRgb(W, H);
+    ImagePreprocessor pp;
+    TensorInfo info;
+    info.dims = {1, 3, 256, 256};
+    info.setDataType(st.range(0) ? TensorDataType::UFIXED8 : TensorDataType::FLOAT16);
+    quantParamsForRange(0.0f, 1.0f, TensorDataType::UFIXED8, info.qScale, info.qOffset);
+    std::vector<uint8_t> out(info.bytes());
+    for (auto _ : st) {
+        pp.run(rgb.data(), W, H, 0, out.data(), info);
+        mb::clobberMemory();
+    }
+    st.setBytesProcessed(int64_t(st.iterations()) * int64_t(rgb.size()));
+    st.setLabel(std::to_string(W) + "x" + std::to_string(H) + " " + dataTypeName(info.dataType));
+}
+MB_BENCHMARK(BM_PreprocessTyped)->arg(0)->arg(1);
+
+// run() must match runScalar() exactly: every frame size plus an odd one (SIMD
+// tails), stretched or letterboxed (arg 0), into float32 / fp16 / uint8 / uint16
+// (arg 1; typed outputs are compared with the scalar result encoded the same way).
+// Timed: run() on the odd frame.
+void BM_PreprocessMatchesScalar(mb::State& st) {
+    static const TensorDataType kTypes[] = {TensorDataType::FLOAT32, TensorDataType::FLOAT16,
+                                            TensorDataType::UFIXED8, TensorDataType::UFIXED16};
+    ImagePreprocessor::Params p;
+    p.fit = st.range(0) ? ImagePreprocessor::Fit::LETTERBOX : ImagePreprocessor::Fit::STRETCH;
+    ImagePreprocessor pp(p), ref(p);
+    TensorInfo info;
+    info.dims = {1, 3, size_t(p.dstH), size_t(p.dstW)};
+    info.setDataType(kTypes[st.range(1)]);
+    if (isQuantized(info.dataType)) quantParamsForRange(0.0f, 1.0f, info.dataType, info.qScale, info.qOffset);
+
+    const int sizes[][2] = {{640, 480}, {1280, 720}, {1920, 1080}, {333, 177}};
+    std::vector<uint8_t> got(info.bytes()), want(info.bytes());
+    std::vector<float> scalar(pp.outputFloats());
+    std::vector<uint8_t> rgb;
+    for (const auto& wh : sizes) {
+        rgb = syntheticRgb(wh[0], wh[1]);
+        if (!pp.run(rgb.data(), wh[0], wh[1], 0, got.data(), info) ||
+            !ref.runScalar(rgb.data(), wh[0], wh[1], 0, scalar.data())) {
+            st.skipWithError("preprocess failed");
+            return;
+        }
+        tensorFromFloat(scalar.data(), info, want.data(), scalar.size());
+        if (got != want) {
+            st.skipWithError(std::to_string(wh[0]) + "x" + std::to_string(wh[1]) + " differs from runScalar");
+            return;
+        }
+    }
+    for (auto _ : st) {
+        pp.run(rgb.data(), sizes[3][0], sizes[3][1], 0, got.data(), info);
+        mb::clobberMemory();
+    }
+    st.setLabel(std::string(st.range(0) ? "letterbox " : "stretch ") + dataTypeName(info.dataType) + " " + simdName());
+}
+MB_BENCHMARK(BM_PreprocessMatchesScalar)->args({0, 0})->args({1, 0})->args({0, 1})->args({1, 2})->args({0, 3})->args({1, 3});
+
+// ---- Postprocessing -----------------------------------------------------------
+
+// Best-anchor search over the score row (single-person path)
+void BM_BestAnchor(mb::State& st) {
+    PoseDecoder::Params p;
+    const auto out = syntheticPoseOutput(p);
+    const float* score = out.data() + size_t(p.scoreChannel) * size_t(p.numAnchors);
+    for (auto _ : st) mb::doNotOptimize(scoreArgmax(score, size_t(p.numAnchors)));
+    st.setItemsProcessed(int64_t(st.iterations()) * p.numAnchors);
+}
+MB_BENCHMARK(BM_BestAnchor);
+
+void BM_BestAnchorScalar(mb::State& st) {
+    PoseDecoder::Params p;
+    const auto out = syntheticPoseOutput(p);
+    const float* score = out.data() + size_t(p.scoreChannel) * size_t(p.numAnchors);
+    for (auto _ : st) mb::doNotOptimize(scoreref::argmax(score, size_t(p.numAnchors)));
+    st.setItemsProcessed(int64_t(st.iterations()) * p.numAnchors);
+}
+MB_BENCHMARK(BM_BestAnchorScalar);
+
+// Best anchor + its 17 keypoints read straight from the channel-major tensor
+void BM_BestPoseKeypoints(mb::State& st) {
+    PoseDecoder::Params p;
+    const auto out = syntheticPoseOutput(p);
+    const TensorView<float> view(out.data(), {1, size_t(p.numChannels), size_t(p.numAnchors)});
+    float kp[17 * 3];
+    for (auto _ : st) {
+        const ScoreMax best = scoreArgmax(view.row(size_t(p.scoreChannel)), view.cols());
+        for (int k = 0; k < p.numKeypoints; ++k) {
+            const size_t c = size_t(p.keypointChannel + 3 * k);
+            kp[3 * k + 0] = view(c + 1, size_t(best.index));
+            kp[3 * k + 1] = view(c + 2, size_t(best.index));
+            kp[3 * k + 2] = view(c, size_t(best.index));
+        }
+        mb::doNotOptimize(kp);
+        mb::clobberMemory();
+    }
+}
+MB_BENCHMARK(BM_BestPoseKeypoints);
+
+// Every person: threshold + top-K + NMS + keypoint gather
+void BM_PoseDecode(mb::State& st) {
+    PoseDecoder dec;
+    const auto out = syntheticPoseOutput(dec.params());
+    dec.decode(out.data(), out.size());
+    for (auto _ : st) mb::doNotOptimize(dec.decode(out.data(), out.size()));
+    st.counters["people"] = double(dec.detections().size());
+}
+MB_BENCHMARK(BM_PoseDecode);
+
+// Same through the config-selected decoder (what the actor runs per frame)
+void BM_OutputDecoderYoloPose(mb::State& st) {
+    DecoderCfg dc;
+    dc.type = "yolo_pose";
+    std::string emsg;
+    auto dec = OutputDecoderRegistry::instance().create(dc, &emsg);
+    TensorInfo info;
+    info.name = "output_0";
+    info.dims = {1, 56, 1344};
+    if (!dec || !dec->prepare(info, &emsg)) { st.skipWithError(emsg); return; }
+    const auto out = syntheticPoseOutput(PoseDecoder::Params());
+    const TensorView<float> view(out.data(), info.dims);
+    const DecodeLimits limits;
+    for (auto _ : st) mb::doNotOptimize(dec->decode(view, limits));
+    st.counters["people"] = double(dec->detections().size());
+}
+MB_BENCHMARK(BM_OutputDecoderYoloPose);
+
+// ---- TensorWorkspace lookups --------------------------------------------------
+
+void fillWorkspace(TensorWorkspace& ws, int n) {
+    for (int i = 0; i < n; ++i) ws.allocate("model_" + std::to_string(i / 4) + "/tensor_" + std::to_string(i), 256);
+}
+
+void BM_WorkspaceDataByName(mb::State& st) {
+    TensorWorkspace ws;
+    const int n = int(st.range(0));
+    fillWorkspace(ws, n);
+    const std::string name = "model_" + std::to_string((n - 1) / 4) + "/tensor_" + std::to_string(n - 1);
+    for (auto _ : st) mb::doNotOptimize(ws.data(name));
+}
+MB_BENCHMARK(BM_WorkspaceDataByName)->arg(8)->arg(64);
+
+void BM_WorkspaceDataById(mb::State& st) {
+    TensorWorkspace ws;
+    const int n = int(st.range(0));
+    fillWorkspace(ws, n);
+    const auto id = ws.find("model_" + std::to_string((n - 1) / 4) + "/tensor_" + std::to_string(n - 1));
+    for (auto _ : st) mb::doNotOptimize(ws.data(id));
+}
+MB_BENCHMARK(BM_WorkspaceDataById)->arg(8)->arg(64);
+
+void BM_WorkspaceFind(mb::State& st) {
+    TensorWorkspace ws;
+    const int n = int(st.range(0));
+    fillWorkspace(ws, n);
+    const std::string name = "model_" + std::to_string((n - 1) / 4) + "/tensor_" + std::to_string(n - 1);
+    for (auto _ : st) mb::doNotOptimize(ws.find(name));
+}
+MB_BENCHMARK(BM_WorkspaceFind)->arg(64);
+
+// ---- GraphRunner overhead -----------------------------------------------------
+
+// Does nothing: what is left of runAll() is the runner's own cost
+class NoopBackend : public IInferenceBackend {
+public:
+    NoopBackend() {
+        TensorInfo t;
+        t.name = "x";
+        t.dims = {1, 16};
+        inputs_.push_back(t);
+        t.name = "y";
+        outputs_.push_back(t);
+    }
+    const char* runtimeName() const override { return "NOOP"; }
+    bool build(std::string*) override { built_ = true; return true; }
+    void release() override { built_ = false; }
+    bool ready() const override { return built_; }
+    const std::vector<TensorInfo>& inputs() const override { return inputs_; }
+    const std::vector<TensorInfo>& outputs() const override { return outputs_; }
+    bool bind(const std::vector<const void*>&, const std::vector<void*>&) override { return true; }
+    void unbind() override {}
+    bool executeBound() override { return true; }
+    bool execute(const std::vector<const void*>&, const std::vector<void*>&) override { return true; }
+
+private:
+    std::vector<TensorInfo> inputs_, outputs_;
+    bool built_ = false;
+};
+
+// n no-op nodes in a line: t0 -> node0 -> t1 -> ... -> tn
+bool buildNoopChain(TensorWorkspace& ws, GraphRunner& gr, int n) {
+    for (int i = 0; i <= n; ++i) ws.allocate("t" + std::to_string(i), 64);
+    for (int i = 0; i < n; ++i) {
+        GraphRunner::Node node;
+        node.name = "noop" + std::to_string(i);
+        node.session = ModelSession::Create(std::unique_ptr<IInferenceBackend>(new NoopBackend()), nullptr);
+        node.inputBinding = {{"x", "t" + std::to_string(i)}};
+        node.outputBinding = {{"y", "t" + std::to_string(i + 1)}};
+        if (!node.session || !gr.addNode(std::move(node), true)) return false;
+    }
+    return true;
+}
+
+// ModelSession::execute() resolves the name maps and binds on every call;
+// bind() once + executeBound() is what GraphRunner does per frame
+void BM_SessionExecuteByName(mb::State& st) {
+    auto s = ModelSession::Create(std::unique_ptr<IInferenceBackend>(new NoopBackend()), nullptr);
+    std::vector<float> x(16), y(16);
+    const std::unordered_map<std::string, const void*> in{{"x", x.data()}};
+    const std::unordered_map<std::string, void*> out{{"y", y.data()}};
+    int64_t ms = 0;
+    for (auto _ : st) mb::doNotOptimize(s->execute(in, out, &ms));
+}
+MB_BENCHMARK(BM_SessionExecuteByName);
+
+void BM_SessionExecuteBound(mb::State& st) {
+    auto s = ModelSession::Create(std::unique_ptr<IInferenceBackend>(new NoopBackend()), nullptr);
+    std::vector<float> x(16), y(16);
+    if (!s->bind(std::vector<const void*>{x.data()}, std::vector<void*>{y.data()})) {
+        st.skipWithError("bind failed");
+        return;
+    }
+    int64_t ms = 0;
+    for (auto _ : st) mb::doNotOptimize(s->executeBound(&ms));
+}
+MB_BENCHMARK(BM_SessionExecuteBound);
+
+void BM_RunAllNoop(mb::State& st) {
+    TensorWorkspace ws;
+    GraphRunner gr(ws);
+    if (!buildNoopChain(ws, gr, int(st.range(0)))) { st.skipWithError("chain build failed"); return; }
+    gr.runAll();
+    for (auto _ : st) mb::doNotOptimize(gr.runAll().data());
+    st.setItemsProcessed(int64_t(st.iterations()) * st.range(0));
+}
+MB_BENCHMARK(BM_RunAllNoop)->arg(1)->arg(4)->arg(16);
+
+void BM_RunPlanNoop(mb::State& st) {
+    TensorWorkspace ws;
+    GraphRunner gr(ws);
+    if (!buildNoopChain(ws, gr, int(st.range(0)))) { st.skipWithError("chain build failed"); return; }
+    auto plan = gr.compile();
+    if (!plan) { st.skipWithError("compile failed"); return; }
+    for (auto _ : st) mb::doNotOptimize(gr.run(*plan).data());
+    st.setItemsProcessed(int64_t(st.iterations()) * st.range(0));
+}
+MB_BENCHMARK(BM_RunPlanNoop)->arg(1)->arg(16);
+
+void BM_RunAllNoopParallel(mb::State& st) {
+    TensorWorkspace ws;
+    GraphRunner gr(ws);
+    if (!buildNoopChain(ws, gr, int(st.range(0)))) { st.skipWithError("chain build failed"); return; }
+    gr.setParallelism(4);
+    gr.runAll();
+    for (auto _ : st) mb::doNotOptimize(gr.runAll().data());
+}
+MB_BENCHMARK(BM_RunAllNoopParallel)->arg(16);
+
+// ---- LatencyHistogram ---------------------------------------------------------
+
+void BM_LatencyRecord(mb::State& st) {
+    LatencyHistogram h;
+    uint64_t ns = 1;
+    for (auto _ : st) {
+        h.record(ns);
+        ns = ns * 6364136223846793005ull + 1442695040888963407ull;
+        ns >>= 40;  // spread over ~16 ms
+    }
+    mb::doNotOptimize(h.count());
+}
+MB_BENCHMARK(BM_LatencyRecord);
+
+void BM_LatencyRecordSince(mb::State& st) {
+    LatencyHistogram h;
+    for (auto _ : st) h.recordSince(LatencyHistogram::Clock::now());
+    mb::doNotOptimize(h.count());
+}
+MB_BENCHMARK(BM_LatencyRecordSince);
+
+void BM_LatencyStats(mb::State& st) {
+    LatencyHistogram h;
+    for (uint64_t i = 0; i < 100000; ++i) h.record(1000 + (i * 7919) % 5000000);
+    for (auto _ : st) mb::doNotOptimize(h.stats().p99Ns);
+}
+MB_BENCHMARK(BM_LatencyStats);
+
+// ---- Trace ---------------------------------------------------------------------
+
+// Cost of an instrumented scope while tracing is stopped (the common case)
+void BM_TraceScopeDisabled(mb::State& st) {
+    traceStop();
+    for (auto _ : st) {
+        SNPE_TRACE_SCOPE("bench", "scope");
+        mb::clobberMemory();
+    }
+}
+MB_BENCHMARK(BM_TraceScopeDisabled);
+
+void BM_TraceScopeEnabled(mb::State& st) {
+    traceStart();
+    for (auto _ : st) {
+        SNPE_TRACE_SCOPE("bench", "scope");
+        mb::clobberMemory();
+    }
+    traceStop();
+    traceClear();
+}
+MB_BENCHMARK(BM_TraceScopeEnabled);
+
+// ---- ParseConfig --------------------------------------------------------------
+
+std::string readText(const char* path) {
+    std::ifstream ifs(path);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+// A larger chain in the same schema: n models, each with inputs, outputs, a
+// decoder block and an init entry for its first input
+std::string syntheticConfig(int n) {
+    std::string s = "{\n  \"baseDir\": \"/sdcard/Android/data/app/files/Models\",\n  \"models\": [\n";
+    for (int i = 0; i < n; ++i) {
+        s += "    {\n      \"name\": \"Model" + std::to_string(i) + "\",\n"
+             "      \"asset\": \"model_" + std::to_string(i) + ".dlc\",\n"
+             "      \"runtime\": \"D\",\n"
+             "      \"inputs\": { \"images\": \"t" + std::to_string(i) + "\", \"aux\": \"aux" + std::to_string(i) + "\" },\n"
+             "      \"outputs\": { \"output_0\": \"t" + std::to_string(i + 1) + "\" },\n"
+             "      \"decoder\": { \"type\": \"yolo_pose\", \"output\": \"output_0\", \"scoreChannel\": 55,"
+             " \"keypointChannel\": 4, \"numKeypoints\": 17, \"visibilityFirst\": true }\n    }";
+        s += (i + 1 < n) ? ",\n" : "\n";
+    }
+    s += "  ],\n  \"init\": {\n";
+    for (int i = 0; i < n; ++i) {
+        s += "    \"aux" + std::to_string(i) + "\": { \"kind\": \"random\", \"mean\": 0.0, \"std\": 1.0, \"seed\": "
+             + std::to_string(i + 1) + " }";
+        s += (i + 1 < n) ? ",\n" : "\n";
+    }
+    s += "  }\n}\n";
+    return s;
+}
+
+void parseLoop(mb::State& st, const std::string& text) {
+    std::string emsg;
+    PipelineCfg probe;
+    if (text.empty() || !ParseConfig(text, probe, &emsg)) { st.skipWithError("config does not parse: " + emsg); return; }
+    for (auto _ : st) {
+        PipelineCfg cfg;
+        mb::doNotOptimize(ParseConfig(text, cfg, &emsg));
+        mb::doNotOptimize(cfg.models.data());
+    }
+    st.setBytesProcessed(int64_t(st.iterations()) * int64_t(text.size()));
+    st.counters["models"] = double(probe.models.size());
+}
+
+void BM_ParseConfigShipped(mb::State& st) { parseLoop(st, readText(SNPE_MODEL_CONFIG)); }
+MB_BENCHMARK(BM_ParseConfigShipped);
+
+void BM_ParseConfigChain(mb::State& st) { parseLoop(st, syntheticConfig(int(st.range(0)))); }
+MB_BENCHMARK(BM_ParseConfigChain)->arg(4)->arg(16);
+
+// Two sessions of one model map the same file (as prepareModel does): the second
+// request must reuse the first mapping, and the mapping must go with the last owner.
+// Timed: a request served by the live mapping.
+void BM_DlcCacheMapShared(mb::State& st) {
+    DlcCache& cache = DlcCache::instance();
+    const std::string path = SNPE_MODEL_CONFIG;
+    std::string emsg;
+    const size_t before = cache.stats().mappings;
+    auto a = cache.mapFile(path, &emsg);
+    auto b = cache.mapFile(path, &emsg);
+    if (!a || !b) { st.skipWithError("mapFile failed: " + emsg); return; }
+    if (a != b || cache.stats().mappings != before + 1) { st.skipWithError("second open did not share the mapping"); return; }
+    b.reset();
+    for (auto _ : st) mb::doNotOptimize(cache.mapFile(path, &emsg).get());
+    st.counters["bytes"] = double(a->size);
+    a.reset();
+    if (cache.stats().mappings != before) { st.skipWithError("mapping outlived its last owner"); return; }
+}
+MB_BENCHMARK(BM_DlcCacheMapShared);
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string simd = std::string("\"simd\": \"") + simdName() + "\"";
+    return mb::runMain(argc, argv, simd.c_str());
+}
+#endif
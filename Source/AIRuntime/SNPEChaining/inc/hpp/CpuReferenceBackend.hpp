@@ -0,0 +1,150 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "inc/hpp/InferenceBackend.hpp"
+#include "inc/hpp/InitCache.hpp"
+#include "inc/hpp/TensorTypes.hpp"
+
+/**
+ * A synthetic model: one small op with fixed pseudo-random weights, so a chain
+ * built from these is deterministic and runs without SNPE or a device.
+ *
+ * Text form (one line, ';'-separated key=value, dims 'x'-separated):
+ *   op=conv3x3;in=images:1x3x64x64:u8;out=feat:1x8x64x64;seed=7;delay_us=2000
+ *      ;layers=conv1@DSP:6,relu1@DSP:1,nms@CPU:3;quant=images:0.00392157:0
+ *
+ *   op        copy | add | matmul | conv3x3
+ *   in, out   name:dims[:type][,name:dims[:type]...], type f32 (default) | f16 | u8 | u16
+ *   quant     name:scale:offset,...  TfN parameters of u8/u16 tensors (default:
+ *             the range [0, 1])
+ *   seed      weight seed (default 1)
+ *   delay_us  minimum time per execute (compute included), stands in for
+ *             accelerator latency
+ *   spin      1 = busy-wait the delay instead of sleeping (occupies a core)
+ *   prepare_us  one-time graph preparation in build(), stands in for HTP graph
+ *             finalization: skipped by rebuilds and, with setInitCache(), by
+ *             later processes that find the persisted "prepared" container
+ *   load_us   cost of every build(), rebuilds included: loading the prepared
+ *             graph onto the accelerator (what reset_session pays per frame)
+ *   layers    name[@runtime][:weight],...  mock diag source for profiling: the
+ *             delay is reported as these layers, split by weight (default 1,
+ *             runtime CPU_REF), after a layer named after the op for the compute
+ *   runtimes  name:scale,...  runtimes selectRuntime() accepts, each scaling the
+ *             delay (e.g. DSP:1,GPU:1.8,CPU:4); CPU_REF (scale 1) is always there
+ *
+ * Shapes: copy/add take any sizes (inputs wrap around); matmul maps [..., K] to
+ * [..., N] with the same leading size; conv3x3 maps [1, C, H, W] to [1, F, H, W]
+ * (stride 1, zero padding); both have a single output. add sums all inputs,
+ * the others read input 0. The op computes in float32; fp16 and quantized
+ * tensors are converted at the boundary, as an accelerator would.
+ */
+struct CpuModelSpec {
+    enum class Op { COPY, ADD, MATMUL, CONV3X3 };
+
+    Op op = Op::COPY;
+    std::vector<TensorInfo> inputs;
+    std::vector<TensorInfo> outputs;
+    uint32_t seed = 1;
+    int delayUs = 0;
+    int prepareUs = 0;
+    int loadUs = 0;
+    bool spin = false;
+    struct Layer { std::string name; std::string runtime; double weight = 1.0; };
+    std::vector<Layer> layers;
+    struct Quant { std::string tensor; float scale = 1.0f; int32_t offset = 0; };
+    std::vector<Quant> quant;
+    struct Runtime { std::string name; double scale = 1.0; };
+    std::vector<Runtime> runtimes;
+    std::string source;   // the text parsed (the "DLC" the init cache is keyed on)
+
+    static bool parse(const std::string& text, CpuModelSpec& out, std::string* emsg);
+
+    // Retype the tensors named in 'types' (e.g. the model's "io_types"); quantized
+    // ones take their parameters from 'quant'
+    void applyDataTypes(const DataTypeMap& types);
+    void resolveQuant();
+};
+
+class CpuReferenceBackend : public IInferenceBackend {
+public:
+    explicit CpuReferenceBackend(CpuModelSpec spec);
+    ~CpuReferenceBackend() override;
+
+    const char* runtimeName() const override { return runtime_.c_str(); }
+    bool build(std::string* log) override;
+    void release() override;
+    bool ready() const override { return built_; }
+
+    const std::vector<TensorInfo>& inputs() const override { return spec_.inputs; }
+    const std::vector<TensorInfo>& outputs() const override { return spec_.outputs; }
+
+    bool bind(const std::vector<const void*>& inputPtrs,
+              const std::vector<void*>& outputPtrs) override;
+    void unbind() override;
+    bool executeBound() override;
+    bool execute(const std::vector<const void*>& inputPtrs,
+                 const std::vector<void*>& outputPtrs) override;
+
+    // BASIC/MODERATE: one "(network)" record per execute; DETAILED: the op and the
+    // spec's mock layers
+    void setProfilingLevel(ProfilingLevel level) override { profiling_ = level; }
+    bool lastLayerTimings(std::vector<LayerTiming>& out) const override;
+
+    // Host stand-in for SnpeBackend's persisted init cache: after preparing, build()
+    // stores a fake container (the spec text plus a cache record for this runtime
+    // and SoC) in an InitCacheStore; a later backend that finds a matching one
+    // skips prepare_us, one that does not match is evicted.
+    void setInitCache(const std::string& dir, const std::string& model, uint64_t maxBytes = 0);
+    bool preparedFromCache() const { return preparedFromCache_; }
+
+    const CpuModelSpec& spec() const { return spec_; }
+    void setDelayUs(int us) { spec_.delayUs = us; }
+
+    // Host stand-in for choosing an SNPE runtime and performance profile: the delay
+    // is scaled by the spec's factor for 'runtime' and by the profile's clock (BURST
+    // 1.0 up to EXTREME_POWER_SAVER 4.0). False, with nothing changed, if the spec
+    // does not list the runtime or the profile is unknown.
+    bool selectRuntime(const std::string& runtime, const std::string& profile);
+    const std::string& profile() const { return profile_; }
+
+    // Built graphs of every CpuReferenceBackend in the process, and the most seen at
+    // once since resetPeakLiveGraphs() (what reset_session is meant to bound)
+    static size_t liveGraphs();
+    static size_t peakLiveGraphs();
+    static void resetPeakLiveGraphs();
+
+private:
+    bool run_(const std::vector<const void*>& in, const std::vector<void*>& out);
+    void compute_(const std::vector<const void*>& in, const std::vector<void*>& out);
+    void prepare_();
+    bool loadInitCache_(const InitCacheKey& key, const std::string& path) const;
+
+    CpuModelSpec spec_;
+    std::vector<float> weights_;
+    std::vector<float> bias_;
+    bool built_ = false;
+    std::string runtime_ = "CPU_REF";
+    std::string profile_ = "BURST";
+    double delayScale_ = 1.0;
+    ProfilingLevel profiling_ = ProfilingLevel::OFF;
+    uint64_t lastComputeNs_ = 0;
+    uint64_t lastDelayNs_ = 0;
+
+    bool prepared_ = false;            // survives release(), like SNPE's in-memory cache
+    bool preparedFromCache_ = false;
+    std::string cacheDir_, cacheModel_;
+    uint64_t cacheMaxBytes_ = 0;
+
+    // float32 staging for non-float IO (empty when every tensor is float32)
+    std::vector<std::vector<float>> inFloat_, outFloat_;
+    std::vector<const void*> inPtrs_;
+    std::vector<void*> outPtrs_;
+
+    std::vector<const void*> boundIn_;
+    std::vector<void*> boundOut_;
+};
+#endif
@@ -0,0 +1,82 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#if PLATFORM_ANDROID
+#include <android/asset_manager.h>
+#endif
+
+/**
+ * Process-wide registry of read-only DLC mappings keyed by canonical path: the
+ * realpath() of a file, or "asset:<name>" for an uncompressed APK asset. Every
+ * session built from the same model shares one mapping (and keeps it across
+ * reCreate(), through the backend's owner); it is unmapped when the last owner
+ * lets go, as the registry only holds weak references. A file that changed on
+ * disk (device, inode, size or mtime) gets a new mapping instead of the stale one.
+ *
+ * With setWillNeed(true) new mappings are madvise(MADV_WILLNEED)d, so the kernel
+ * starts reading the container in before the runtime parses it.
+ */
+class DlcCache {
+public:
+    struct Mapping {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        std::string key;   // canonical path
+
+        virtual ~Mapping() = default;
+    };
+
+    struct Stats {
+        size_t mappings = 0;       // live, the current one per path
+        uint64_t mappedBytes = 0;  // their total size
+        uint64_t hits = 0;         // requests served by a live mapping
+        uint64_t misses = 0;       // requests that mapped
+    };
+
+    static DlcCache& instance();
+
+    // Null with *emsg if the file cannot be mapped
+    std::shared_ptr<Mapping> mapFile(const std::string& path, std::string* emsg);
+#if PLATFORM_ANDROID
+    // Null with *emsg if the asset is missing or compressed (not mappable)
+    std::shared_ptr<Mapping> mapAsset(AAssetManager* mgr, const std::string& name, std::string* emsg);
+#endif
+
+    void setWillNeed(bool on);
+    bool willNeed() const;
+
+    Stats stats() const;
+    // Bytes of the live mappings that are in memory right now (mincore)
+    uint64_t residentBytes() const;
+
+private:
+    DlcCache() = default;
+
+    struct FileId {
+        uint64_t dev = 0, ino = 0, size = 0;
+        int64_t mtimeNs = 0;
+        bool operator==(const FileId& o) const {
+            return dev == o.dev && ino == o.ino && size == o.size && mtimeNs == o.mtimeNs;
+        }
+    };
+    struct Entry {
+        std::weak_ptr<Mapping> mapping;
+        FileId id;   // files only
+    };
+
+    std::shared_ptr<Mapping> findLocked_(const std::string& key, const FileId& id);
+    void insertLocked_(const std::shared_ptr<Mapping>& m, const FileId& id);
+
+    mutable std::mutex mu_;
+    std::unordered_map<std::string, Entry> entries_;
+    bool willNeed_ = false;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+#endif
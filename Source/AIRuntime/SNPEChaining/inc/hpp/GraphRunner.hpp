@@ -1,4 +1,4 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 #pragma once
 #include <string>
 #include <vector>
@@ -8,6 +8,37 @@
 #include "inc/hpp/TensorWorkspace.hpp"
 #include "inc/hpp/ModelSession.hpp"
 #include "inc/hpp/TensorTypes.hpp"
+#include "inc/hpp/MemoryPlanner.hpp"
+#include "inc/hpp/SessionResidency.hpp"
+#include "inc/hpp/WorkerPool.hpp"
+
+#include <atomic>
+#include <functional>
+
+/**
+ * Output of GraphRunner::compile(): everything a frame needs, resolved up front.
+ * Steps are stored in a topological order of the node DAG (edges from producer to
+ * consumer of a workspace tensor, plus ordering edges between nodes whose buffers
+ * overlap); pointers are the workspace blocks the sessions are bound to.
+ * A plan is tied to the runner that compiled it and goes stale when nodes are
+ * added/cleared or a workspace block moves (runAll() recompiles automatically).
+ */
+struct ExecutionPlan {
+    struct Step {
+        size_t node = 0;                    // index into GraphRunner::getNodes()
+        ModelSession* session = nullptr;
+        std::vector<const void*> inputs;    // session->inputs() order
+        std::vector<void*> outputs;         // session->outputs() order
+        bool rebuildBeforeRun = false;      // reset_session: acquire/release through
+        bool resetAfterRun = false;         // the runner's SessionResidency
+        bool logOutputs = false;
+        uint32_t numDeps = 0;               // incoming edges
+        std::vector<uint32_t> successors;   // indices into steps
+    };
+    std::vector<Step> steps;
+    size_t maxWidth = 1;                    // most steps that can run at once
+    uint64_t wsGeneration = 0;              // TensorWorkspace::generation() at compile
+};
 
 /**
  * GraphRunner orchestrates a sequence of ModelSessions with strict zero-copy edges.
@@ -24,27 +55,117 @@ public:
 
         // For each model output name, which workspace tensor name?
         std::unordered_map<std::string, std::string> outputBinding;
+
+        // Filled by addNode(): workspace ids in session->inputs()/outputs() order
+        std::vector<TensorWorkspace::TensorId> inputIds;
+        std::vector<TensorWorkspace::TensorId> outputIds;
     };
 
-    explicit GraphRunner(TensorWorkspace& ws) : ws_(ws) {}
+    explicit GraphRunner(TensorWorkspace& ws);
+    ~GraphRunner();
 
-    // Strict: check shapes & sizes match allocated blocks.
+    // Strict: check shapes & sizes match allocated blocks. Always: every node bound
+    // to a workspace tensor uses the same element encoding for it.
     bool addNode(Node node, bool strictZeroCopy = true);
 
-    // Execute nodes in order; returns per-node latency and runtime strings
-    struct ExecInfo { std::string name; std::string runtime; int64_t ms = 0; bool ok = false; };
-    std::vector<ExecInfo> runAll(bool reset_session = false);
+    // Shape and encoding of workspace tensor 'id' as the nodes bound to it see it
+    // (null if no node uses it). For writing graph inputs and reading outputs.
+    const TensorInfo* tensorInfo(TensorWorkspace::TensorId id) const;
+
+    // Per-node latency and runtime strings of the last run.
+    // The vector is owned by the runner and overwritten by the next run.
+    struct ExecInfo { std::string name; std::string runtime; int64_t ms = 0; int64_t ns = 0; bool ok = false; };
+
+    // Bind/execute latency distributions of every node's session, in node order
+    struct NodeLatency { std::string name; LatencyStats bind; LatencyStats execute; };
+    std::vector<NodeLatency> nodeLatency() const;
+    void resetLatency();
+
+    // Validate nodes, rebuild missing sessions, resolve and bind every IO buffer.
+    // With reset_session, sessions are instead rebuilt ahead of their step and
+    // released after it, within the setMaxResidentSessions() budget.
+    // Returns null on failure.
+    std::shared_ptr<const ExecutionPlan> compile(bool reset_session = false, std::string* emsg = nullptr);
 
-    void clear() {nodes_.clear();}
+    // Tight loop over a compiled plan: no validation, no lookups, no allocation.
+    // With parallelism > 1, independent steps run concurrently on the worker pool.
+    const std::vector<ExecInfo>& run(const ExecutionPlan& plan);
 
-    void clear_session(Node& node) {node.session.reset();}
+    // Compile if the cached plan is stale, then run it.
+    const std::vector<ExecInfo>& runAll(bool reset_session = false);
+
+    // Worker threads for independent nodes (1 = run sequentially, the default)
+    void setParallelism(size_t threads);
+
+    // reset_session budget: sessions holding a built graph at once (default 2, so
+    // the next node rebuilds in the background while one executes; 1 = rebuild
+    // inline before every node). Applies from the next compile.
+    void setMaxResidentSessions(size_t maxResident) { maxResident_ = maxResident ? maxResident : 1; plan_.reset(); }
+    size_t maxResidentSessions() const { return maxResident_; }
+    // Prefetch counters of the current reset_session plan (zeros without one)
+    SessionResidency::Stats residencyStats() const;
+
+    // Log the first values of every output after each node (debug only: allocates)
+    void setLogOutputs(bool on) { logOutputsEnabled_ = on; plan_.reset(); }
+
+    // Pipelined mode: one thread per node (in plan order) and up to 'inFlight'
+    // frames in the chain at once, so node 1 of frame t+1 overlaps node 2 of frame t.
+    // Every in-flight frame owns a slot: slot 0 uses the workspace tensors as
+    // allocated, slot k > 0 uses copies named "<tensor>@k" (made from the slot 0
+    // contents, so seeded constants carry over). Frames complete in submit order
+    // and 'onDone' runs on the last node's thread before the slot is reused.
+    // runAll() is unavailable while the pipeline runs.
+    using FrameDone = std::function<void(uint64_t seq, size_t slot, const std::vector<ExecInfo>& infos)>;
+    bool startPipeline(size_t inFlight, FrameDone onDone, std::string* emsg = nullptr);
+    // Block until a slot is free, let 'fill' write the frame inputs into it, enqueue it.
+    // Returns the frame sequence number.
+    uint64_t submitFrame(const std::function<void(size_t slot)>& fill);
+    // Wait until every submitted frame was delivered
+    void drainPipeline();
+    // Drain, join the stage threads and release the slot copies
+    void stopPipeline();
+    bool pipelineActive() const { return pipeline_ != nullptr; }
+    // Workspace id holding tensor 'id' in the given slot (slot 0: 'id' itself)
+    TensorWorkspace::TensorId slotTensor(size_t slot, TensorWorkspace::TensorId id) const;
+
+    // Liveness plan for every workspace tensor bound by the nodes, in node order.
+    // Apply it with TensorWorkspace::applyPlan(); bound buffers follow automatically.
+    bool planMemory(MemoryPlan& out, size_t alignment = 64, std::string* emsg = nullptr) const;
+
+    void clear() {stopPipeline(); residency_.reset(); nodes_.clear(); lastRun_.clear(); plan_.reset();}
+
+    void clear_session(Node& node) {stopPipeline(); residency_.reset(); node.session.reset(); plan_.reset();}
 
     Node& last() {return nodes_.back();}
     Node& getNode(std::string name);
     std::vector<Node>& getNodes() {return nodes_;}
 
 private:
+    void logOutputs_(const Node& n) const;
+    bool encodingMatches_(const std::string& nodeName, const TensorInfo& t,
+                          const std::string& wsName) const;
+    void runStep_(const ExecutionPlan::Step& st, ExecInfo& e);
+    void runParallelStep_(uint32_t idx);
+    // Derive successors/numDeps, reorder steps topologically; false on a cycle
+    bool buildDag_(ExecutionPlan& plan, std::string* emsg) const;
+
     TensorWorkspace& ws_;
     std::vector<Node> nodes_;
+    // Sessions of a reset_session plan; declared after nodes_ so it stops first
+    std::unique_ptr<SessionResidency> residency_;
+    size_t maxResident_ = 2;
+    std::vector<ExecInfo> lastRun_;   // one entry per node, reused across runs
+    bool logOutputsEnabled_ = false;
+    // Cached plan used by runAll()
+    std::shared_ptr<const ExecutionPlan> plan_;
+    bool planReset_ = false;
+
+    std::unique_ptr<WorkerPool> pool_;
+    const ExecutionPlan* running_ = nullptr;            // plan being run in parallel
+    std::unique_ptr<std::atomic<uint32_t>[]> pendingDeps_;
+    size_t pendingCap_ = 0;
+
+    struct Pipeline;                    // GraphRunner.cpp
+    std::unique_ptr<Pipeline> pipeline_;
 };
 #endif
\ No newline at end of file
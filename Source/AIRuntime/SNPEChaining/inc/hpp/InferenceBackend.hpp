@@ -0,0 +1,48 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <string>
+#include <vector>
+
+#include "inc/hpp/LayerProfiler.hpp"
+#include "inc/hpp/TensorTypes.hpp"
+
+/**
+ * What ModelSession needs from an inference engine: IO metadata, a graph that
+ * can be built and released, and execution on caller-owned buffers.
+ * SnpeBackend is the device implementation; CpuReferenceBackend runs anywhere.
+ *
+ * Buffers are given in inputs()/outputs() order. release() only drops the
+ * executable graph: IO metadata and bindings survive, so build() followed by
+ * executeBound() works without binding again.
+ */
+class IInferenceBackend {
+public:
+    virtual ~IInferenceBackend() = default;
+
+    // Name of the runtime actually used (e.g. "DSP", "CPU_REF").
+    virtual const char* runtimeName() const = 0;
+
+    // (Re)builds the graph. False, with a note appended to *log, on failure.
+    virtual bool build(std::string* log) = 0;
+    virtual void release() = 0;
+    virtual bool ready() const = 0;
+
+    virtual const std::vector<TensorInfo>& inputs() const = 0;
+    virtual const std::vector<TensorInfo>& outputs() const = 0;
+
+    // Pointers must stay valid until the next bind()/unbind().
+    virtual bool bind(const std::vector<const void*>& inputPtrs,
+                      const std::vector<void*>& outputPtrs) = 0;
+    virtual void unbind() = 0;
+    virtual bool executeBound() = 0;
+
+    // One-shot: pointers only need to be valid during the call.
+    virtual bool execute(const std::vector<const void*>& inputPtrs,
+                         const std::vector<void*>& outputPtrs) = 0;
+
+    // Opt-in profiling. Backends that fix it at build time apply it on the next build().
+    virtual void setProfilingLevel(ProfilingLevel level) { (void)level; }
+    // Layer timings of the last execute; false when profiling is off or unsupported.
+    virtual bool lastLayerTimings(std::vector<LayerTiming>& out) const { (void)out; return false; }
+};
+#endif
@@ -0,0 +1,64 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Identifies one prepared graph. A cache entry is only usable by the exact model
+// bytes, library version, runtime and SoC that produced it.
+struct InitCacheKey {
+    std::string model;       // entry group, usually the DLC file name
+    uint64_t dlcHash = 0;    // InitCacheStore::hashBytes of the original container
+    std::string libVersion;  // e.g. SNPEFactory::getLibraryVersion().toString()
+    std::string runtime;     // selected runtime ("DSP", "CPU_REF", ...)
+    std::string socId;       // socIdentifier()
+
+    // "<model>.<hash>.<runtime>.<soc>.<version>.initcache.dlc", filesystem-safe
+    std::string fileName() const;
+};
+
+/**
+ * Directory of cache-augmented containers: after the first build with
+ * setInitCacheMode(true) the backend saves its container here, and later starts
+ * load it instead of the original so the graph preparation is skipped.
+ *
+ * Entries are written to a temporary file and renamed, so a crash never leaves a
+ * truncated entry under a valid name. store() also evicts the entries of the same
+ * model made for another key (new DLC, library update, other runtime) and then,
+ * if maxBytes is set, the least recently used entries of any model until the
+ * directory fits. The backend validates what find() returns and evict()s an
+ * entry the runtime rejects.
+ */
+class InitCacheStore {
+public:
+    explicit InitCacheStore(std::string dir, uint64_t maxBytes = 0)
+        : dir_(std::move(dir)), maxBytes_(maxBytes) {}
+
+    const std::string& dir() const { return dir_; }
+
+    // Path of the entry for 'key', empty if there is none. Touches its mtime (LRU).
+    std::string find(const InitCacheKey& key) const;
+
+    // 'save' writes the container to the path it is given. False if it fails.
+    bool store(const InitCacheKey& key, const std::function<bool(const std::string& path)>& save);
+
+    void evict(const InitCacheKey& key);
+
+    // Total size of the entries in dir()
+    uint64_t bytes() const;
+
+    // 64-bit content hash (keying only, not cryptographic)
+    static uint64_t hashBytes(const void* data, size_t n);
+
+private:
+    void evictStale_(const InitCacheKey& keep);
+
+    std::string dir_;
+    uint64_t maxBytes_ = 0;
+};
+
+// SoC of this device (/sys/devices/soc0/soc_id, else ro.soc.model); "host" on
+// host builds without that sysfs node
+const std::string& socIdentifier();
+#endif
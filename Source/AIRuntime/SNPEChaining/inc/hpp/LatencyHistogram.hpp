@@ -0,0 +1,97 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Summary of a LatencyHistogram, in nanoseconds. Percentiles are upper bounds of
+// the bucket holding the rank (at most ~3% above the true value); min/max are exact.
+struct LatencyStats {
+    uint64_t count = 0;
+    uint64_t minNs = 0;
+    uint64_t maxNs = 0;
+    double meanNs = 0.0;
+    uint64_t p50Ns = 0;
+    uint64_t p90Ns = 0;
+    uint64_t p99Ns = 0;
+};
+
+/**
+ * Fixed-bucket latency histogram (HDR style: linear below 64 ns, then 32
+ * sub-buckets per power of two up to ~18 minutes). record() is lock-free and
+ * wait-free (relaxed atomic adds), so one histogram can be shared by a stage
+ * running on several threads; snapshots taken while recording are approximate
+ * but never torn per bucket.
+ */
+class LatencyHistogram {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int kSubBits = 5;
+    static constexpr uint64_t kSubCount = uint64_t(1) << kSubBits;  // 32
+    static constexpr int kMaxBits = 40;                               // 2^40 ns ~ 18 min
+    static constexpr size_t kBuckets = size_t(kMaxBits - kSubBits + 1) * kSubCount;
+
+    LatencyHistogram() { reset(); }
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t ns) {
+        counts_[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t cur = min_.load(std::memory_order_relaxed);
+        while (ns < cur && !min_.compare_exchange_weak(cur, ns, std::memory_order_relaxed)) {}
+        cur = max_.load(std::memory_order_relaxed);
+        while (ns > cur && !max_.compare_exchange_weak(cur, ns, std::memory_order_relaxed)) {}
+    }
+    void recordSince(Clock::time_point t0) {
+        const auto d = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+        record(d > 0 ? uint64_t(d) : 0);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    // Value at quantile q in [0, 1]; 0 when empty
+    uint64_t percentile(double q) const;
+    LatencyStats stats() const;
+    // Not atomic with respect to concurrent record() calls
+    void reset();
+
+    static size_t bucketOf(uint64_t ns) {
+        if (ns < 2 * kSubCount) return size_t(ns);
+        const int msb = 63 - __builtin_clzll(ns);
+        if (msb > kMaxBits) return kBuckets - 1;
+        const int shift = msb - kSubBits;
+        return size_t(shift + 1) * kSubCount + size_t((ns >> shift) - kSubCount);
+    }
+    // Largest value that lands in bucket b
+    static uint64_t bucketUpper(size_t b) {
+        if (b < 2 * kSubCount) return b;
+        const int shift = int(b / kSubCount) - 1;
+        const uint64_t sub = b % kSubCount + kSubCount;
+        return ((sub + 1) << shift) - 1;
+    }
+
+private:
+    std::atomic<uint64_t> counts_[kBuckets];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+// Records the lifetime of the scope into 'h' (nothing if h is null)
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram* h) : h_(h), t0_(h ? LatencyHistogram::Clock::now()
+                                                               : LatencyHistogram::Clock::time_point()) {}
+    ~ScopedLatency() { if (h_) h_->recordSince(t0_); }
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram* h_;
+    LatencyHistogram::Clock::time_point t0_;
+};
+#endif
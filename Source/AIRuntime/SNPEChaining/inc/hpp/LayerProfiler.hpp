@@ -0,0 +1,67 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Mirrors zdl::DlSystem::ProfilingLevel_t: BASIC and MODERATE report the network
+// as a whole, DETAILED adds per-layer records.
+enum class ProfilingLevel { OFF, BASIC, MODERATE, DETAILED };
+
+// "off" | "basic" | "moderate" | "detailed"
+bool parseProfilingLevel(const std::string& text, ProfilingLevel& out);
+const char* profilingLevelName(ProfilingLevel level);
+
+// One layer of one execute, as reported by a backend's diag source
+struct LayerTiming {
+    std::string layer;
+    std::string runtime;
+    uint64_t ns = 0;
+};
+
+struct LayerHotspot {
+    std::string layer;
+    std::string runtime;
+    uint64_t count = 0;
+    double meanUs = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+    double share = 0.0;  // of the summed time of every layer, 0..1
+};
+
+/**
+ * Aggregates per-layer timings over a window of executes and ranks the layers by
+ * total time. Keeps every sample of the window (exact p99), so size the window
+ * to what you want to average over, not to the session lifetime.
+ * Not thread-safe: one session feeds it from its executing thread.
+ */
+class LayerProfiler {
+public:
+    explicit LayerProfiler(size_t windowFrames = 100) : window_(windowFrames ? windowFrames : 1) {}
+
+    void addFrame(const std::vector<LayerTiming>& layers);
+    size_t frames() const { return frames_; }
+    bool windowFull() const { return frames_ >= window_; }
+
+    // Sorted by total time, largest first
+    std::vector<LayerHotspot> hotspots() const;
+    // Fixed-width text table of the first 'topN' hotspots (0 = all)
+    std::string table(const std::string& title, size_t topN = 0) const;
+    void reset();
+
+private:
+    struct Entry {
+        std::string layer;
+        std::string runtime;
+        std::vector<uint64_t> samples;
+        uint64_t sumNs = 0;
+    };
+
+    size_t window_;
+    size_t frames_ = 0;
+    std::vector<Entry> entries_;                     // first-seen order
+    std::unordered_map<std::string, size_t> index_;  // layer '\n' runtime -> entries_
+};
+#endif
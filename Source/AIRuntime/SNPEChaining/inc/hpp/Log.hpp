@@ -0,0 +1,50 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+
+// Logging for the SNPEChaining core: logcat on Android, stderr on host builds
+// (SNPE_CHAINING_HOST). Files keep their own tagged LOGx_ macros on top of SNPE_LOG.
+#if PLATFORM_ANDROID
+#include <android/log.h>
+
+#define SNPE_LOG_INFO  ANDROID_LOG_INFO
+#define SNPE_LOG_WARN  ANDROID_LOG_WARN
+#define SNPE_LOG_ERROR ANDROID_LOG_ERROR
+#define SNPE_LOG(prio, tag, ...) __android_log_print(prio, tag, __VA_ARGS__)
+
+#else
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+enum { SNPE_LOG_INFO = 4, SNPE_LOG_WARN = 5, SNPE_LOG_ERROR = 6, SNPE_LOG_OFF = 8 };
+
+// Lowest priority printed, from SNPE_LOG_LEVEL=info|warn|error|off (default warn,
+// so timing loops are not dominated by log output).
+inline int snpeHostLogLevel() {
+    static const int level = [] {
+        const char* s = std::getenv("SNPE_LOG_LEVEL");
+        if (!s) return int(SNPE_LOG_WARN);
+        if (!std::strcmp(s, "info")) return int(SNPE_LOG_INFO);
+        if (!std::strcmp(s, "error")) return int(SNPE_LOG_ERROR);
+        if (!std::strcmp(s, "off")) return int(SNPE_LOG_OFF);
+        return int(SNPE_LOG_WARN);
+    }();
+    return level;
+}
+
+__attribute__((format(printf, 3, 4)))
+inline void snpeHostLog(int prio, const char* tag, const char* fmt, ...) {
+    if (prio < snpeHostLogLevel()) return;
+    const char p = prio >= SNPE_LOG_ERROR ? 'E' : prio >= SNPE_LOG_WARN ? 'W' : 'I';
+    std::fprintf(stderr, "%c/%s: ", p, tag);
+    va_list ap;
+    va_start(ap, fmt);
+    std::vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    std::fputc('\n', stderr);
+}
+
+#define SNPE_LOG(prio, tag, ...) snpeHostLog(prio, tag, __VA_ARGS__)
+#endif
+#endif
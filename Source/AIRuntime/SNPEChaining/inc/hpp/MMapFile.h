@@ -1,4 +1,4 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 #pragma once
 
 // POSIX / NDK
@@ -0,0 +1,52 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Offsets for workspace tensors inside one shared arena.
+ * Tensors whose live ranges [firstUse, lastUse] (node indices, inclusive) never
+ * overlap may be given overlapping byte ranges.
+ */
+struct MemoryPlan {
+    struct Slot {
+        std::string name;       // workspace tensor (owner name, not an alias)
+        size_t offset = 0;      // bytes from arena base
+        size_t bytes = 0;
+        int firstUse = 0;
+        int lastUse = 0;
+        bool pinned = false;    // graph input/output/state: live for the whole pipeline
+    };
+    std::vector<Slot> slots;
+    size_t alignment = 64;
+    size_t arenaBytes = 0;      // peak: size of the shared arena
+    size_t naiveBytes = 0;      // sum of all slot sizes (one block per tensor)
+};
+
+/**
+ * Liveness-based planner. Input is the node order with the workspace tensors each
+ * node reads and writes; output is a MemoryPlan built greedily by size
+ * (largest tensors placed first at the lowest offset that does not collide with
+ * an already placed, simultaneously live tensor).
+ *
+ * Tensors that are never written by a node (roots seeded by the app/config),
+ * never read by a node (final outputs read by the app) or read before they are
+ * written (state carried across frames) are pinned for the whole pipeline.
+ */
+class MemoryPlanner {
+public:
+    struct Step {
+        std::vector<std::string> reads;   // workspace tensor names
+        std::vector<std::string> writes;
+    };
+
+    static bool plan(const std::vector<Step>& steps,
+                     const std::unordered_map<std::string, size_t>& bytes,
+                     size_t alignment,
+                     MemoryPlan& out,
+                     std::string* emsg);
+};
+#endif
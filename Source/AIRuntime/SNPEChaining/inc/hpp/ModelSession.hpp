@@ -1,77 +1,101 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 #pragma once
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
-#include "SNPE/SNPE.hpp"
-#include "SNPE/SNPEFactory.hpp"
-#include "SNPE/SNPEBuilder.hpp"
-#include "DlContainer/IDlContainer.hpp"
-#include "DlSystem/DlEnums.hpp"
-#include "DlSystem/StringList.hpp"
-#include "DlSystem/IUserBuffer.hpp"
-#include "DlSystem/UserBufferMap.hpp"
-#include "DlSystem/RuntimeList.hpp"
-
+#include "inc/hpp/InferenceBackend.hpp"
+#include "inc/hpp/LatencyHistogram.hpp"
+#include "inc/hpp/LayerProfiler.hpp"
 #include "inc/hpp/TensorTypes.hpp"
+#if PLATFORM_ANDROID
+#include "inc/hpp/SnpeBackend.hpp"
+#endif
 
+/**
+ * One model as the graph sees it: IO metadata, name-based and pre-bound
+ * execution, timing. The engine behind it is an IInferenceBackend (SNPE on
+ * device, the CPU reference backend on host builds).
+ */
 class ModelSession {
 public:
-    struct Options {
-        zdl::DlSystem::RuntimeList runtimeOrder;
-        zdl::DlSystem::PerformanceProfile_t perf =
-                zdl::DlSystem::PerformanceProfile_t::HIGH_PERFORMANCE;
-        bool useUserSuppliedBuffers = true;
-        bool initCache = false;
+    struct ProfilingOptions {
+        ProfilingLevel level = ProfilingLevel::OFF;
+        size_t frames = 100;     // executes per report
+        size_t topN = 20;        // rows in the report (0 = all)
+        std::string title;       // report heading, e.g. the node name
+        std::string reportPath;  // also write each report here (empty = log only)
     };
 
-//    struct DlcBacking {
-//        std::shared_ptr<MMapFile> file;
-//        std::shared_ptr<MMapAsset> asset;
-//    };
+#if PLATFORM_ANDROID
+    using Options = SnpeBackend::Options;
 
     // Factory: takes a DLC buffer
     static std::unique_ptr<ModelSession> Create(const uint8_t* dlc, size_t bytes,
                                                 std::shared_ptr<void> dlcOwner,
                                                 const Options& opt,
                                                 std::string* buildLog /*optional*/);
+#endif
+
+    // Factory over any backend; builds it if it is not ready yet. Null on failure.
+    static std::unique_ptr<ModelSession> Create(std::unique_ptr<IInferenceBackend> backend,
+                                                std::string* buildLog /*optional*/);
 
     void reCreate(std::string* buildLog);
 
     // Introspection
-    const std::vector<TensorInfo>& inputs()  const { return inputs_;  }
-    const std::vector<TensorInfo>& outputs() const { return outputs_; }
+    const std::vector<TensorInfo>& inputs()  const { return backend_->inputs();  }
+    const std::vector<TensorInfo>& outputs() const { return backend_->outputs(); }
     const std::string& selectedRuntimeName() const { return runtimeName_; }
-    const zdl::SNPE::SNPE* getSnpe() const { return snpe_.get(); }
+    bool ready() const { return backend_->ready(); }
+    IInferenceBackend* backend() const { return backend_.get(); }
 
-    // reset
+    // reset: frees the graph, keeps IO metadata and bindings (reCreate() restores it)
     void reset();
 
     // One-shot execution. Pointers must be valid during the call.
     // Returns elapsed ms in *elapsedMs if not null.
+    // Every call lands in executeLatency(), every bind() in bindLatency().
     bool execute(const std::unordered_map<std::string, const void*>& inputPtrs,
                  const std::unordered_map<std::string, void*>& outputPtrs,
                  int64_t* elapsedMs) const;
 
+    // Pre-bound execution: the backend keeps its per-tensor buffers across frames.
+    // Calling bind() again with the same pointers is a no-op; a pointer that moved
+    // only retargets its buffer. Pointers must stay valid until the next bind()/unbind().
+    bool bind(const std::unordered_map<std::string, const void*>& inputPtrs,
+              const std::unordered_map<std::string, void*>& outputPtrs);
+    // Same, with pointers in inputs()/outputs() order (no name lookups).
+    bool bind(const std::vector<const void*>& inputPtrs,
+              const std::vector<void*>& outputPtrs);
+    bool executeBound(int64_t* elapsedMs, int64_t* elapsedNs = nullptr);
+    bool isBound() const { return bound_; }
+    void unbind();
+
+    // Per-session latency distributions (ns), safe to read from any thread
+    const LatencyHistogram& bindLatency() const { return bindLatency_; }
+    const LatencyHistogram& executeLatency() const { return executeLatency_; }
+    void resetLatency() { bindLatency_.reset(); executeLatency_.reset(); }
+
+    // Opt-in profiling: after every execute the backend's layer timings go into a
+    // LayerProfiler; every opt.frames executes the hotspot table is logged (and
+    // written to opt.reportPath) and the window restarts. OFF drops the profiler.
+    void setProfiling(const ProfilingOptions& opt);
+    const LayerProfiler* profiler() const { return profiler_.get(); }
+
 private:
     ModelSession() = default;
 
-    // SNPE objects
-    std::unique_ptr<zdl::SNPE::SNPE> snpe_;
+    std::unique_ptr<IInferenceBackend> backend_;
     std::string runtimeName_;
-    Options opt_;
-//    std::unique_ptr<zdl::SNPE::SNPEBuilder> builder_;
-    std::unique_ptr<zdl::DlContainer::IDlContainer> container_;
-    std::shared_ptr<const uint8_t> dlcBacking_;
-    std::shared_ptr<void> dlcOwner_;
-
-    // IO metadata (float32 assumed at boundaries)
-    std::vector<TensorInfo> inputs_;
-    std::vector<TensorInfo> outputs_;
+    bool bound_ = false;
+    mutable LatencyHistogram bindLatency_;
+    mutable LatencyHistogram executeLatency_;
 
-    // Helper to probe IO and fill inputs_/outputs_
-    void captureIO_();
+    void collectProfile_() const;
+    ProfilingOptions profiling_;
+    std::unique_ptr<LayerProfiler> profiler_;
+    mutable std::vector<LayerTiming> layerScratch_;
 };
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,66 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "inc/hpp/ParseConfig.hpp"
+#include "inc/hpp/PoseDecoder.hpp"
+#include "inc/hpp/TensorTypes.hpp"
+#include "inc/hpp/TensorView.hpp"
+
+// Per-frame knobs owned by the caller (e.g. actor properties), not by the config
+struct DecodeLimits {
+    float scoreThreshold = 0.5f;
+    float iouThreshold = 0.45f;
+    int maxDetections = 8;
+};
+
+/**
+ * Turns one model output tensor into detections (boxes, optional keypoints) in
+ * model-input pixels, best first. prepare() sees the output shape once and sizes
+ * every scratch buffer; decode() then reads the workspace through a TensorView
+ * and does not allocate.
+ */
+class IOutputDecoder {
+public:
+    virtual ~IOutputDecoder() = default;
+
+    virtual const char* type() const = 0;
+
+    // False (with *emsg) if the output shape does not fit this decoder.
+    virtual bool prepare(const TensorInfo& output, std::string* emsg) = 0;
+
+    virtual bool decode(const TensorView<float>& output, const DecodeLimits& limits) = 0;
+
+    virtual const std::vector<PoseDetection>& detections() const = 0;
+};
+
+/**
+ * Decoder types by name, as used in model-config.json ("decoder": {"type": ...}).
+ * Built in: "yolo_pose", "yolo_detect", "heatmap_pose", "raw".
+ */
+class OutputDecoderRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<IOutputDecoder>(const DecoderCfg&)>;
+
+    static OutputDecoderRegistry& instance();
+
+    // Adds or replaces a type.
+    void add(const std::string& type, Factory factory);
+
+    // Null (with *emsg) for an unknown type.
+    std::unique_ptr<IOutputDecoder> create(const DecoderCfg& cfg, std::string* emsg) const;
+
+    std::vector<std::string> types() const;
+
+private:
+    OutputDecoderRegistry();
+
+    mutable std::mutex mu_;
+    std::unordered_map<std::string, Factory> factories_;
+};
+#endif
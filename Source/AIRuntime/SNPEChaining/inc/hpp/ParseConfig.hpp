@@ -1,9 +1,31 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 #pragma once
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "inc/hpp/TensorTypes.hpp"
+
+// Optional per-model "decoder": { "type": "yolo_pose", "output": "output_0", "<param>": <number|bool>, ... }
+struct DecoderCfg {
+    std::string type;    // OutputDecoderRegistry key; empty = not configured
+    std::string output;  // workspace tensor to decode; empty = the model's first output
+    std::unordered_map<std::string, double> params; // decoder-specific, booleans as 0/1
+
+    double get(const std::string& key, double def) const {
+        auto it = params.find(key);
+        return it == params.end() ? def : it->second;
+    }
+};
+
+// Optional per-model "profiling": { "level": "detailed", "frames": 100, "top": 20, "report": "pose.txt" }
+struct ProfilingCfg {
+    std::string level;   // off | basic | moderate | detailed; empty = not configured
+    size_t frames = 100; // executes per hotspot report
+    size_t top = 20;     // rows per report (0 = all)
+    std::string report;  // report file, relative to the model directory; empty = log only
+};
+
 struct ModelCfg {
     std::string name;
     std::string asset;
@@ -11,6 +33,12 @@ struct ModelCfg {
     char runtime = 'D'; // 'D'|'G'|'C' or 0 if absent
     std::unordered_map<std::string, std::string> inputs;
     std::unordered_map<std::string, std::string> outputs;
+    DecoderCfg decoder;
+    ProfilingCfg profiling;
+    // Optional "io_types": { "<model tensor>|*": "float32|fp16|uint8|uint16" }. Buffer
+    // types of the model's IO; quantized scale/offset come from the model itself.
+    // "*" is expanded over the tensors in inputs/outputs that are not named.
+    DataTypeMap ioTypes;
 };
 
 // In your config types (e.g., ParseConfig.hpp)
@@ -26,9 +54,40 @@ struct InitSpec {
 };
 
 
+// Optional top-level "init_cache": { "enabled": true, "dir": "cache", "max_mb": 256 }.
+// Where graphs prepared with SNPE's init cache are persisted across launches.
+struct InitCacheCfg {
+    bool enabled = true;
+    std::string dir;     // relative to the model directory; empty = the model directory
+    size_t maxMb = 0;    // total size of the stored entries (0 = unlimited)
+};
+
+// Optional top-level "tuning": { "enabled": true, "table": "tuning.tsv", "objective": "p95"|"power",
+//   "budget_ms": 20, "warmup": 3, "iterations": 20, "runtimes": ["DSP","GPU"], "profiles": ["BURST", ...] }.
+// Each model's runtime and performance profile come from the decision table when it
+// has one for the model on this device; otherwise (enabled) they are measured once
+// and the decision is stored; "enabled": false only applies stored decisions. A
+// model's own "runtime" is the fallback when neither gives one.
+struct TuningCfg {
+    bool enabled = false;              // true once "tuning" is given
+    std::string table;                 // relative to the model directory; empty = no tuning
+                                       // ("tuning" given without one: "tuning.tsv")
+    std::string objective = "p95";     // p95 | power
+    double budgetMs = 0.0;             // power: p95 budget per model
+    size_t warmup = 3;
+    size_t iterations = 20;
+    std::vector<std::string> runtimes; // empty = DSP, GPU, CPU
+    std::vector<std::string> profiles; // empty = BURST, HIGH_PERFORMANCE, BALANCED, POWER_SAVER
+};
+
 struct PipelineCfg {
     std::vector<ModelCfg> models;
     std::string baseDir;
+    InitCacheCfg initCache;
+    TuningCfg tuning;
+    // Optional "build_threads": models opened and built concurrently at startup
+    // (0 = min(models, 4, cores); 1 = one after the other)
+    size_t buildThreads = 0;
     std::unordered_map<std::string, InitSpec> init; // wsTensorName -> InitSpec
 };
 
@@ -0,0 +1,79 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "inc/hpp/ScoreReduce.hpp"
+#include "inc/hpp/TensorView.hpp"
+
+// One person (or object, numKeypoints = 0) from a detection head, in model-input pixels
+struct PoseDetection {
+    static constexpr int kMaxKeypoints = 17;
+    float cx = 0, cy = 0, w = 0, h = 0;   // box centre / size
+    float score = 0;
+    int anchor = -1;
+    int classId = 0;
+    int numKeypoints = 0;
+    float kpX[kMaxKeypoints] = {};
+    float kpY[kMaxKeypoints] = {};
+    float kpVis[kMaxKeypoints] = {};
+};
+
+/**
+ * Multi-person decoder for channel-major YOLO-pose output ([channels][anchors]).
+ * Every anchor above the score threshold is a candidate; candidates are sorted
+ * by score and pruned with IoU NMS (vectorized: one kept box against four
+ * candidates per step, division-free IoU test). Scratch buffers are reused, so
+ * steady-state decoding does not allocate.
+ */
+class PoseDecoder {
+public:
+    struct Params {
+        int numAnchors = 1344;
+        int numChannels = 56;
+        int boxChannel = 0;         // cx, cy, w, h
+        int scoreChannel = 55;
+        int keypointChannel = 4;    // 3 channels per keypoint
+        int numKeypoints = 17;
+        bool visibilityFirst = true; // per keypoint: (vis, x, y) instead of (x, y, vis)
+        float scoreThreshold = 0.5f;
+        float iouThreshold = 0.45f;
+        int maxDetections = 8;
+        int maxCandidates = 300;    // best candidates kept for NMS
+    };
+
+    PoseDecoder() = default;
+    explicit PoseDecoder(const Params& p) : p_(p) {}
+
+    const Params& params() const { return p_; }
+    void setParams(const Params& p) { p_ = p; }
+
+    // Size every scratch buffer for up to 'anchors' candidates, so decode() never allocates.
+    void reserve(size_t anchors);
+
+    // out: numChannels * numAnchors floats. Results in detections(), best first.
+    bool decode(const float* out, size_t floats);
+    // Same on a [.., channels, anchors] view; numChannels/numAnchors follow its shape.
+    bool decode(const TensorView<float>& out);
+    const std::vector<PoseDetection>& detections() const { return dets_; }
+
+    // Score-row argmax and above-threshold anchors of the last decode(), so other
+    // consumers of the same frame do not rescan the scores.
+    const ScoreScan& scan() const { return scan_; }
+
+    // NMS over candidate anchors already sorted by descending score; keeps at most
+    // maxKeep survivors in 'keep'. Exposed for benchmarks.
+    void nms(const float* out, const std::vector<int>& sorted, size_t maxKeep, std::vector<int>& keep);
+
+private:
+    Params p_;
+    ScoreScan scan_;
+    std::vector<int> cand_;
+    std::vector<int> keep_;
+    // SoA corners/areas of the sorted candidates
+    std::vector<float> x1_, y1_, x2_, y2_, area_;
+    std::vector<uint32_t> suppressed_;
+    std::vector<PoseDetection> dets_;
+};
+#endif
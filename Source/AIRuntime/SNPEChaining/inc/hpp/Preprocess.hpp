@@ -0,0 +1,100 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "inc/hpp/TensorTypes.hpp"
+
+/**
+ * Where the camera image lands inside the model input, per axis:
+ *   model = source * scale + pad      (pixels)
+ * STRETCH fills the whole input (pad 0, independent scales); LETTERBOX keeps
+ * the aspect ratio and centres the image between pad bands.
+ */
+struct LetterboxTransform {
+    float scaleX = 1.0f;
+    float scaleY = 1.0f;
+    float padX = 0.0f;
+    float padY = 0.0f;
+    int roiX = 0, roiY = 0, roiW = 0, roiH = 0;   // model-input rectangle holding the image
+
+    float toModelX(float sx) const { return sx * scaleX + padX; }
+    float toModelY(float sy) const { return sy * scaleY + padY; }
+    float toSourceX(float mx) const { return (mx - padX) / scaleX; }
+    float toSourceY(float my) const { return (my - padY) / scaleY; }
+};
+
+/**
+ * Packed RGB8 (HWC) camera frame -> planar float CHW model input, in one pass:
+ * nearest-neighbour resize (stretched or letterboxed), out = pixel * scale + bias,
+ * channel de-interleave. The destination is written directly (typically
+ * TensorWorkspace::data("images")).
+ *
+ * configure() builds the source row/column tables and the LetterboxTransform for
+ * one input resolution; run() reuses them until the resolution changes, so steady
+ * state does no division and no allocation.
+ *
+ * Models with fp16 or quantized (TfN) inputs are fed through the overload taking
+ * a TensorInfo: the 256 possible pixel values are encoded once, so the kernel
+ * writes final bytes with one table lookup per element.
+ */
+class ImagePreprocessor {
+public:
+    enum class Fit { STRETCH, LETTERBOX };
+
+    struct Params {
+        int dstW = 256;
+        int dstH = 256;
+        float scale = 1.0f / 255.0f;
+        float bias = 0.0f;
+        Fit fit = Fit::STRETCH;
+        float padValue = 114.0f / 255.0f;   // output value of the letterbox bands
+    };
+
+    ImagePreprocessor() = default;
+    explicit ImagePreprocessor(const Params& p) : p_(p) {}
+
+    const Params& params() const { return p_; }
+
+    // Rebuild tables if (srcW, srcH) changed. False for a degenerate size.
+    bool configure(int srcW, int srcH);
+
+    // srcStride in bytes (0 = srcW * 3). dst holds 3 * dstW * dstH floats.
+    bool run(const uint8_t* rgb, int srcW, int srcH, size_t srcStride, float* dst);
+
+    // Same result without SIMD (reference for checks and benchmarks)
+    bool runScalar(const uint8_t* rgb, int srcW, int srcH, size_t srcStride, float* dst);
+
+    // Same, into a buffer encoded as 'dstInfo' (float32, fp16, uint8/uint16 TfN),
+    // which must hold 3 * dstW * dstH elements
+    bool run(const uint8_t* rgb, int srcW, int srcH, size_t srcStride, void* dst,
+             const TensorInfo& dstInfo);
+
+    size_t outputFloats() const { return size_t(3) * p_.dstW * p_.dstH; }
+
+    // Transform of the last configured resolution
+    const LetterboxTransform& transform() const { return t_; }
+
+private:
+    template <typename T> void fillPad_(T* dst, T value) const;
+    // After configure(); srcW only defaults the stride
+    template <typename T> bool runTable_(const uint8_t* rgb, int srcW, size_t srcStride, T* dst);
+    void buildTable_(const TensorInfo& info);
+
+    Params p_;
+    LetterboxTransform t_;
+    int srcW_ = 0;
+    int srcH_ = 0;
+    std::vector<int32_t> xOff_;   // byte offset of the source pixel for every ROI column
+    int xVecEnd_ = 0;             // ROI columns [0, xVecEnd_) may load 4 bytes per pixel
+    std::vector<int32_t> yRow_;   // source row for every ROI row
+
+    // Encoded pixel * scale + bias for every byte value (and the pad value), for
+    // the encoding in tableInfo_
+    bool tableValid_ = false;
+    TensorInfo tableInfo_;
+    uint16_t table_[256] = {};
+    uint16_t tablePad_ = 0;
+};
+#endif
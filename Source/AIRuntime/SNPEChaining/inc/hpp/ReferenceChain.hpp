@@ -0,0 +1,28 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <string>
+
+#include "inc/hpp/GraphRunner.hpp"
+#include "inc/hpp/ParseConfig.hpp"
+#include "inc/hpp/TensorWorkspace.hpp"
+
+// Host counterpart of buildArbitraryChain(): each model's "asset" is a CpuModelSpec,
+// inline as "cpu:<spec>" or the name of a file under cfg.baseDir holding one.
+// Builds the models on up to cfg.buildThreads threads, then allocates the bound
+// workspace tensors, adds one CpuReferenceBackend node per model in config order
+// and seeds the graph inputs from cfg.init. With a model
+// directory or cfg.initCache.dir the backends persist their prepared graphs there;
+// with cfg.tuning each model's runtime and profile come from (or are tuned into)
+// the decision table, as ModelSession::Create does on device.
+// delayUsOverride >= 0 replaces every model's delay_us. resetSessions (reset_session)
+// releases each graph right after its build and builds at most
+// gr.maxResidentSessions() at once. False with *emsg on failure; per-model build
+// notes are appended to *log.
+bool buildReferenceChain(const PipelineCfg& cfg,
+                         TensorWorkspace& ws,
+                         GraphRunner& gr,
+                         std::string* log,
+                         std::string* emsg,
+                         int delayUsOverride = -1,
+                         bool resetSessions = false);
+#endif
@@ -0,0 +1,119 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ModelSession;
+struct TuningCfg;
+
+// What a tuning run optimises:
+//   P95    the candidate with the lowest p95 execute latency
+//   POWER  the lowest-power profile whose p95 fits budgetMs (the fastest if none does)
+enum class TuneObjective { P95, POWER };
+
+// "p95" | "power"
+bool parseTuneObjective(const std::string& s, TuneObjective& out);
+
+// Performance profile names ordered by the clocks they vote for: lower rank draws
+// less power. -1 for names that are not profiles.
+int profilePowerRank(const std::string& profile);
+
+struct TuneCandidate {
+    std::string runtime;   // "DSP" | "GPU" | "CPU" (or a backend's own name)
+    std::string profile;   // PerformanceProfile_t name, e.g. "BURST"
+};
+
+// One stored choice. 'objective' is TuningOptions::objectiveTag() of the run that
+// made it; a decision is only reused under the same objective and budget.
+struct TuningDecision {
+    std::string runtime;
+    std::string profile;
+    std::string objective;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+};
+
+struct TuningOptions {
+    bool enabled = false;   // measure when the table has no decision for the model
+    std::string table;      // decision file; empty = tuning off
+    std::string model = "model";   // log label
+    TuneObjective objective = TuneObjective::P95;
+    double budgetMs = 0.0;  // POWER: p95 budget
+    size_t warmup = 3;      // executes per candidate before measuring
+    size_t iterations = 20; // measured executes per candidate
+    std::vector<std::string> runtimes{"DSP", "GPU", "CPU"};
+    std::vector<std::string> profiles{"BURST", "HIGH_PERFORMANCE", "BALANCED", "POWER_SAVER"};
+
+    // "p95" or "power@<budget>ms"
+    std::string objectiveTag() const;
+};
+
+/**
+ * Picks a runtime and performance profile for one model by measurement: every
+ * runtime x profile candidate is built through the caller's factory, run on
+ * zeroed scratch IO for warmup + iterations executes, and ranked by the
+ * objective. Only the best session so far is kept alive, so a tuning run holds
+ * at most two built graphs. Runs are serialised process-wide: models built
+ * concurrently would otherwise measure each other.
+ */
+class RuntimeTuner {
+public:
+    // Session for a candidate, null if the runtime is not available here
+    using Factory = std::function<std::unique_ptr<ModelSession>(const TuneCandidate&)>;
+
+    struct Measurement {
+        TuneCandidate candidate;
+        bool ok = false;      // built and ran
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+    };
+
+    explicit RuntimeTuner(TuningOptions opt) : opt_(std::move(opt)) {}
+
+    // The winner's session (null if no candidate ran), its choice in 'out'
+    std::unique_ptr<ModelSession> tune(const Factory& make, TuningDecision& out);
+    const std::vector<Measurement>& measurements() const { return measured_; }
+
+    // Executes 's' on scratch buffers; false if binding or an execute fails
+    static bool measure(ModelSession& s, size_t warmup, size_t iterations,
+                        double& p50Ms, double& p95Ms);
+
+private:
+    bool better_(const Measurement& a, const Measurement& b) const;
+
+    TuningOptions opt_;
+    std::vector<Measurement> measured_;
+};
+
+/**
+ * The persisted decisions: a tab-separated text file, one line per key
+ * (key, runtime, profile, objective, p50 ms, p95 ms). Keys combine the SoC, the
+ * runtime library version and the model's content hash, so a new device, SDK
+ * or model retunes. store() rewrites the whole file through a rename and is
+ * serialised within the process.
+ */
+class TuningTable {
+public:
+    static std::string key(uint64_t modelHash, const std::string& libVersion);
+
+    static bool lookup(const std::string& path, const std::string& key, TuningDecision& out);
+    static bool store(const std::string& path, const std::string& key, const TuningDecision& d);
+};
+
+// Options for one model from the pipeline's "tuning" block; 'table' is the
+// resolved path of the decision file
+TuningOptions makeTuningOptions(const TuningCfg& cfg, const std::string& table,
+                                const std::string& model);
+
+// Table lookup, else (opt.enabled) a tuning run whose result is stored.
+// STORED: 'out' holds the table's decision. TUNED: 'out' holds the new one and
+// *session the winner's session, ready to use. NONE: nothing applies.
+enum class TuneResult { NONE, STORED, TUNED };
+TuneResult resolveTuning(const TuningOptions& opt, const std::string& key,
+                         const RuntimeTuner::Factory& make, TuningDecision& out,
+                         std::unique_ptr<ModelSession>* session);
+#endif
@@ -0,0 +1,52 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * Vectorized reductions over one score row of a channel-major detection tensor
+ * ([channels][anchors]: the scores of every anchor are contiguous, e.g.
+ * TensorView::row(scoreChannel)). NEON/SSE2 with a scalar fallback; results are
+ * identical to the scalar loops in namespace scoreref (first index wins ties,
+ * NaN never passes a threshold).
+ */
+
+struct ScoreMax {
+    int index = -1;         // -1 when the row is empty
+    float value = 0.0f;
+};
+
+// Argmax and compacted candidate list of one row, computed in a single pass so
+// every consumer of a frame can share it.
+struct ScoreScan {
+    ScoreMax best;
+    float threshold = 0.0f;
+    std::vector<int> above;  // ascending indices with score >= threshold
+};
+
+ScoreMax scoreArgmax(const float* row, size_t n);
+
+size_t scoreCountAbove(const float* row, size_t n, float threshold);
+
+// Ascending indices with score >= threshold. 'out' is cleared first; its capacity
+// is reused, so steady state does not allocate.
+size_t scoreCompactAbove(const float* row, size_t n, float threshold, std::vector<int>& out);
+
+// The k best indices (score >= minScore), best first; equal scores keep index order.
+size_t scoreTopK(const float* row, size_t n, size_t k, std::vector<int>& out,
+                 float minScore = -3.402823466e+38f);
+
+// Orders an index list by row score, best first (equal scores keep list order),
+// and keeps the first k (partial sort when k < idx.size() and idx is ascending).
+size_t scoreSortTopK(const float* row, std::vector<int>& idx, size_t k);
+
+// scoreArgmax + scoreCompactAbove in one pass over the row
+void scoreScan(const float* row, size_t n, float threshold, ScoreScan& out);
+
+// Plain loops, the reference for checks and benchmarks
+namespace scoreref {
+ScoreMax argmax(const float* row, size_t n);
+size_t countAbove(const float* row, size_t n, float threshold);
+size_t compactAbove(const float* row, size_t n, float threshold, std::vector<int>& out);
+}
+#endif
@@ -0,0 +1,80 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "inc/hpp/ModelSession.hpp"
+
+/**
+ * Memory budget for chains run with reset_session: at most maxResident sessions
+ * keep a built graph. While node k executes, the next nodes in run order (wrapping
+ * to the start of the next frame) are rebuilt on a background thread as far as the
+ * budget allows, and node k is released once it finishes, so a rebuild overlaps
+ * the previous node instead of preceding its own execute.
+ *
+ * maxResident = 1 leaves no room to prefetch (every node rebuilds inline, the old
+ * behaviour); maxResident >= the number of sessions never releases anything.
+ * Sessions already built when this is constructed count against the budget: only
+ * the first maxResident of them in run order are kept.
+ * acquire() and release() may be called from any thread; the budget only limits
+ * prefetching, so a node that is not ready is always built rather than waited on.
+ */
+class SessionResidency {
+public:
+    struct Stats {
+        uint64_t acquires = 0;
+        uint64_t prefetchHits = 0;   // ready (or became ready) from a prefetch
+        uint64_t inlineBuilds = 0;   // built by acquire() itself
+        uint64_t waitNs = 0;         // acquire() blocked on a running prefetch
+        uint64_t failed = 0;         // rebuild failed
+    };
+
+    // 'order': node index -> session, in run order. Sessions must outlive this object.
+    SessionResidency(std::vector<std::pair<size_t, ModelSession*>> order, size_t maxResident);
+    ~SessionResidency();
+
+    SessionResidency(const SessionResidency&) = delete;
+    SessionResidency& operator=(const SessionResidency&) = delete;
+
+    // Make node's session ready (waiting for or doing its rebuild), then queue the
+    // prefetch of the following nodes. False if it could not be built.
+    bool acquire(size_t node);
+    // The node finished this frame: release its graph unless everything fits
+    void release(size_t node);
+
+    size_t maxResident() const { return maxResident_; }
+    size_t resident() const;
+    Stats stats() const;
+
+private:
+    // RELEASING: release() is resetting it outside the lock, still resident
+    enum class State { RELEASED, QUEUED, BUILDING, READY, IN_USE, RELEASING };
+    struct Entry {
+        size_t node;
+        ModelSession* session;
+        State state;
+    };
+
+    size_t position_(size_t node) const;
+    size_t residentLocked_() const;
+    void prefetchAfter_(size_t pos);   // mu_ held
+    void loop_();
+
+    std::vector<Entry> entries_;        // run order
+    std::vector<size_t> posOfNode_;     // node index -> position (npos if absent)
+    size_t maxResident_;
+
+    mutable std::mutex mu_;
+    std::condition_variable cvWork_;
+    std::condition_variable cvState_;
+    std::deque<size_t> queue_;          // positions to rebuild
+    Stats stats_;
+    bool stop_ = false;
+    std::thread builder_;
+};
+#endif
@@ -0,0 +1,31 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+
+// Compile-time SIMD selection shared by the pre/post-processing kernels.
+// Exactly one of SNPE_SIMD_NEON / SNPE_SIMD_SSE2 / SNPE_SIMD_NONE is 1.
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define SNPE_SIMD_NEON 1
+  #define SNPE_SIMD_SSE2 0
+  #define SNPE_SIMD_NONE 0
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define SNPE_SIMD_NEON 0
+  #define SNPE_SIMD_SSE2 1
+  #define SNPE_SIMD_NONE 0
+#else
+  #define SNPE_SIMD_NEON 0
+  #define SNPE_SIMD_SSE2 0
+  #define SNPE_SIMD_NONE 1
+#endif
+
+inline const char* simdName() {
+#if SNPE_SIMD_NEON
+    return "neon";
+#elif SNPE_SIMD_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+#endif
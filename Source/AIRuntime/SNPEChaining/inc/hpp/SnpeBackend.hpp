@@ -0,0 +1,149 @@
+#if PLATFORM_ANDROID
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SNPE/SNPE.hpp"
+#include "SNPE/SNPEFactory.hpp"
+#include "SNPE/SNPEBuilder.hpp"
+#include "DlContainer/IDlContainer.hpp"
+#include "DlSystem/DlEnums.hpp"
+#include "DlSystem/PlatformConfig.hpp"
+#include "DlSystem/StringList.hpp"
+#include "DlSystem/IUserBuffer.hpp"
+#include "DlSystem/IOBufferDataTypeMap.hpp"
+#include "DlSystem/UserBufferMap.hpp"
+#include "DlSystem/RuntimeList.hpp"
+#include "DiagLog/IDiagLog.hpp"
+
+#include "inc/hpp/InferenceBackend.hpp"
+#include "inc/hpp/InitCache.hpp"
+#include "inc/hpp/RuntimeTuner.hpp"
+#include "inc/hpp/TensorTypes.hpp"
+
+/**
+ * IInferenceBackend over SNPE: the DLC container stays open for the backend's
+ * lifetime so the graph can be rebuilt after release(). IO is UserBuffers on
+ * caller memory: float32 unless Options::ioTypes asks for fp16 or 8/16-bit TfN,
+ * whose scale/offset are read from the DLC's buffer attributes.
+ *
+ * With initCache and an initCacheDir the container prepared by the first build
+ * is persisted (InitCacheStore); later starts validate and build from it.
+ */
+class SnpeBackend : public IInferenceBackend {
+public:
+    struct Options {
+        zdl::DlSystem::RuntimeList runtimeOrder;
+        zdl::DlSystem::PerformanceProfile_t perf =
+                zdl::DlSystem::PerformanceProfile_t::HIGH_PERFORMANCE;
+        bool useUserSuppliedBuffers = true;
+        bool initCache = false;
+        // Where initCache containers are persisted (empty = keep them in memory only).
+        // Entries are keyed by DLC hash, SNPE version, runtime and SoC; initCacheModel
+        // names the entry group (typically the DLC file name).
+        std::string initCacheDir;
+        std::string initCacheModel = "model";
+        uint64_t initCacheMaxBytes = 0;   // 0 = unlimited
+        // InitCacheStore::hashBytes of the DLC when the caller already has it (0 = Open
+        // hashes it if the init cache needs it)
+        uint64_t dlcHash = 0;
+        zdl::DlSystem::CacheCompatibility_t cacheCompatibility =
+                zdl::DlSystem::CacheCompatibility_t::CACHE_COMPATIBILITY_PERMISSIVE;
+        // SNPEBuilder::setProfilingLevel; when not OFF the DiagLog is started and
+        // writes <diagLogDir>/<diagLogName>*.dlog (per-layer detail: snpe-diagview);
+        // an empty diagLogDir profiles without writing the DiagLog
+        ProfilingLevel profiling = ProfilingLevel::OFF;
+        std::string diagLogDir = "diaglogs";
+        std::string diagLogName = "DiagLog";
+        // Buffer type per IO tensor ("*" = the rest). Quantized types need a quantized
+        // DLC; on DSP the runtime is also told (setBufferDataType) so it skips the
+        // float conversion at the graph boundary.
+        DataTypeMap ioTypes;
+        // Read by ModelSession::Create, not by the backend: with a tuning table the
+        // stored runtime/profile for this DLC and device replace runtimeOrder and
+        // perf, and tuning.enabled measures the candidates when there is none yet
+        TuningOptions tuning;
+    };
+
+    // Opens the container; the graph is built by build(). Null if the DLC is unreadable.
+    // 'dlcOwner' keeps the mapping behind 'dlc' alive.
+    static std::unique_ptr<SnpeBackend> Open(const uint8_t* dlc, size_t bytes,
+                                             std::shared_ptr<void> dlcOwner,
+                                             const Options& opt,
+                                             std::string* buildLog);
+
+    const char* runtimeName() const override { return runtimeName_.c_str(); }
+    bool build(std::string* log) override;
+    void release() override;
+    bool ready() const override { return snpe_ != nullptr; }
+
+    const std::vector<TensorInfo>& inputs() const override { return inputs_; }
+    const std::vector<TensorInfo>& outputs() const override { return outputs_; }
+
+    bool bind(const std::vector<const void*>& inputPtrs,
+              const std::vector<void*>& outputPtrs) override;
+    void unbind() override;
+    bool executeBound() override;
+    bool execute(const std::vector<const void*>& inputPtrs,
+                 const std::vector<void*>& outputPtrs) override;
+
+    // SNPE writes layer statistics to the DiagLog only, so the in-process record
+    // is the whole network ("(network)", measured around execute)
+    void setProfilingLevel(ProfilingLevel level) override;
+    bool lastLayerTimings(std::vector<LayerTiming>& out) const override;
+
+    const zdl::SNPE::SNPE* getSnpe() const { return snpe_.get(); }
+
+private:
+    SnpeBackend() = default;
+
+    struct BoundBuffer {
+        const void* ptr = nullptr;
+        std::unique_ptr<zdl::DlSystem::UserBufferEncoding> enc;
+        std::unique_ptr<zdl::DlSystem::IUserBuffer> ub;
+    };
+    bool bindOne_(const TensorInfo& t, const void* ptr, BoundBuffer& b,
+                  zdl::DlSystem::UserBufferMap& map);
+
+    // Helper to probe IO and fill inputs_/outputs_
+    void captureIO_();
+    void addBufferDataTypes_(zdl::DlSystem::IOBufferDataTypeMap& map) const;
+    void startDiagLog_();
+    zdl::SNPE::SNPEBuilder& configure_(zdl::SNPE::SNPEBuilder& b,
+                                       const zdl::DlSystem::RuntimeList& order,
+                                       const zdl::DlSystem::PlatformConfig& platformConfig,
+                                       const zdl::DlSystem::IOBufferDataTypeMap* bufferTypes) const;
+    InitCacheKey initCacheKey_() const;
+    // Build from the persisted container for 'key', if it validates; null otherwise
+    std::unique_ptr<zdl::SNPE::SNPE> buildFromInitCache_(const InitCacheKey& key,
+                                                         const zdl::DlSystem::RuntimeList& order,
+                                                         const zdl::DlSystem::PlatformConfig& platformConfig,
+                                                         const zdl::DlSystem::IOBufferDataTypeMap* bufferTypes);
+    void saveInitCache_(const InitCacheKey& key);
+    bool run_(const zdl::DlSystem::UserBufferMap& in, const zdl::DlSystem::UserBufferMap& out);
+
+    // SNPE objects
+    std::unique_ptr<zdl::SNPE::SNPE> snpe_;
+    std::string runtimeName_;
+    Options opt_;
+    uint64_t lastExecNs_ = 0;
+    std::unique_ptr<zdl::DlContainer::IDlContainer> container_;
+    std::shared_ptr<void> dlcOwner_;
+
+    // Persisted init cache: hash of the DLC as opened, and whether container_ was
+    // loaded from or already written to the store
+    uint64_t dlcHash_ = 0;
+    bool cacheLoaded_ = false;
+    bool cacheSaved_ = false;
+
+    // IO metadata (encodings resolved from Options::ioTypes and the DLC)
+    std::vector<TensorInfo> inputs_;
+    std::vector<TensorInfo> outputs_;
+
+    // Pre-bound user buffers, parallel to inputs_/outputs_
+    std::vector<BoundBuffer> boundIn_;
+    std::vector<BoundBuffer> boundOut_;
+    zdl::DlSystem::UserBufferMap inMap_, outMap_;
+};
+#endif
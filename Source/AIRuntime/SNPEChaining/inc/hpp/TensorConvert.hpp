@@ -0,0 +1,28 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "inc/hpp/TensorTypes.hpp"
+
+/**
+ * Conversions between float32 and the other TensorDataTypes, for the edges of a
+ * chain that still need floats (seeding, decoders, the CPU reference backend).
+ * Tensors passed between models keep their encoding and are never converted.
+ *
+ * Quantization follows SNPE's TfN: q = clamp(round(v / qScale) + qOffset, 0, 2^bits - 1).
+ */
+
+// IEEE binary16, round to nearest even; overflow saturates to infinity
+uint16_t floatToHalf(float f);
+float halfToFloat(uint16_t h);
+
+// TF-style parameters covering [minValue, maxValue] for a UFIXED type. The range
+// is widened to contain 0 so that 0.0 is exactly representable.
+void quantParamsForRange(float minValue, float maxValue, TensorDataType type,
+                         float& qScale, int32_t& qOffset);
+
+// 'n' elements encoded as 'info' -> float32, and back. FLOAT32 is a plain copy.
+void tensorToFloat(const void* src, const TensorInfo& info, float* dst, size_t n);
+void tensorFromFloat(const float* src, const TensorInfo& info, void* dst, size_t n);
+#endif
@@ -1,20 +1,86 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 #pragma once
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+// Element encoding of a tensor buffer. UFIXED8/16 are SNPE's TfN (unsigned,
+// asymmetric): real = (q - qOffset) * qScale, where qOffset is the quantized
+// value of 0.0 ("stepExactly0") and qScale the step size.
+enum class TensorDataType : uint8_t { FLOAT32, FLOAT16, UFIXED8, UFIXED16 };
+
+inline size_t dataTypeBytes(TensorDataType t) {
+    switch (t) {
+        case TensorDataType::FLOAT16:
+        case TensorDataType::UFIXED16: return 2;
+        case TensorDataType::UFIXED8: return 1;
+        default: return 4;
+    }
+}
+
+inline bool isQuantized(TensorDataType t) {
+    return t == TensorDataType::UFIXED8 || t == TensorDataType::UFIXED16;
+}
+
+inline const char* dataTypeName(TensorDataType t) {
+    switch (t) {
+        case TensorDataType::FLOAT16: return "fp16";
+        case TensorDataType::UFIXED8: return "uint8";
+        case TensorDataType::UFIXED16: return "uint16";
+        default: return "float32";
+    }
+}
+
+// "float32" | "fp16" | "uint8" | "uint16" (also "f32", "f16", "u8", "u16")
+inline bool parseDataType(const std::string& text, TensorDataType& out) {
+    if (text == "float32" || text == "f32") out = TensorDataType::FLOAT32;
+    else if (text == "fp16" || text == "f16") out = TensorDataType::FLOAT16;
+    else if (text == "uint8" || text == "u8") out = TensorDataType::UFIXED8;
+    else if (text == "uint16" || text == "u16") out = TensorDataType::UFIXED16;
+    else return false;
+    return true;
+}
+
+// Per-model IO type request ("io_types" in model-config.json): tensor name -> type,
+// "*" for every tensor not named. False when nothing applies (float32).
+using DataTypeMap = std::unordered_map<std::string, TensorDataType>;
+
+inline bool lookupDataType(const DataTypeMap& types, const std::string& tensor, TensorDataType& out) {
+    auto it = types.find(tensor);
+    if (it == types.end()) it = types.find("*");
+    if (it == types.end()) return false;
+    out = it->second;
+    return true;
+}
+
 struct TensorInfo {
     std::string name;
     std::vector<size_t> dims;   // NCHW style (or as exported)
-    size_t elementBytes = 4;    // float32 default
-    // Convenience: total bytes
-    size_t bytes() const {
-        size_t n = elementBytes;
+    size_t elementBytes = 4;    // float32 default; follows dataType (setDataType)
+    TensorDataType dataType = TensorDataType::FLOAT32;
+    float qScale = 1.0f;        // UFIXED only
+    int32_t qOffset = 0;        // UFIXED only
+
+    void setDataType(TensorDataType t) {
+        dataType = t;
+        elementBytes = dataTypeBytes(t);
+    }
+    size_t elements() const {
+        size_t n = 1;
         for (auto d : dims) n *= d;
         return n;
     }
+    // Convenience: total bytes
+    size_t bytes() const { return elementBytes * elements(); }
+
+    // Same bytes mean the same values: a producer and a consumer can share the
+    // buffer without converting
+    bool sameEncoding(const TensorInfo& o) const {
+        if (dataType != o.dataType) return false;
+        return !isQuantized(dataType) || (qScale == o.qScale && qOffset == o.qOffset);
+    }
 };
 
 // Simple helper to compute tightly packed strides (in bytes)
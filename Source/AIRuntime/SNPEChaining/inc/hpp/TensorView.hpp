@@ -0,0 +1,76 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "inc/hpp/TensorConvert.hpp"
+#include "inc/hpp/TensorTypes.hpp"
+#include "inc/hpp/TensorWorkspace.hpp"
+
+/**
+ * Typed, read-only view of a packed tensor living in someone else's memory
+ * (usually a TensorWorkspace block). Holds a pointer and the shape, nothing else:
+ * building one does not allocate or copy, so it is meant to be made per frame.
+ *
+ * The last two dims are exposed as rows x cols, which is how channel-major heads
+ * are read ([1, C, A] -> row(c) is channel c over all anchors).
+ * The view is only valid while the block it points to is (see
+ * TensorWorkspace::generation()).
+ */
+template <typename T>
+class TensorView {
+public:
+    static constexpr size_t kMaxRank = 8;
+
+    TensorView() = default;
+    TensorView(const T* data, const std::vector<size_t>& dims) {
+        if (!data || dims.size() > kMaxRank) return;
+        size_t n = 1;
+        for (size_t i = 0; i < dims.size(); ++i) { dims_[i] = dims[i]; n *= dims[i]; }
+        rank_ = dims.size();
+        size_ = n;
+        data_ = data;
+    }
+
+    bool valid() const { return data_ != nullptr; }
+    const T* data() const { return data_; }
+    size_t rank() const { return rank_; }
+    size_t dim(size_t i) const { return i < rank_ ? dims_[i] : 1; }
+    size_t size() const { return size_; }                  // elements
+    size_t bytes() const { return size_ * sizeof(T); }
+
+    size_t rows() const { return rank_ >= 2 ? dims_[rank_ - 2] : 1; }
+    size_t cols() const { return rank_ >= 1 ? dims_[rank_ - 1] : size_; }
+    const T* row(size_t r) const { return data_ + r * cols(); }
+
+    const T& operator[](size_t i) const { return data_[i]; }
+    const T& operator()(size_t r, size_t c) const { return data_[r * cols() + c]; }
+
+private:
+    const T* data_ = nullptr;
+    size_t dims_[kMaxRank] = {};
+    size_t rank_ = 0;
+    size_t size_ = 0;
+};
+
+// View of workspace tensor 'id' with the shape from 'info' (e.g. a ModelSession
+// output). Invalid view if the element size differs from T or the block is smaller
+// than the shape needs.
+template <typename T>
+inline TensorView<T> viewOf(const TensorWorkspace& ws, TensorWorkspace::TensorId id,
+                            const TensorInfo& info) {
+    if (info.elementBytes != sizeof(T) || ws.sizeOf(id) < info.bytes()) return TensorView<T>();
+    return TensorView<T>(static_cast<const T*>(ws.data(id)), info.dims);
+}
+
+// float32 view of any encoding: float32 tensors are viewed in place, fp16 and
+// quantized ones are converted into 'scratch' (resized once, then reused).
+inline TensorView<float> floatViewOf(const TensorWorkspace& ws, TensorWorkspace::TensorId id,
+                                     const TensorInfo& info, std::vector<float>& scratch) {
+    if (info.dataType == TensorDataType::FLOAT32) return viewOf<float>(ws, id, info);
+    if (ws.sizeOf(id) < info.bytes()) return TensorView<float>();
+    scratch.resize(info.elements());
+    tensorToFloat(ws.data(id), info, scratch.data(), scratch.size());
+    return TensorView<float>(scratch.data(), info.dims);
+}
+#endif
@@ -1,4 +1,4 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 #pragma once
 #include <cstddef>
 #include <cstdint>
@@ -7,24 +7,69 @@
 #include <vector>
 #include <memory>
 #include <functional>
-#include <android/log.h>
+#include "inc/hpp/Log.hpp"
+
+#include "inc/hpp/MemoryPlanner.hpp"
 
 #define  LOG_TAG_WS  "SNPE_WS"
-#define  LOGI_WS(...)  __android_log_print(ANDROID_LOG_INFO,LOG_TAG_WS,__VA_ARGS__)
-#define  LOGE_WS(...)  __android_log_print(ANDROID_LOG_ERROR,LOG_TAG_WS,__VA_ARGS__)
+#define  LOGI_WS(...)  SNPE_LOG(SNPE_LOG_INFO,LOG_TAG_WS,__VA_ARGS__)
+#define  LOGE_WS(...)  SNPE_LOG(SNPE_LOG_ERROR,LOG_TAG_WS,__VA_ARGS__)
 
 /**
  * A simple arena that owns all tensor memory.
  * - Blocks can be aliased by name (zero-copy edges).
  * - You can mark last-uses to recycle memory early (optional extension).
+ * - Every block starts on an 'alignment' boundary (64 B by default).
+ * - Optionally one region is reserved up front (reserveArena) and blocks are
+ *   carved from it instead of being separate heap allocations.
  */
 class TensorWorkspace {
 public:
+    // Dense handle for a tensor name, stable for the workspace lifetime. Resolve
+    // names once at graph build time; the id-based accessors below do no hashing.
+    using TensorId = uint32_t;
+    static constexpr TensorId kInvalidTensor = ~TensorId(0);
+
     struct Block {
-        std::unique_ptr<uint8_t[]> bytes;
+        std::unique_ptr<uint8_t[]> bytes;   // standalone storage (empty when carved from an arena)
+        std::shared_ptr<void> arena;        // keeps a shared arena alive
+        uint8_t* base = nullptr;            // first byte of this block (aligned)
         size_t size = 0; // total bytes
     };
 
+    enum class ArenaAdvice { NONE, WILLNEED, HUGEPAGE };
+
+    struct ArenaOptions {
+        size_t capacity = 0;        // bytes reserved up front
+        size_t alignment = 64;      // 64 for SIMD/cache lines, 4096 for DMA mapping
+        ArenaAdvice advice = ArenaAdvice::NONE;   // madvise() hint for the region
+    };
+
+    // Reserve one region and carve every later allocate() from it. Blocks that do
+    // not fit fall back to standalone aligned allocations. Call before allocating;
+    // released arena blocks are not reused (bump allocation).
+    bool reserveArena(const ArenaOptions& opt, std::string* emsg = nullptr);
+
+    size_t alignment() const { return alignment_; }
+    size_t arenaUsed() const;
+    size_t arenaCapacity() const;
+
+    // Id for 'name', creating it if needed (a new id has no block until allocate/alias).
+    TensorId intern(const std::string& name);
+
+    // Id for 'name' or kInvalidTensor if the name was never interned.
+    TensorId find(const std::string& name) const;
+
+    const std::string& nameOf(TensorId id) const;
+
+    // Hot-path accessors: pointer/size by id (null/0 if unknown or released).
+    void* data(TensorId id) const {
+        return id < entries_.size() && entries_[id].block ? entries_[id].block->base : nullptr;
+    }
+    size_t sizeOf(TensorId id) const {
+        return id < entries_.size() && entries_[id].block ? entries_[id].block->size : 0;
+    }
+
     // Allocate a fresh block with the given name and size (bytes).
     // If the name already exists and size differs => error (strict).
     void* allocate(const std::string& name, size_t bytes);
@@ -47,15 +92,42 @@ public:
 
     bool has(const std::string& name) const;
 
+    // Name of the owning block for 'name' (follows alias chains; empty if missing).
+    std::string ownerName(const std::string& name) const;
+
+    // Move every slot of 'plan' into one shared arena at the planned offsets.
+    // Existing blocks must be owners with matching sizes; pinned slots keep their
+    // contents, everything else starts zeroed. Aliases follow their owners.
+    bool applyPlan(const MemoryPlan& plan, std::string* emsg);
+
+    // Bumped whenever a name is (re)mapped or released, i.e. whenever a pointer
+    // previously returned by data() may no longer be current. Consumers that cache
+    // pointers (pre-bound user buffers) compare this to decide when to re-bind.
+    uint64_t generation() const { return generation_; }
+
 private:
+    struct Arena;
+    std::shared_ptr<Arena> makeArena_(size_t capacity, size_t alignment, ArenaAdvice advice,
+                                      std::string* emsg) const;
+
     struct Entry {
+        std::string name;
         // If owner==true, this entry owns 'block'; if alias, it references 'ownerKey'
         bool owner = false;
         std::string ownerKey;                 // if alias
         std::shared_ptr<Block> block;         // shared so multiple aliases can see lifetime
     };
 
-    // Map tensor name -> entry
-    std::unordered_map<std::string, Entry> m_;
+    // Live entry for 'name' (null if unknown or released)
+    const Entry* entry_(const std::string& name) const;
+
+    // Tensor name -> id, id -> entry
+    std::unordered_map<std::string, TensorId> ids_;
+    std::vector<Entry> entries_;
+    uint64_t generation_ = 0;
+
+    size_t alignment_ = 64;
+    ArenaAdvice advice_ = ArenaAdvice::NONE;
+    std::shared_ptr<Arena> arena_;            // reserved region (null = arena mode off)
 };
 #endif
\ No newline at end of file
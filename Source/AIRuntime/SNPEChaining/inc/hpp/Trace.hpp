@@ -0,0 +1,86 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * Scoped trace events, dumped as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+ *
+ * Every thread writes complete events ("ph":"X") into its own fixed ring buffer:
+ * no locks and no allocation after the first event of a thread, and the oldest
+ * events are overwritten when a thread records more than kTraceEventsPerThread.
+ * While tracing is stopped a scope costs one relaxed load; building with
+ * SNPE_TRACE=0 removes the macros entirely.
+ *
+ *   traceStart();
+ *   { SNPE_TRACE_SCOPE("graph", "runAll"); ... }
+ *   traceWriteChromeJson("/sdcard/trace.json");
+ */
+#ifndef SNPE_TRACE
+#define SNPE_TRACE 1
+#endif
+
+constexpr size_t kTraceEventsPerThread = 16384;
+
+extern std::atomic<bool> g_traceEnabled;
+inline bool traceEnabled() { return g_traceEnabled.load(std::memory_order_relaxed); }
+
+// Start/stop recording. Events already recorded stay until traceClear().
+void traceStart();
+void traceStop();
+// Drop every recorded event (threads keep their buffers and names)
+void traceClear();
+// Name shown for the calling thread in the trace (copied, truncated to 31 chars).
+// Cheap while tracing is off: the ring buffer is only allocated by the first event.
+void traceSetThreadName(const char* name);
+
+// Chrome trace JSON of every thread's events, oldest first. Safe while recording:
+// events overwritten during the copy are skipped.
+std::string traceChromeJson();
+bool traceWriteChromeJson(const std::string& path, std::string* emsg = nullptr);
+
+// Monotonic clock used for event timestamps
+uint64_t traceNowNs();
+// Record one complete event; 'cat' and 'argName' must be string literals, 'name' is copied
+void traceRecord(const char* cat, const char* name, uint64_t startNs, uint64_t endNs,
+                 const char* argName, int64_t arg);
+
+class TraceScope {
+public:
+    TraceScope(const char* cat, const char* name, const char* argName = nullptr, int64_t arg = 0)
+        : active_(traceEnabled()) {
+        if (!active_) return;
+        cat_ = cat;
+        name_ = name;
+        argName_ = argName;
+        arg_ = arg;
+        t0_ = traceNowNs();
+    }
+    ~TraceScope() {
+        if (active_) traceRecord(cat_, name_, t0_, traceNowNs(), argName_, arg_);
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    bool active_;
+    const char* cat_ = nullptr;
+    const char* name_ = nullptr;
+    const char* argName_ = nullptr;
+    int64_t arg_ = 0;
+    uint64_t t0_ = 0;
+};
+
+#if SNPE_TRACE
+#define SNPE_TRACE_CONCAT_(a, b) a##b
+#define SNPE_TRACE_CONCAT(a, b) SNPE_TRACE_CONCAT_(a, b)
+// 'name' must stay valid until the end of the scope
+#define SNPE_TRACE_SCOPE(cat, name) TraceScope SNPE_TRACE_CONCAT(snpeTrace_, __LINE__)(cat, name)
+#define SNPE_TRACE_SCOPE_ARG(cat, name, argName, arg) \
+    TraceScope SNPE_TRACE_CONCAT(snpeTrace_, __LINE__)(cat, name, argName, int64_t(arg))
+#else
+#define SNPE_TRACE_SCOPE(cat, name) ((void)0)
+#define SNPE_TRACE_SCOPE_ARG(cat, name, argName, arg) ((void)0)
+#endif
+#endif
@@ -0,0 +1,39 @@
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Small fixed-size thread pool. Tasks may submit further tasks; wait() returns
+ * once every task submitted so far (including those) has finished.
+ */
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void submit(std::function<void()> task);
+    void wait();
+
+    size_t size() const { return threads_.size(); }
+
+private:
+    void loop_();
+
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mu_;
+    std::condition_variable cvTask_;
+    std::condition_variable cvIdle_;
+    size_t pending_ = 0;    // queued + running
+    bool stop_ = false;
+};
+#endif
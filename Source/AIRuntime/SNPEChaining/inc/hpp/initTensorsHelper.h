@@ -1,4 +1,4 @@
-#if PLATFORM_ANDROID 
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 //
 // Created by Chiheb Boussema on 24/9/25.
 //
@@ -10,11 +10,15 @@
 #include <vector>
 #include <unistd.h>
 #include <unordered_map>
+#if PLATFORM_ANDROID
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
 
 #include "SNPE/SNPEFactory.hpp"
 #include "DlSystem/DlEnums.hpp"
+#else
+struct AAssetManager;   // host builds: "asset" init specs are not available
+#endif
 
 #include "inc/hpp/TensorWorkspace.hpp"
 #include "inc/hpp/ModelSession.hpp"
@@ -29,30 +33,15 @@
 #include <cctype>          // std::isspace
 #include <chrono>          // seeding from steady_clock
 
-static std::unordered_set<std::string> collectProducedNames(const PipelineCfg& cfg);
-
-static std::unordered_set<std::string> collectConsumedNames(const PipelineCfg& cfg);
-
-static std::vector<std::string> computeGraphRoots(const PipelineCfg& cfg);
-
-static void fillConst(void* p, size_t bytes, float value);
-
-static void fillRandom(void* p, size_t bytes, float mean, float stddev, uint32_t seed);
-
-static bool readFileToBuffer(const std::string& path, void* dst, size_t bytes);
-
-static bool readAssetToBuffer(AAssetManager* mgr, const char* asset, void* dst, size_t bytes);
-
-static bool seedOneTensor(TensorWorkspace& ws,
-                          const std::string& wsName,
-                          const InitSpec* spec,
-                          AAssetManager* mgr,
-                          std::string* emsg);
-
+// Seeds every graph root (workspace tensor no model produces) from cfg.init,
+// zero-filling those without a spec. 'mgr' may be null when no spec reads an asset.
+// With 'gr', const/random values are encoded as the consuming model reads them
+// (fp16 / quantized inputs); file and asset data are always copied as raw bytes.
 bool seedRequiredInputs(const PipelineCfg& cfg,
                                TensorWorkspace& ws,
                                AAssetManager* mgr,
-                               std::string* emsg);
+                               std::string* emsg,
+                               const GraphRunner* gr = nullptr);
 
 #endif //SNPECHAININGDEMO_INITTENSORSHELPER_H
 #endif
\ No newline at end of file
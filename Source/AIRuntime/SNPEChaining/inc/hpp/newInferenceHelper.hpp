@@ -13,6 +13,7 @@
 #include "inc/hpp/ModelSession.hpp"
 #include "inc/hpp/GraphRunner.hpp"
 #include "inc/hpp/ParseConfig.hpp"
+#include "inc/hpp/OutputDecoder.hpp"
 #include "inc/hpp/MMapFile.h"
 
 static DlSystem::RuntimeList makeRuntimeOrder(char pref);
@@ -54,13 +55,46 @@ std::string buildArbitraryChain(AAssetManager* mgr,
                                 TensorWorkspace& ws,
                                 GraphRunner& gr,
                                 const char defaultRuntimePref='D',
-                                bool reset_sessions=false);
+                                bool reset_sessions=false,
+                                bool plan_memory=false,
+                                PipelineCfg* cfg_out=nullptr);
+
+// Output decoder of a built chain: the last model in 'cfg' with a "decoder" entry
+// (default: yolo_pose on the last node). Resolves the decoded workspace tensor
+// (decoder "output", else the model's first output) into *outId / *outInfo and
+// prepares the decoder for its shape. Null with *emsg on failure.
+std::unique_ptr<IOutputDecoder> createChainDecoder(const PipelineCfg& cfg,
+                                                   GraphRunner& gr,
+                                                   const TensorWorkspace& ws,
+                                                   TensorWorkspace::TensorId* outId,
+                                                   TensorInfo* outInfo,
+                                                   std::string* emsg);
 
 std::string rebuildNodeSession(GraphRunner::Node& node);
 std::string rebuildMultipleNodes(std::vector<GraphRunner::Node>& nodes);
 std::string rebuildAllGraphNodes(GraphRunner& gr);
 
-std::string runGraph(GraphRunner& gr, bool reset_sessions=false);
+// One frame through the chain. The per-node results live in 'gr' until its next run;
+// format them with formatExecSummary() only when they are logged.
+const std::vector<GraphRunner::ExecInfo>& runGraph(GraphRunner& gr, bool reset_sessions=false);
+// "name runtime=X time=Nms OK|FAIL" per node, one line each
+std::string formatExecSummary(const std::vector<GraphRunner::ExecInfo>& infos);
+
+// Throughput of 'frames' frames run back to back with runAll() versus the pipelined
+// mode with 'in_flight' frames in the chain. Inputs are left as they are.
+std::string benchmarkPipeline(GraphRunner& gr, int frames=100, size_t in_flight=2);
+
+// ImagePreprocessor SIMD path vs its scalar reference on synthetic 640x480 and
+// 1920x1080 frames: max abs difference and throughput (also a self-check on device).
+std::string benchmarkPreprocess(int iterations=200);
+
+// PoseDecoder on a synthetic [1,56,1344] YOLO-pose tensor with several overlapping
+// people: decode (threshold + sort + NMS + gather) and NMS alone, per call.
+std::string benchmarkPoseDecoder(int iterations=1000);
+
+// ScoreReduce (argmax / count / compaction / top-K over one 1344-anchor score row)
+// against the plain loops, with a result check.
+std::string benchmarkScoreReduce(int iterations=5000);
 
 //static bool readAssetToString(AAssetManager* mgr,
 //                              const char* filename,
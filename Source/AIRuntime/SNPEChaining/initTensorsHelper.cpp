@@ -1,14 +1,19 @@
-#if PLATFORM_ANDROID
+#if PLATFORM_ANDROID || SNPE_CHAINING_HOST
 //
 // Created by Chiheb Boussema on 24/9/25.
 //
 
 #include "inc/hpp/initTensorsHelper.h"
+#include "inc/hpp/Log.hpp"
+#include "inc/hpp/TensorConvert.hpp"
+#include "inc/hpp/Trace.hpp"
+
+#include <algorithm>
 
 #define LOG_TAG "INIT_TENSOR_HELPER"
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) SNPE_LOG(SNPE_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) SNPE_LOG(SNPE_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGW(...) SNPE_LOG(SNPE_LOG_WARN,  LOG_TAG, __VA_ARGS__)
 
 static std::unordered_set<std::string>
 collectProducedNames(const PipelineCfg& cfg) {
@@ -61,7 +66,7 @@ static void fillRandom(void* p, size_t bytes, float mean, float stddev, uint32_t
     for (size_t i = 0; i < n; ++i) f[i] = dist(rng);
 }
 
-// File (absolute path) -> buffer; expects raw float32 count == bytes/4
+// File (absolute path) -> buffer; raw bytes in the tensor's encoding (float32 unless typed)
 static bool readFileToBuffer(const std::string& path, void* dst, size_t bytes) {
     std::ifstream ifs(path, std::ios::binary);
     if (!ifs) return false;
@@ -69,8 +74,9 @@ static bool readFileToBuffer(const std::string& path, void* dst, size_t bytes) {
     return static_cast<size_t>(ifs.gcount()) == bytes;
 }
 
-// Asset -> buffer; expects raw float32
+// Asset -> buffer; raw bytes in the tensor's encoding
 static bool readAssetToBuffer(AAssetManager* mgr, const char* asset, void* dst, size_t bytes) {
+#if PLATFORM_ANDROID
     if (!mgr) return false;
     AAsset* a = AAssetManager_open(mgr, asset, AASSET_MODE_UNKNOWN);
     if (!a) return false;
@@ -82,12 +88,18 @@ static bool readAssetToBuffer(AAssetManager* mgr, const char* asset, void* dst,
     int rd = AAsset_read(a, dst, bytes);
     AAsset_close(a);
     return rd == static_cast<int>(bytes);
+#else
+    (void)mgr; (void)asset; (void)dst; (void)bytes;
+    return false;
+#endif
 }
 
-// Seed one tensor according to spec (or default-zero if spec == nullptr)
+// Seed one tensor according to spec (or default-zero if spec == nullptr).
+// 'info' is its encoding when not float32 (const/random values are converted).
 static bool seedOneTensor(TensorWorkspace& ws,
                           const std::string& wsName,
                           const InitSpec* spec,
+                          const TensorInfo* info,
                           AAssetManager* mgr,
                           std::string* emsg) {
     void* ptr = ws.data(wsName);
@@ -102,6 +114,17 @@ static bool seedOneTensor(TensorWorkspace& ws,
         return true;
     }
 
+    if (info && info->dataType != TensorDataType::FLOAT32 &&
+        (spec->kind == InitKind::CONST_VALUE || spec->kind == InitKind::RANDOM)) {
+        std::vector<float> staging(std::min(info->elements(), bytes / info->elementBytes));
+        if (spec->kind == InitKind::CONST_VALUE)
+            fillConst(staging.data(), staging.size() * sizeof(float), spec->value);
+        else
+            fillRandom(staging.data(), staging.size() * sizeof(float), spec->mean, spec->std, spec->seed);
+        tensorFromFloat(staging.data(), *info, ptr, staging.size());
+        return true;
+    }
+
     switch (spec->kind) {
         case InitKind::CONST_VALUE:
             fillConst(ptr, bytes, spec->value);
@@ -130,14 +153,18 @@ static bool seedOneTensor(TensorWorkspace& ws,
 bool seedRequiredInputs(const PipelineCfg& cfg,
                                TensorWorkspace& ws,
                                AAssetManager* mgr,
-                               std::string* emsg) {
+                               std::string* emsg,
+                               const GraphRunner* gr) {
+    SNPE_TRACE_SCOPE("seed", "seedRequiredInputs");
     auto roots = computeGraphRoots(cfg);
     for (auto& wsName : roots) {
+        SNPE_TRACE_SCOPE("seed", wsName.c_str());
         const InitSpec* spec = nullptr;
         auto it = cfg.init.find(wsName);
         if (it != cfg.init.end()) spec = &it->second;
 
-        if (!seedOneTensor(ws, wsName, spec, mgr, emsg)) {
+        const TensorInfo* info = gr ? gr->tensorInfo(ws.find(wsName)) : nullptr;
+        if (!seedOneTensor(ws, wsName, spec, info, mgr, emsg)) {
             LOGE("Seeding failed for '%s'%s",
                  wsName.c_str(),
                  (emsg && !emsg->empty()) ? (": " + *emsg).c_str() : "");
@@ -12,10 +12,21 @@
 #include "inc/hpp/ModelSession.hpp"
 #include "inc/hpp/GraphRunner.hpp"
 #include "inc/hpp/TensorWorkspace.hpp"
-#include "inc/hpp/MMapAsset.hpp"
+#include "inc/hpp/DlcCache.hpp"
 #include "inc/hpp/ParseConfig.hpp"
-#include "inc/hpp/MMapFile.h"
+#include "inc/hpp/RuntimeTuner.hpp"
 #include "inc/hpp/initTensorsHelper.h"
+#include "inc/hpp/Preprocess.hpp"
+#include "inc/hpp/PoseDecoder.hpp"
+#include "inc/hpp/ScoreReduce.hpp"
+#include "inc/hpp/OutputDecoder.hpp"
+#include "inc/hpp/Simd.hpp"
+#include "inc/hpp/Trace.hpp"
+#include "inc/hpp/WorkerPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
 
 #define LOG_TAG_I "NEW_INFERENCE_HELPER"
 #define LOGE_I(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG_I, __VA_ARGS__)
@@ -82,80 +93,61 @@ static inline int64_t msSince(std::chrono::steady_clock::time_point t0) {
     return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - t0).count();
 }
 
-std::string buildModelAndGraph(AAssetManager* mgr,
-                                std::string& g_modelDir,
-//                                const std::string& configJson,
-                                const PipelineCfg& cfg,
-                                const ModelCfg& mc,
-                                const char defaultRuntimePref,
-                                TensorWorkspace& outWs,
-                                GraphRunner& outGraph,
-                                std::string& log,
-                                bool reset_session) {
-
+// One model opened and built, not yet in the graph. Filled by prepareModel(),
+// which touches nothing shared, so several can be prepared concurrently.
+struct PreparedModel {
+    std::unique_ptr<ModelSession> session;
+    std::string buildLog;
+    std::string error;          // non-empty: open or build failed
+    int64_t assetMs = 0;
+    int64_t buildMs = 0;
+};
+
+// 1) mmap the DLC (model directory first, then the APK asset), 2) build the session.
+// With reset_session the graph is released as soon as its IO is known, so startup
+// never holds more built graphs than models being prepared at once.
+static void prepareModel(AAssetManager* mgr,
+                         const std::string& modelDir,
+                         const PipelineCfg& cfg,
+                         const ModelCfg& mc,
+                         const char defaultRuntimePref,
+                         bool reset_session,
+                         PreparedModel& out) {
     using clock = std::chrono::steady_clock;
-//    std::string log;
-
-    // 0) Parse config
-//    PipelineCfg cfg;
-//    {
-//        std::string emsg;
-//        if (!ParseConfig(configJson, cfg, &emsg)) {
-//            return "Config parse failed: " + emsg;
-//        }
-//        if (cfg.models.empty()) {
-//            return "Config has no models";
-//        }
-//    }
-
-    // 1) Create workspace & graph
-//    auto ws = std::make_unique<TensorWorkspace>();
-//    auto gr = std::make_unique<GraphRunner>(*ws);
-
-    int64_t totalAssetMs = 0, totalBuildMs = 0, totalAllocMs = 0, totalGraphMs = 0;
-
-    // 2) Process each model
-//    int k = 0;
-//    for (const auto &mc: cfg.models)
-//    {
+    SNPE_TRACE_SCOPE("build", mc.name.c_str());
     LOGI("Starting build of Model %s", mc.asset.c_str());
     const auto tAsset0 = clock::now();
 
-    // mmap DLC
+    // mmap DLC through the shared cache; the mapping is owned by the session's backend
+    // (and shared with every other session of the same model)
     std::string emsg;
-    MMapAsset mappedAsset;
-    MMapFile mappedFile;
-    bool mappedOk = false;
+    std::shared_ptr<DlcCache::Mapping> dlc;
 
-    if (g_modelDir.empty() and !cfg.baseDir.empty()) {
-        g_modelDir = cfg.baseDir; // Camilo: removed  + "/"
-    }
-    if (!g_modelDir.empty()) {
-        std::string full = g_modelDir + "/" + mc.asset;
+    if (!modelDir.empty()) {
+        std::string full = modelDir + "/" + mc.asset;
         LOGI_I("Trying DLC from file: %s", full.c_str());
-        if (mappedFile.openPath(full.c_str(), &emsg)) {
-            mappedOk = true;
-        } else {
+        dlc = DlcCache::instance().mapFile(full, &emsg);
+        if (!dlc) {
             LOGW_I("File open failed: %s", emsg.c_str());
             emsg.clear();
         }
     }
 
-    if (!mappedOk) {
+    if (!dlc) {
         LOGI_I("Falling back to APK asset: %s", mc.asset.c_str());
-        if (!mappedAsset.openUncompressed(mgr, mc.asset.c_str(), &emsg)) {
-            return "Failed to mmap asset '" + mc.asset + "': " + emsg;
+        dlc = DlcCache::instance().mapAsset(mgr, mc.asset, &emsg);
+        if (!dlc) {
+            out.error = "Failed to mmap asset '" + mc.asset + "': " + emsg;
+            return;
         }
     }
+    const uint8_t* dlcPtr = dlc->data;
+    const size_t dlcSize = dlc->size;
 
-    totalAssetMs += msSince(tAsset0);
+    out.assetMs = msSince(tAsset0);
     LOGI_I("Model %s opened", mc.asset.c_str());
 
-    const void* dlcPtr  = mappedOk ? mappedFile.ptr  : mappedAsset.ptr;
-    size_t      dlcSize = mappedOk ? mappedFile.size : mappedAsset.size;
-    auto owner = std::make_shared<MMapFile>(std::move(mappedFile));
-
-    // 3) Build ModelSession
+    // Build ModelSession
     const auto tBuild0 = clock::now();
     ModelSession::Options opt;
     // Runtime order: use per-model pref if present else default
@@ -164,86 +156,140 @@ std::string buildModelAndGraph(AAssetManager* mgr,
     opt.perf = zdl::DlSystem::PerformanceProfile_t::BALANCED;
     opt.useUserSuppliedBuffers = true;
     opt.initCache = true; //false;
+    // Persist the prepared graph next to the model (not possible for APK assets
+    // without a model directory)
+    if (cfg.initCache.enabled && !modelDir.empty()) {
+        const std::string& dir = cfg.initCache.dir;
+        opt.initCacheDir = dir.empty() ? modelDir : (dir[0] == '/' ? dir : modelDir + "/" + dir);
+        opt.initCacheModel = mc.asset;
+        opt.initCacheMaxBytes = uint64_t(cfg.initCache.maxMb) << 20;
+    }
+    opt.ioTypes = mc.ioTypes;
+    // Runtime/profile decision table, kept with the init cache next to the model
+    const TuningCfg& tc = cfg.tuning;
+    if (!tc.table.empty() && (tc.table[0] == '/' || !modelDir.empty()))
+        opt.tuning = makeTuningOptions(tc, tc.table[0] == '/' ? tc.table : modelDir + "/" + tc.table, mc.name);
+    if (!mc.profiling.level.empty()) {
+        if (!parseProfilingLevel(mc.profiling.level, opt.profiling)) {
+            LOGE_I("Model %s: unknown profiling level '%s', profiling stays off",
+                   mc.name.c_str(), mc.profiling.level.c_str());
+        } else if (modelDir.empty()) {
+            // APK asset without a model directory: nowhere writable is known here (the
+            // working directory usually is not), so profile without the DiagLog file
+            LOGW_I("Model %s: no model directory, profiling without a DiagLog", mc.name.c_str());
+            opt.diagLogDir.clear();
+        } else {
+            opt.diagLogDir = modelDir + "/diaglogs";
+        }
+        opt.diagLogName = mc.name;
+    }
 
-    std::string buildLog;
-    auto session = ModelSession::Create(static_cast<const uint8_t *>(dlcPtr),
-                                        dlcSize, owner, opt, &buildLog);
-    totalBuildMs += msSince(tBuild0);
-    log += "[Build " + mc.name + "] " + buildLog;
-    LOGI_I("Session for model %s created", mc.asset.c_str());
+    out.session = ModelSession::Create(dlcPtr, dlcSize, std::move(dlc), opt, &out.buildLog);
+    out.buildMs = msSince(tBuild0);
+    LOGI_I("Session for model %s created in %lld ms", mc.asset.c_str(), (long long)out.buildMs);
 
-    if (!session) {
-        return "SNPE build failed for '" + mc.name + "'";
+    if (!out.session) {
+        out.error = "SNPE build failed for '" + mc.name + "'";
+        return;
+    }
+    if (opt.profiling != ProfilingLevel::OFF) {
+        ModelSession::ProfilingOptions popt;
+        popt.level = opt.profiling;
+        popt.frames = mc.profiling.frames;
+        popt.topN = mc.profiling.top;
+        popt.title = mc.name;
+        const std::string& report = mc.profiling.report;
+        if (!report.empty() && (report[0] == '/' || !modelDir.empty()))
+            popt.reportPath = report[0] == '/' ? report : modelDir + "/" + report;
+        else if (!report.empty())
+            LOGW_I("Model %s: no model directory for report '%s', logging it only",
+                   mc.name.c_str(), report.c_str());
+        out.session->setProfiling(popt);
     }
+    if (reset_session) {
+        LOGI_I("[BUILDING] Resetting session of %s until its first run", mc.name.c_str());
+        out.session->reset();
+    }
+}
 
-    // 4) Validate inputs/outputs exist & allocate workspace for any new names
+// 3) Validate inputs/outputs exist & allocate workspace for any new names, 4) add
+// the node. Empty on success, else the error.
+static std::string commitModel(const ModelCfg& mc,
+                               PreparedModel& pm,
+                               TensorWorkspace& outWs,
+                               GraphRunner& outGraph,
+                               int64_t& allocMs,
+                               int64_t& graphMs) {
+    using clock = std::chrono::steady_clock;
+    std::string emsg;
     const auto tAlloc0 = clock::now();
 
-    // Inputs
-    for (const auto &kv: mc.inputs)
-    {
-        const std::string &modelTensor = kv.first;
-        const std::string &wsTensor = kv.second;
-
-        const TensorInfo *ti = findTensor(session->inputs(), modelTensor);
+    // Inputs are bound from workspace too (so they can be fed by earlier models or app)
+    for (const auto &kv: mc.inputs) {
+        const TensorInfo *ti = findTensor(pm.session->inputs(), kv.first);
         if (!ti) {
-            return "Model '" + mc.name + "': input tensor not found: " + modelTensor;
+            return "Model '" + mc.name + "': input tensor not found: " + kv.first;
         }
-        // Inputs are bound from workspace too (so they can be fed by earlier models or app)
-//            if (!ensureWorkspaceBuffer(*ws, wsTensor, ti->bytes(), &emsg)) {
-//        if (!ensureWorkspaceBuffer(*outWs, wsTensor, ti->bytes(), &emsg)) {
-        if (!ensureWorkspaceBuffer(outWs, wsTensor, ti->bytes(), &emsg)) {
+        if (!ensureWorkspaceBuffer(outWs, kv.second, ti->bytes(), &emsg)) {
             return "Workspace alloc (input) failed for '" + mc.name + "': " + emsg;
         }
     }
 
-    // Outputs
     for (const auto& kv : mc.outputs) {
-        const std::string& modelTensor = kv.first;
-        const std::string& wsTensor    = kv.second;
-
-        const TensorInfo* ti = findTensor(session->outputs(), modelTensor);
+        const TensorInfo* ti = findTensor(pm.session->outputs(), kv.first);
         if (!ti) {
-            return "Model '" + mc.name + "': output tensor not found: " + modelTensor;
+            return "Model '" + mc.name + "': output tensor not found: " + kv.first;
         }
-//        if (!ensureWorkspaceBuffer(*outWs, wsTensor, ti->bytes(), &emsg)) {
-        if (!ensureWorkspaceBuffer(outWs, wsTensor, ti->bytes(), &emsg)) {
+        if (!ensureWorkspaceBuffer(outWs, kv.second, ti->bytes(), &emsg)) {
             return "Workspace alloc (output) failed for '" + mc.name + "': " + emsg;
         }
     }
 
-    totalAllocMs += msSince(tAlloc0);
+    allocMs += msSince(tAlloc0);
 
-    // 5) Add node to graph (strict zero-copy)
+    // Add node to graph (strict zero-copy)
     const auto tGraph0 = clock::now();
     GraphRunner::Node node;
     node.name     = mc.name;
-    node.session  = std::move(session);
+    node.session  = std::move(pm.session);
     node.inputBinding  = mc.inputs;   // modelTensor -> workspaceTensor
     node.outputBinding = mc.outputs;  // modelTensor -> workspaceTensor
 
     if (!outGraph.addNode(std::move(node), /*strictZeroCopy=*/true)) {
         return "addNode failed for '" + mc.name + "'";
     }
-    totalGraphMs += msSince(tGraph0);
+    graphMs += msSince(tGraph0);
     LOGI_I("Graph node for model %s added", mc.asset.c_str());
+    return {};
+}
 
-    if (reset_session) {
-//        LOGI("[BUILDING] Resetting graph!");
-        LOGI_I("[BUILDING] Resetting session of last graph node %s!", outGraph.last().name.c_str());
-//        outGraph->clear();
-        outGraph.last().session.get()->reset();
+std::string buildModelAndGraph(AAssetManager* mgr,
+                                std::string& g_modelDir,
+                                const PipelineCfg& cfg,
+                                const ModelCfg& mc,
+                                const char defaultRuntimePref,
+                                TensorWorkspace& outWs,
+                                GraphRunner& outGraph,
+                                std::string& log,
+                                bool reset_session) {
+    if (g_modelDir.empty() and !cfg.baseDir.empty()) {
+        g_modelDir = cfg.baseDir; // Camilo: removed  + "/"
     }
-//    }
 
-//    outWs   = std::move(ws);
-//    outGraph= std::move(gr);
+    PreparedModel pm;
+    prepareModel(mgr, g_modelDir, cfg, mc, defaultRuntimePref, reset_session, pm);
+    log += "[Build " + mc.name + "] " + pm.buildLog;
+    if (!pm.error.empty()) return pm.error;
+
+    int64_t allocMs = 0, graphMs = 0;
+    std::string err = commitModel(mc, pm, outWs, outGraph, allocMs, graphMs);
+    if (!err.empty()) return err;
 
     char buf[256];
     snprintf(buf, sizeof(buf),
              "Build OK. assets=%lld ms, build=%lld ms, alloc=%lld ms, graph=%lld ms",
-             (long long)totalAssetMs, (long long)totalBuildMs,
-             (long long)totalAllocMs, (long long)totalGraphMs);
+             (long long)pm.assetMs, (long long)pm.buildMs,
+             (long long)allocMs, (long long)graphMs);
     log = std::string(buf) + "\n" + log;
     return log;
 }
@@ -274,7 +320,9 @@ std::string buildArbitraryChain(AAssetManager* mgr,
                                 TensorWorkspace& ws,
                                 GraphRunner& gr,
                                 const char defaultRuntimePref='D',
-                                bool reset_sessions=false) {
+                                bool reset_sessions=false,
+                                bool plan_memory=false,
+                                PipelineCfg* cfg_out=nullptr) {
 
 //    std::unique_ptr<TensorWorkspace> g_ws; // holds workspace tensors
 //    std::unique_ptr<GraphRunner> g_gr; // holds graph runner
@@ -301,31 +349,143 @@ std::string buildArbitraryChain(AAssetManager* mgr,
         }
     }
 
-    // create models, allocate buffers and build graph
+    if (g_modelDir.empty() and !cfg.baseDir.empty()) {
+        g_modelDir = cfg.baseDir;
+    }
+
+    // Open and build the models concurrently (independent SNPE builders), then
+    // allocate buffers and add the nodes in config order
+    using clock = std::chrono::steady_clock;
+    const size_t n = cfg.models.size();
+    size_t threads = cfg.buildThreads;
+    if (threads == 0) threads = std::min<size_t>({n, 4, std::max(1u, std::thread::hardware_concurrency())});
+    threads = std::min(threads, n);
+    // reset_session: no more graphs alive during startup than the runs will allow
+    if (reset_sessions) threads = std::min(threads, gr.maxResidentSessions());
+
+    std::vector<PreparedModel> prepared(n);
+    const auto tPrep0 = clock::now();
+    if (threads <= 1) {
+        for (size_t i = 0; i < n; ++i)
+            prepareModel(mgr, g_modelDir, cfg, cfg.models[i], defaultRuntimePref, reset_sessions, prepared[i]);
+    } else {
+        WorkerPool pool(threads);
+        for (size_t i = 0; i < n; ++i) {
+            pool.submit([&, i] {
+                prepareModel(mgr, g_modelDir, cfg, cfg.models[i], defaultRuntimePref, reset_sessions, prepared[i]);
+            });
+        }
+        pool.wait();
+    }
+    const int64_t prepareWallMs = msSince(tPrep0);
+
     std::string buildingLog;
-    for (const auto &mc: cfg.models)
-    {
-        buildingLog = buildModelAndGraph(mgr,
-                            g_modelDir,
-                            cfg,
-                            mc,
-                            defaultRuntimePref,
-                            ws,
-                            gr,
-                            buildingLog,
-                            reset_sessions);
+    int64_t assetMs = 0, buildMs = 0, allocMs = 0, graphMs = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const ModelCfg& mc = cfg.models[i];
+        PreparedModel& pm = prepared[i];
+        buildingLog += "[Build " + mc.name + "] " + pm.buildLog;
+        if (!pm.error.empty()) return pm.error + "\n" + buildingLog;
+        std::string err = commitModel(mc, pm, ws, gr, allocMs, graphMs);
+        if (!err.empty()) return err + "\n" + buildingLog;
+        assetMs += pm.assetMs;
+        buildMs += pm.buildMs;
+        char line[160];
+        snprintf(line, sizeof(line), "  %s: assets=%lld ms, build=%lld ms\n", mc.name.c_str(),
+                 (long long)pm.assetMs, (long long)pm.buildMs);
+        buildingLog += line;
+    }
+
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "Build OK. %zu models on %zu threads: wall=%lld ms (assets=%lld ms, build=%lld ms summed), "
+             "alloc=%lld ms, graph=%lld ms",
+             n, std::max<size_t>(threads, 1), (long long)prepareWallMs, (long long)assetMs,
+             (long long)buildMs, (long long)allocMs, (long long)graphMs);
+    LOGI_I("%s", buf);
+    buildingLog = std::string(buf) + "\n" + buildingLog;
+    const DlcCache::Stats dc = DlcCache::instance().stats();
+    snprintf(buf, sizeof(buf), "DLC mappings: %zu live, %.1f MB mapped, %.1f MB resident (%llu shared, %llu mapped)\n",
+             dc.mappings, dc.mappedBytes / 1048576.0, DlcCache::instance().residentBytes() / 1048576.0,
+             (unsigned long long)dc.hits, (unsigned long long)dc.misses);
+    buildingLog += buf;
+
+    // Pack workspace tensors that are never live together into one arena
+    if (plan_memory) {
+        MemoryPlan plan;
+        std::string pemsg;
+        if (!gr.planMemory(plan, ws.alignment(), &pemsg) || !ws.applyPlan(plan, &pemsg)) {
+            return "Memory planning failed: " + pemsg;
+        }
+        buildingLog += "Workspace plan: peak=" + std::to_string(plan.arenaBytes) +
+                       " bytes, naive=" + std::to_string(plan.naiveBytes) + " bytes\n";
     }
 
     {
         std::string semsg;
-        if (!seedRequiredInputs(cfg, ws, mgr, &semsg)) {
+        if (!seedRequiredInputs(cfg, ws, mgr, &semsg, &gr)) {
             return "Input seeding failed: " + semsg;
         }
     }
 
+    if (cfg_out) *cfg_out = std::move(cfg);
     return buildingLog;
 }
 
+std::unique_ptr<IOutputDecoder> createChainDecoder(const PipelineCfg& cfg,
+                                                   GraphRunner& gr,
+                                                   const TensorWorkspace& ws,
+                                                   TensorWorkspace::TensorId* outId,
+                                                   TensorInfo* outInfo,
+                                                   std::string* emsg) {
+    auto& nodes = gr.getNodes();
+    if (nodes.empty()) {
+        if (emsg) *emsg = "Graph has no nodes";
+        return nullptr;
+    }
+
+    // Last model that names a decoder; otherwise the last node with the default
+    DecoderCfg dc;
+    dc.type = "yolo_pose";
+    const GraphRunner::Node* node = &nodes.back();
+    for (auto it = cfg.models.rbegin(); it != cfg.models.rend(); ++it) {
+        if (it->decoder.type.empty()) continue;
+        auto n = std::find_if(nodes.begin(), nodes.end(),
+                              [&](const GraphRunner::Node& x) { return x.name == it->name; });
+        if (n == nodes.end()) {
+            if (emsg) *emsg = "Decoder model '" + it->name + "' is not in the graph";
+            return nullptr;
+        }
+        dc = it->decoder;
+        node = &*n;
+        break;
+    }
+    if (!node->session || node->session->outputs().empty() ||
+        node->outputIds.size() != node->session->outputs().size()) {
+        if (emsg) *emsg = "Node '" + node->name + "' has no bound outputs";
+        return nullptr;
+    }
+
+    size_t k = 0;
+    if (!dc.output.empty()) {
+        while (k < node->outputIds.size() && ws.nameOf(node->outputIds[k]) != dc.output) ++k;
+        if (k == node->outputIds.size()) {
+            if (emsg) *emsg = "Decoder output '" + dc.output + "' is not an output of '" + node->name + "'";
+            return nullptr;
+        }
+    }
+
+    auto dec = OutputDecoderRegistry::instance().create(dc, emsg);
+    if (!dec) return nullptr;
+    const TensorInfo& ti = node->session->outputs()[k];
+    if (!dec->prepare(ti, emsg)) return nullptr;
+    if (outId) *outId = node->outputIds[k];
+    if (outInfo) *outInfo = ti;
+    LOGI_I("Decoder '%s' on '%s' (node %s)", dec->type(), ws.nameOf(node->outputIds[k]).c_str(),
+           node->name.c_str());
+    return dec;
+}
+
 std::string rebuildNodeSession(GraphRunner::Node& node) {
 
     std::string rebuildingLog;
@@ -354,14 +514,16 @@ std::string rebuildAllGraphNodes(GraphRunner& gr) {
     return  rebuildingLog;
 }
 
-std::string runGraph(GraphRunner& gr, bool reset_sessions) {
+const std::vector<GraphRunner::ExecInfo>& runGraph(GraphRunner& gr, bool reset_sessions) {
     auto T0 = std::chrono::steady_clock::now();
-    auto infos = gr.runAll(reset_sessions);
+    const auto& infos = gr.runAll(reset_sessions);
     auto T1 = std::chrono::steady_clock::now();
     auto execMs = std::chrono::duration_cast<std::chrono::milliseconds>(T1 - T0).count();
     LOGI_I("Graph Execution time: %lld", execMs);
+    return infos;
+}
 
-    // 7) Summarize result
+std::string formatExecSummary(const std::vector<GraphRunner::ExecInfo>& infos) {
     std::string summary;
     for (auto& e : infos) {
         summary += e.name + " runtime=" + e.runtime + " time=" + std::to_string(e.ms) + "ms "
@@ -371,6 +533,182 @@ std::string runGraph(GraphRunner& gr, bool reset_sessions) {
     return summary;
 }
 
+std::string benchmarkPipeline(GraphRunner& gr, int frames, size_t in_flight) {
+    using clock = std::chrono::steady_clock;
+    if (frames <= 0 || gr.getNodes().empty()) return "benchmarkPipeline: nothing to run\n";
+    const size_t nodes = gr.getNodes().size();
+
+    // Sequential: every frame waits for the whole chain
+    std::vector<int64_t> stageMs(nodes, 0);
+    gr.runAll(); // warm-up, binds buffers
+    auto T0 = clock::now();
+    for (int f = 0; f < frames; ++f) {
+        const auto& infos = gr.runAll();
+        for (size_t i = 0; i < infos.size(); ++i) stageMs[i] += infos[i].ms;
+    }
+    auto T1 = clock::now();
+    const double seqMs = std::chrono::duration<double, std::milli>(T1 - T0).count();
+
+    // Pipelined
+    std::string emsg;
+    if (!gr.startPipeline(in_flight, nullptr, &emsg)) {
+        return "benchmarkPipeline: " + emsg + "\n";
+    }
+    gr.submitFrame(nullptr);
+    gr.drainPipeline(); // warm-up, binds every slot once
+    auto T2 = clock::now();
+    for (int f = 0; f < frames; ++f) gr.submitFrame(nullptr);
+    gr.drainPipeline();
+    auto T3 = clock::now();
+    gr.stopPipeline();
+    const double pipeMs = std::chrono::duration<double, std::milli>(T3 - T2).count();
+
+    int64_t sumStage = 0, maxStage = 0;
+    for (auto ms : stageMs) { sumStage += ms; maxStage = std::max(maxStage, ms); }
+
+    std::string summary;
+    summary += "Pipeline benchmark: " + std::to_string(frames) + " frames, " + std::to_string(nodes)
+               + " stages, " + std::to_string(in_flight) + " in flight\n";
+    summary += "  sequential: " + std::to_string(seqMs / frames) + " ms/frame ("
+               + std::to_string(1000.0 * frames / seqMs) + " fps)\n";
+    summary += "  pipelined:  " + std::to_string(pipeMs / frames) + " ms/frame ("
+               + std::to_string(1000.0 * frames / pipeMs) + " fps)\n";
+    summary += "  stage sum=" + std::to_string(double(sumStage) / frames) + " ms  max="
+               + std::to_string(double(maxStage) / frames) + " ms\n";
+    LOGI_I("%s", summary.c_str());
+    return summary;
+}
+
+std::string benchmarkPreprocess(int iterations) {
+    using clock = std::chrono::steady_clock;
+    const int sizes[][2] = {{640, 480}, {1920, 1080}};
+    std::string summary = std::string("Preprocess benchmark (") + simdName() + ")\n";
+
+    for (const auto& wh : sizes) {
+        const int W = wh[0], H = wh[1];
+        std::vector<uint8_t> rgb(size_t(W) * H * 3);
+        uint32_t seed = 12345;
+        for (auto& v : rgb) { seed = seed * 1664525u + 1013904223u; v = uint8_t(seed >> 24); }
+
+        ImagePreprocessor pp;
+        std::vector<float> ref(pp.outputFloats()), out(pp.outputFloats());
+        pp.runScalar(rgb.data(), W, H, 0, ref.data());
+        pp.run(rgb.data(), W, H, 0, out.data());
+        float maxDiff = 0.f;
+        for (size_t i = 0; i < ref.size(); ++i) maxDiff = std::max(maxDiff, std::fabs(ref[i] - out[i]));
+
+        auto T0 = clock::now();
+        for (int i = 0; i < iterations; ++i) pp.run(rgb.data(), W, H, 0, out.data());
+        auto T1 = clock::now();
+        for (int i = 0; i < iterations; ++i) pp.runScalar(rgb.data(), W, H, 0, ref.data());
+        auto T2 = clock::now();
+
+        const double simdUs = std::chrono::duration<double, std::micro>(T1 - T0).count() / iterations;
+        const double scalarUs = std::chrono::duration<double, std::micro>(T2 - T1).count() / iterations;
+        summary += "  " + std::to_string(W) + "x" + std::to_string(H) + ": simd=" + std::to_string(simdUs)
+                   + " us  scalar=" + std::to_string(scalarUs) + " us  maxDiff=" + std::to_string(maxDiff)
+                   + (maxDiff > 1e-6f ? "  MISMATCH\n" : "\n");
+    }
+    LOGI_I("%s", summary.c_str());
+    return summary;
+}
+
+std::string benchmarkPoseDecoder(int iterations) {
+    using clock = std::chrono::steady_clock;
+    PoseDecoder dec;
+    const PoseDecoder::Params& p = dec.params();
+    const size_t A = size_t(p.numAnchors);
+    std::vector<float> out(size_t(p.numChannels) * A, 0.f);
+
+    // 6 people on a grid; each is hit by ~12 neighbouring anchors with jittered
+    // boxes and scores, plus low-score background noise on every anchor
+    const int people = 6;
+    uint32_t seed = 777;
+    auto rnd = [&seed]() { seed = seed * 1664525u + 1013904223u; return float(seed >> 8) / float(1u << 24); };
+    for (size_t a = 0; a < A; ++a) out[size_t(p.scoreChannel) * A + a] = 0.2f * rnd();
+    for (int k = 0; k < people; ++k) {
+        const float cx = 40.f + 80.f * (k % 3), cy = 64.f + 128.f * (k / 3);
+        for (int j = 0; j < 12; ++j) {
+            const size_t a = (size_t(k) * 211 + size_t(j) * 7) % A;
+            out[0 * A + a] = cx + 4.f * (rnd() - 0.5f);
+            out[1 * A + a] = cy + 4.f * (rnd() - 0.5f);
+            out[2 * A + a] = 60.f + 4.f * rnd();
+            out[3 * A + a] = 110.f + 4.f * rnd();
+            out[size_t(p.scoreChannel) * A + a] = 0.55f + 0.4f * rnd();
+        }
+    }
+
+    dec.decode(out.data(), out.size());
+    const size_t found = dec.detections().size();
+
+    auto T0 = clock::now();
+    for (int i = 0; i < iterations; ++i) dec.decode(out.data(), out.size());
+    auto T1 = clock::now();
+
+    // NMS alone on the same sorted candidate list
+    std::vector<int> sorted, keep;
+    const float* score = out.data() + size_t(p.scoreChannel) * A;
+    for (size_t a = 0; a < A; ++a) if (score[a] >= p.scoreThreshold) sorted.push_back(int(a));
+    std::stable_sort(sorted.begin(), sorted.end(), [score](int a, int b) { return score[a] > score[b]; });
+    auto T2 = clock::now();
+    for (int i = 0; i < iterations; ++i) dec.nms(out.data(), sorted, size_t(p.maxDetections), keep);
+    auto T3 = clock::now();
+
+    const double decodeUs = std::chrono::duration<double, std::micro>(T1 - T0).count() / iterations;
+    const double nmsUs = std::chrono::duration<double, std::micro>(T3 - T2).count() / iterations;
+    std::string summary = std::string("PoseDecoder benchmark (") + simdName() + "): candidates="
+                          + std::to_string(sorted.size()) + " people=" + std::to_string(found) + "/"
+                          + std::to_string(people) + " decode=" + std::to_string(decodeUs)
+                          + " us nms=" + std::to_string(nmsUs) + " us"
+                          + (found != size_t(people) ? "  MISMATCH" : "") + (decodeUs > 1000.0 ? "  SLOW" : "");
+    LOGI_I("%s", summary.c_str());
+    return summary;
+}
+
+std::string benchmarkScoreReduce(int iterations) {
+    using clock = std::chrono::steady_clock;
+    const size_t A = 1344;
+    const float threshold = 0.5f;
+    std::vector<float> row(A);
+    uint32_t seed = 4242;
+    for (auto& v : row) { seed = seed * 1664525u + 1013904223u; v = 0.3f * float(seed >> 8) / float(1u << 24); }
+    for (size_t a = 100; a < A; a += 97) row[a] = 0.5f + 0.001f * float(a % 400);   // ~13 candidates
+
+    // Results must match the reference loops exactly
+    std::vector<int> idx, ref;
+    scoreCompactAbove(row.data(), A, threshold, idx);
+    scoreref::compactAbove(row.data(), A, threshold, ref);
+    const ScoreMax best = scoreArgmax(row.data(), A);
+    const bool match = idx == ref && best.index == scoreref::argmax(row.data(), A).index &&
+                       scoreCountAbove(row.data(), A, threshold) == scoreref::countAbove(row.data(), A, threshold);
+
+    // Keep results observable so the loops are not optimized away
+    volatile size_t sink = 0;
+    auto time = [&](auto&& fn) {
+        auto T0 = clock::now();
+        for (int i = 0; i < iterations; ++i) sink = sink + fn();
+        return std::chrono::duration<double, std::nano>(clock::now() - T0).count() / iterations;
+    };
+    const double argSimd = time([&] { return size_t(scoreArgmax(row.data(), A).index); });
+    const double argRef = time([&] { return size_t(scoreref::argmax(row.data(), A).index); });
+    const double cntSimd = time([&] { return scoreCountAbove(row.data(), A, threshold); });
+    const double cntRef = time([&] { return scoreref::countAbove(row.data(), A, threshold); });
+    const double cmpSimd = time([&] { return scoreCompactAbove(row.data(), A, threshold, idx); });
+    const double cmpRef = time([&] { return scoreref::compactAbove(row.data(), A, threshold, ref); });
+    ScoreScan scan;
+    const double scanSimd = time([&] { scoreScan(row.data(), A, threshold, scan); return scan.above.size(); });
+    const double topK = time([&] { return scoreTopK(row.data(), A, 5, idx, threshold); });
+
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "ScoreReduce benchmark (%s, %zu anchors, ns/call): argmax %.0f vs %.0f, count %.0f vs %.0f, "
+             "compact %.0f vs %.0f, scan %.0f, top5 %.0f, match=%s",
+             simdName(), A, argSimd, argRef, cntSimd, cntRef, cmpSimd, cmpRef, scanSimd, topK,
+             match ? "yes" : "NO");
+    LOGI_I("%s", buf);
+    return buf;
+}
+
 //static bool readAssetToString(AAssetManager* mgr,
 //                              const char* filename,
 //                              std::string& out,